@@ -0,0 +1,28 @@
+#pragma once
+// --- ADC 連續取樣的分派 ---
+// 所有類比輸入 (電流感測、電池電壓) 共用一個 DMA 取樣序列。Ramping 任務每個 tick
+// 取出 DMA 緩衝中的樣本，依輸入累加，各模組再取走自己輸入在這段期間的平均與最大值。
+
+#include <stdint.h>
+#include "hal.h"
+
+const int ADC_SAMPLER_INPUT_MAX = 4;
+const uint32_t ADC_SAMPLE_HZ = 20000;      // 所有輸入合計的取樣率
+
+struct AdcBatch {
+    uint32_t count;     // 這段期間的樣本數 (0 = 沒有新資料)
+    int meanMv;
+    int minMv;
+    int maxMv;
+};
+
+// 在 adcSamplerStart() 之前登記輸入，回傳 handle (失敗時為 -1)
+int adcSamplerAddInput(int pin, HalAdcAtten atten);
+bool adcSamplerStart();
+bool adcSamplerRunning();
+
+// 取出 DMA 中已完成的樣本 (Ramping 任務每個 tick 呼叫，不會等待)
+void adcSamplerPoll();
+
+// 取走某個輸入自上次呼叫以來累積的結果並歸零
+AdcBatch adcSamplerTake(int handle);
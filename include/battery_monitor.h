@@ -0,0 +1,64 @@
+#pragma once
+// --- 電池電壓監控、壓降補償與剩餘電量 ---
+// 電池電壓經分壓後由 ADC 連續取樣 (與電流感測共用 adc_sampler)，每個 Ramping tick 更新：
+//  - 補償: 依慢速濾波的電壓縮放 duty，讓同一個 duty 在滿電與低電量時對應相同的有效電壓
+//  - 壓降限制: 單一 tick 內的最低電壓低於門檻時縮小啟動推力，避免推力造成的瞬間壓降使 MCU 重置
+//  - 能量積分: 累加 V × I 估計已使用的能量，開機時依靜止電壓估計初始電量
+
+#include <stdint.h>
+
+const int BATTERY_SCALE_ONE = 256;          // 縮放的 1.0 (Q8)
+
+struct BatteryConfig {
+    int nominalMv;          // 補償的參考電壓: 此電壓下 duty 不縮放
+    int maxBoost;           // 低電壓時 duty 最多放大的倍率 (Q8)
+    int sagMv;              // 壓降門檻 (需高於穩壓器與 MCU 的重置電壓)
+    int sagRecoverMv;       // 電壓回到此值以上才逐步恢復推力
+    int minKickScale;       // 壓降時推力最低縮放 (Q8)
+    int emptyMv;            // 靜止電壓: 0%
+    int fullMv;             // 靜止電壓: 100%
+    uint32_t capacityMwh;   // 電池能量容量
+};
+
+// 2S 鋰電池 (7.4V 標稱)，1000 mAh
+const BatteryConfig BATTERY_DEFAULT = { 7400, 320, 6000, 6400, 64, 6600, 8400, 7400 };
+
+// 沒有電流感測時，以 duty 估計電流: 滿 duty 時每顆馬達約消耗的電流
+const int BATTERY_ESTIMATED_FULL_DUTY_MA = 1200;
+
+struct BatteryState {
+    bool valid;             // 是否已取得第一筆電壓
+    int32_t slowMvQ4;       // 慢速濾波的電壓 (約 0.6 秒，×16)
+    int lastMinMv;          // 最近一個 tick 的最低電壓
+    int minMv;              // 開機以來的最低電壓
+    int compScale;          // 補償縮放 (Q8)
+    int kickScale;          // 壓降限制的推力縮放 (Q8)
+    uint32_t sagEvents;     // 觸發壓降限制的次數
+    bool sagging;
+    uint64_t usedNj;        // 已使用的能量 (nJ)
+    uint32_t initialMwh;    // 開機時估計的剩餘能量
+};
+
+// --- 純計算 (不存取硬體) ---
+void batteryReset(BatteryState &state);
+// 以一個 tick 的平均/最低電壓 (mV)、負載電流 (mA) 與經過時間更新狀態
+void batteryUpdate(BatteryState &state, const BatteryConfig &config, int meanMv, int minMv,
+                   int loadMa, unsigned long elapsedMs);
+// 依電壓計算補償縮放: nominal / voltage，限制在 [1/2, maxBoost]
+int batteryCompensationScale(int voltageMv, const BatteryConfig &config);
+inline int batteryVoltageMv(const BatteryState &state) {
+    return (int)(state.slowMvQ4 / 16);
+}
+uint32_t batteryUsedMwh(const BatteryState &state);
+int batteryRemainingPercent(const BatteryState &state, const BatteryConfig &config);
+
+// --- 韌體端 ---
+// 登記電池電壓輸入 (pin < 0 表示未安裝)，需在 adcSamplerStart() 之前呼叫
+void batteryMonitorInit(int pin, int dividerRatio);
+bool batteryMonitorPresent();
+// 由 Ramping 任務在 adcSamplerPoll() 之後每個 tick 呼叫
+void batteryMonitorTick(int loadMa, unsigned long elapsedMs);
+int batteryCompensation();          // 目前的 duty 補償縮放 (未安裝時為 1.0)
+int batteryKickScale();             // 目前的推力縮放 (未安裝時為 1.0)
+const BatteryState &batteryMonitorState();
+const BatteryConfig &batteryMonitorConfig();
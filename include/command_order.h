@@ -0,0 +1,12 @@
+#pragma once
+// --- 控制命令順序檢查 ---
+// 每個客戶端連線階段 (session) 帶著遞增的序號送出命令；序號不大於該 session
+// 上一次套用的命令時，表示這是延遲抵達的舊命令，應直接丟棄。
+
+#include <stdint.h>
+
+// 同時追蹤的 session 數量 (超過時取代最久未活動的 session)
+const int COMMAND_ORDER_SESSIONS = 4;
+
+// 命令是否比該 session 上一次套用的命令更新 (更新時同時記錄此序號)
+bool commandOrderAccept(uint32_t session, uint32_t seq, unsigned long nowMs);
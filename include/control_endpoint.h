@@ -0,0 +1,26 @@
+#pragma once
+// --- /control 命令的套用 ---
+// 參數解析完成後的處理 (連線監控、序號檢查、playout 緩衝或 Ramping 引擎、統計)，
+// 由韌體的 AsyncWebServer handler 與主機端的替身伺服器 (test/host) 共用。
+
+#include <stddef.h>
+#include "control_query.h"
+
+enum ControlOutcome {
+    CONTROL_APPLIED = 0,    // 已套用 (回覆 204)
+    CONTROL_STALE = 1,      // 序號比該 session 已套用的命令舊，丟棄但仍回覆 204 (客戶端無需重送)
+    CONTROL_REJECTED = 2,   // 缺少 t/s 或格式錯誤 (回覆 400)
+};
+
+// /control 回應後是否保持連線 (1 = 交接給新的請求物件，見 control_response.h)。
+// 預設 0: 與 AsyncWebServer 本身的行為一致，每個回應都帶 Connection: close 並在送達後關閉連線
+#ifndef CONTROL_KEEP_ALIVE
+#define CONTROL_KEEP_ALIVE 0
+#endif
+
+// /control 的 204 回應 (預先組好的完整標頭，回應不帶本文)
+extern const char CONTROL_ACK_HEAD[];
+extern const size_t CONTROL_ACK_HEAD_LEN;
+
+// valid 為 false 表示已知欄位的格式錯誤
+ControlOutcome controlEndpointApply(const ControlQuery &query, bool valid, unsigned long nowMs);
@@ -0,0 +1,38 @@
+#pragma once
+// --- /control 查詢參數解析 (不配置 heap) ---
+// 直接在原始位元組上解析，不建立 Arduino String。所有長度都有邊界檢查，
+// 整數超出範圍時飽和到 CONTROL_VALUE_MIN / CONTROL_VALUE_MAX。
+
+#include <stddef.h>
+#include <stdint.h>
+
+const int CONTROL_VALUE_MAX = 32767;
+const int CONTROL_VALUE_MIN = -32768;
+
+struct ControlQuery {
+    bool hasT;
+    bool hasS;
+    int t;          // T 馬達 (速度) 原始輸入
+    int s;          // S 馬達 (轉向) 原始輸入
+    bool hasSession;
+    bool hasSeq;
+    uint32_t session;   // c: 客戶端 session 識別碼 (選用)
+    uint32_t seq;       // q: 該 session 內遞增的命令序號 (選用)
+    bool hasTs;
+    uint32_t ts;        // ts: 客戶端取樣時間 (ms，選用，供 playout 緩衝使用)
+};
+
+// 解析十進位整數 (可帶 +/- 號)，出現非數字字元或長度為 0 時回傳 false
+bool parseSaturatedInt(const char *text, size_t len, int *out);
+
+// 解析無號十進位整數，超出範圍時飽和到 UINT32_MAX
+bool parseSaturatedUint32(const char *text, size_t len, uint32_t *out);
+
+// 套用單一 name=value 欄位；未知欄位忽略，已知欄位格式錯誤時回傳 false
+bool controlQueryField(ControlQuery &query, const char *name, size_t nameLen,
+                       const char *value, size_t valueLen);
+
+// 是否包含 /control 必要的 t 與 s
+inline bool controlQueryComplete(const ControlQuery &query) {
+    return query.hasT && query.hasS;
+}
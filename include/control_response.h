@@ -0,0 +1,35 @@
+#pragma once
+// --- /control 的最小回應 (204 No Content) ---
+// 預先組好的固定回應標頭，不經過 AsyncBasicResponse 的 _assembleHead()
+// (不建立 String、不配置標頭串列)，並對 socket 設定 TCP_NODELAY。
+//
+// 預設 (CONTROL_KEEP_ALIVE 0) 與 AsyncWebServer 一樣每條連線只處理一個請求，回應送達後關閉。
+//
+// CONTROL_KEEP_ALIVE 1: AsyncWebServer 沒有保持連線的功能，搖桿每秒數十個命令都要重新建立
+// TCP 連線。寫出標頭後在同一條連線上建立新的 AsyncWebServerRequest，下一個命令直接沿用這條連線；
+// 舊的請求物件仍在呼叫堆疊上，延後到之後的交接時才釋放。這依賴函式庫的內部行為，
+// 只依 me-no-dev ESPAsyncWebServer 1.2.3 的實作撰寫:
+//   - AsyncWebServerRequest 的建構子重新登記 AsyncClient 的所有 callback (onData/onAck/
+//     onDisconnect/onTimeout/onPoll/onError)，之後的事件只交給新請求
+//   - 解構子只釋放自己的標頭、參數與回應，不碰 AsyncClient
+//   - 一個 TCP 區段中若有第二個請求，舊請求解析完第一個後直接丟棄其餘位元組 (不會交給新請求)，
+//     因此客戶端必須等到回應才送出下一個命令 (網頁與 load_gen 都是如此，不使用 pipelining)
+// 其他版本 (定義了 ASYNCWEBSERVER_VERSION 的分支) 在編譯時拒絕，需重新確認以上各點。
+
+#include <ESPAsyncWebServer.h>
+#include "control_endpoint.h"
+
+#if CONTROL_KEEP_ALIVE && defined(ASYNCWEBSERVER_VERSION)
+#error "CONTROL_KEEP_ALIVE 的連線交接只依 me-no-dev ESPAsyncWebServer 1.2.3 撰寫，這個版本需重新確認"
+#endif
+
+class ControlAckResponse : public AsyncWebServerResponse {
+  public:
+    explicit ControlAckResponse(AsyncWebServer *server);
+    bool _sourceValid() const override { return true; }
+    void _respond(AsyncWebServerRequest *request) override;
+    size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time) override;
+
+  private:
+    AsyncWebServer *_server;    // 保持連線時建立新請求物件用
+};
@@ -0,0 +1,52 @@
+#pragma once
+// --- 馬達電流感測與限流 ---
+// DRV8833 的 AISEN/BISEN 感測電阻電壓由 ADC 連續取樣 (見 adc_sampler.h)，每個 Ramping tick
+// 換算成平均電流。只有在電流實際超過預算時才依比例降低 duty，因此 Ramping 步長
+// 不必再為了保護電源而保守設定。
+// 縮放由「未縮放的需求電流」(量到的電流 ÷ 量測期間套用的縮放) 計算，而不是在上一次的縮放上
+// 再乘一次，濾波的延遲不會讓縮放重複疊加而低於預算。
+// 感測電阻只在驅動期間導通，量到的是 PWM 週期的平均值，約等於電源端的電流。
+
+#include <stdint.h>
+#include "motor_control.h"
+
+const int CURRENT_SCALE_ONE = 256;          // duty 縮放的 1.0 (Q8)
+
+struct CurrentLimitConfig {
+    int budgetMa;       // 電流預算 (需求電流超過時開始限流)
+    int recoverStep;    // 需求下降後每個 tick 回復的縮放量 (Q8)
+    int minScale;       // 限流時的最低縮放 (Q8)，避免完全切斷輸出
+};
+
+// DRV8833 每通道 1.5A RMS；轉向馬達只需要短時間出力
+const CurrentLimitConfig CURRENT_LIMIT_DEFAULT_T = { 1500, 8, 32 };
+const CurrentLimitConfig CURRENT_LIMIT_DEFAULT_S = { 1000, 8, 32 };
+
+struct CurrentChannel {
+    int fastMa;             // 快速濾波的電流 (實際流過的電流)
+    int demandMa;           // 快速濾波的需求電流 (換算成縮放為 1.0 時的電流，限流依據)
+    int32_t avgMaQ4;        // 慢速濾波的電流 (約 0.6 秒，×16)
+    int peakMa;             // 開機以來的最大瞬間值
+    int scale;              // 目前的 duty 縮放 (Q8)
+    uint32_t limitedTicks;  // 處於限流中的 tick 數
+};
+
+// --- 純計算 (不存取硬體) ---
+void currentChannelReset(CurrentChannel &channel);
+// 以一個 tick 的平均與最大電流更新濾波與限流，回傳新的 duty 縮放 (Q8)
+int currentChannelUpdate(CurrentChannel &channel, const CurrentLimitConfig &config,
+                         int meanMa, int maxMa);
+inline int currentChannelAverageMa(const CurrentChannel &channel) {
+    return (int)(channel.avgMaQ4 / 16);
+}
+
+// --- 韌體端 ---
+// 登記兩顆馬達的感測輸入 (pin < 0 表示未安裝)，需在 adcSamplerStart() 之前呼叫
+void currentSenseInit(int pinT, int pinS, int resistorMohm);
+bool currentSensePresent();             // 任一輸入已安裝
+bool currentSensePresent(int input);    // 指定的輸入 (MotorChannelDesc::sense，-1 = 沒有) 已安裝
+// 由 Ramping 任務在 adcSamplerPoll() 之後每個 tick 呼叫
+void currentSenseTick();
+// 目前的 duty 縮放 (未安裝感測時為 CURRENT_SCALE_ONE)
+int currentSenseScale(MotorId motor);
+const CurrentChannel &currentSenseChannel(MotorId motor);
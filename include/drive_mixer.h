@@ -0,0 +1,41 @@
+#pragma once
+// --- 驅動混控 (Passthrough / Arcade / Tank) ---
+// 網頁搖桿固定送出 Y → t、X → s。混控位於命令輸入與 Ramping 之間，把兩軸輸入換算成
+// 每一種馬達通道要的值，滑移轉向 (skid-steer) 車架不需要修改 JavaScript。
+// 通道在通道表中指定自己讀取哪一個混控輸出 (見 MotorChannelDesc::mix)。
+//
+// 差速換算以整數計算：左右任一側超出滿刻度時兩側等比例縮小，保留左右的比例 (轉彎半徑)。
+
+#include <stddef.h>
+
+// 混控輸出 (通道表的 mix 欄位)
+enum MixChannel {
+    MIX_THROTTLE = 0,   // 前進/後退 (Ackermann 的 T 馬達)
+    MIX_STEERING = 1,   // 轉向 (Ackermann 的 S 馬達)
+    MIX_LEFT = 2,       // 左側履帶/車輪
+    MIX_RIGHT = 3,      // 右側履帶/車輪
+    MIX_CHANNEL_COUNT
+};
+
+enum MixMode {
+    MIX_PASSTHROUGH = 0,    // 不混控: t → 油門與左側，s → 轉向與右側 (原本的行為)
+    MIX_ARCADE = 1,         // 單搖桿: t 為前進、s 為轉向，換算成左右差速
+    MIX_TANK = 2,           // 雙搖桿: t 為左側、s 為右側；Ackermann 通道取平均與差值
+    MIX_MODE_COUNT
+};
+
+struct MixResult {
+    int v[MIX_CHANNEL_COUNT];   // 各輸出 (-limit..limit)
+};
+
+// 依模式混控兩軸輸入 (-limit..limit)
+void mixerApply(MixMode mode, int t, int s, int limit, MixResult &out);
+
+// 差速: left = t + s、right = t - s，超出 limit 時等比例縮小
+void mixerDifferential(int t, int s, int limit, int &left, int &right);
+
+// --- 韌體端: 目前的混控模式 (單一 32-bit 寫入，Ramping 與 Web Server 任務之間不需要鎖) ---
+bool mixerSelect(MixMode mode);
+bool mixerSelectByName(const char *name, size_t len);
+MixMode mixerMode();
+const char *mixerModeName(MixMode mode);
@@ -0,0 +1,38 @@
+#pragma once
+// --- Duty Ramping 累加器與 PWM dithering ---
+// Ramping 以 Q8 (1/256 duty) 累加，轉向排程、電壓補償、電流與溫度限制等縮放的小數部分
+// 不再被截掉。寫入 LEDC 時依該通道的硬體解析度換算，不足 1 個計數的部分以誤差累加
+// (一階 sigma-delta) 分散到連續的 tick，平均 duty 即為精確值。
+// 純計算，不存取硬體，可在主機上測試。
+
+#include <stdint.h>
+
+const int DUTY_Q8_ONE = 256;        // 1 個 duty 計數 (Q8)
+
+// 啟動推力的計時狀態
+struct KickState {
+    bool active;
+    unsigned long untilMs;
+};
+
+// 單一通道一個 tick 的 Ramping 參數 (kick/minDuty 為 duty 計數)
+struct RampParams {
+    int stepQ8;         // 每個 tick 的最大變化量 (Q8)
+    int kick;           // 由靜止啟動時的推力
+    int kickMs;         // 推力維持的時間 (0 = 不使用推力)
+    int minDuty;        // 不使用推力時的起始 duty
+};
+
+// 由目前的累加值 (Q8) 朝 target (duty 計數) 前進一步，回傳新的累加值 (Q8)
+int rampStepQ8(int currentQ8, int target, const RampParams &p, KickState &kick, unsigned long now);
+
+// 每個 PWM 輸出腳的 dithering 狀態
+struct PwmDither {
+    int error;          // 尚未輸出的小數部分 (Q8 硬體計數)
+};
+
+// 將 |duty| (Q8，以 dutyMax 為滿刻度) 換算成 0..hwMax 的硬體計數，小數部分累加後進位
+int pwmDitherStep(PwmDither &dither, int dutyQ8, int dutyMax, int hwMax);
+
+// 在 clockHz 的計數時脈下，frequency 可使用的最高解析度 (位元數，不超過 maxBits)
+int pwmResolutionBits(uint32_t clockHz, uint32_t frequency, int maxBits);
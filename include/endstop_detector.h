@@ -0,0 +1,37 @@
+#pragma once
+// --- 機械端點 (End-stop) 與堵轉偵測 ---
+// 轉向馬達打到機械端點後會在高 duty 下堵轉，浪費電力並讓驅動器發熱。
+// 偵測到堵轉後把輸出降到維持用的 holding duty，直到命令歸零或反向。
+// 有電流感測時以「繞組電流持續超過門檻」判斷；沒有時以「持續在接近上限的 duty」判斷
+// (轉向機構從中間打到端點只需要一小段時間)。純計算，不存取硬體。
+
+#include <stdint.h>
+
+enum EndstopState {
+    ENDSTOP_FREE = 0,       // 正常輸出
+    ENDSTOP_SUSPECT = 1,    // 堵轉跡象持續中，尚未確認
+    ENDSTOP_HOLDING = 2,    // 已確認，以 holding duty 維持
+};
+
+struct EndstopConfig {
+    int stallCurrentMa;             // 繞組電流超過此值視為堵轉跡象
+    unsigned long currentConfirmMs; // 電流跡象需持續的時間 (需長於啟動推力)
+    unsigned long saturationMs;     // 無電流感測時，接近上限的 duty 需持續的時間
+};
+
+const EndstopConfig ENDSTOP_DEFAULT = { 900, 60, 400 };
+
+struct EndstopDetector {
+    EndstopState state;
+    int direction;              // 目前命令的方向 (0 = 停止)
+    unsigned long evidenceMs;   // 堵轉跡象已持續的時間
+    uint32_t detections;        // 進入 HOLDING 的次數
+};
+
+void endstopReset(EndstopDetector &detector);
+
+// 每個 tick 呼叫一次，回傳實際要輸出的 duty (含方向)
+// command: 原本要輸出的 duty；saturationDuty: 視為「接近上限」的 duty；
+// holdDuty: 確認後的輸出 (0 = 停用偵測)；currentMa: 繞組電流 (< 0 表示沒有電流感測)
+int endstopUpdate(EndstopDetector &detector, const EndstopConfig &config, int command,
+                  int saturationDuty, int holdDuty, int currentMa, unsigned long elapsedMs);
@@ -4,3 +4,50 @@
 #define BIN1_PIN 10  // 馬達 S 輸入 1 (PWM)
 #define BIN2_PIN 7   // 馬達 S 輸入 2 (PWM)
 #define NSLEEP_PIN 4 // 高電位致能馬達驅動器
+
+// 每顆馬達的 PWM 頻率 (Hz)。20kHz 以上聽不到 PWM 噪音 (11-bit)；
+// 降低頻率可減少切換損失並提高解析度 (例如轉向馬達用 4kHz，14-bit)
+#ifndef MOTOR_T_PWM_FREQ
+#define MOTOR_T_PWM_FREQ 20000
+#endif
+#ifndef MOTOR_S_PWM_FREQ
+#define MOTOR_S_PWM_FREQ 20000
+#endif
+
+// --- 輪速編碼器 (選用) ---
+// 單相脈衝輸入 (霍爾或光遮斷)，-1 表示未安裝，T 馬達維持開迴路
+#ifndef ENCODER_PIN
+#define ENCODER_PIN -1
+#endif
+
+// --- 電流感測 (選用) ---
+// DRV8833 AISEN/BISEN 的感測電阻接到 ADC1 腳位 (建議 GPIO0/GPIO1)，-1 表示未安裝
+#ifndef ISENSE_A_PIN
+#define ISENSE_A_PIN -1
+#endif
+#ifndef ISENSE_B_PIN
+#define ISENSE_B_PIN -1
+#endif
+#define ISENSE_RESISTOR_MOHM 200    // 感測電阻 (mΩ)
+
+// --- 電池電壓 (選用) ---
+// 經分壓後接到 ADC1 腳位 (GPIO0/GPIO1 中未用於電流感測的一個)，-1 表示未安裝
+#ifndef VBAT_SENSE_PIN
+#define VBAT_SENSE_PIN -1
+#endif
+#define VBAT_DIVIDER_RATIO 4        // 分壓比 (電池電壓 = ADC 電壓 × 4，量測上限約 10V)
+
+// --- 第二顆 DRV8833 (選用，4WD) ---
+// 以 -DMOTOR_LAYOUT_4WD 編譯時，A 橋 (CIN1/CIN2) 驅動後軸馬達；nSLEEP 與第一顆共用 NSLEEP_PIN
+#define CIN1_PIN 5   // 後軸馬達輸入 1 (PWM)
+#define CIN2_PIN 6   // 後軸馬達輸入 2 (PWM)
+
+// --- 陀螺儀 (選用，MPU-6050，航向保持) ---
+// I2C 接到任意兩個 GPIO (建議 GPIO8/GPIO9，開機腳位在 I2C 上拉下仍為高電位)，-1 表示未安裝
+#ifndef IMU_SDA_PIN
+#define IMU_SDA_PIN -1
+#endif
+#ifndef IMU_SCL_PIN
+#define IMU_SCL_PIN -1
+#endif
+#define IMU_YAW_SIGN -1             // 晶片朝上安裝時右轉的 Z 軸讀值為負；朝下安裝時改為 1
@@ -0,0 +1,92 @@
+#pragma once
+// --- 硬體抽象層 (HAL) ---
+// 馬達控制核心只透過這些函式存取硬體 (時鐘、PWM 輸出、Log、系統狀態、儲存區)，
+// 不直接呼叫 Arduino API。韌體版本實作於 src/hal_arduino.cpp，
+// 其他平台只需提供同名函式即可重用控制核心。
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 中斷處理函式需放在 IRAM (寫入 NVS 期間 flash cache 會被關閉)
+#ifdef ARDUINO
+#include <esp_attr.h>
+#define HAL_ISR_ATTR IRAM_ATTR
+#else
+#define HAL_ISR_ATTR
+#endif
+
+// --- 時鐘 ---
+unsigned long halMillis();                  // 開機後經過的毫秒數
+unsigned long halMicros();                  // 開機後經過的微秒數
+
+// --- PWM / GPIO 輸出 ---
+void halGpioOutput(int pin, bool high);     // 設定腳位為輸出並寫入電位
+bool halPwmSetup(int channel, int pin, int freq, int resolution);   // LEDC 無法產生該頻率/解析度時回傳 false
+void halPwmWrite(int channel, int duty);
+
+// 輸入腳位 (內部上拉) 的上升緣中斷，handler 在中斷中以 halMicros() 呼叫，需標記 HAL_ISR_ATTR
+typedef void (*HalEdgeHandler)(unsigned long nowUs);
+void halEdgeInterruptAttach(int pin, HalEdgeHandler handler);
+
+// --- I2C (只能由單一任務使用) ---
+// 每次傳輸都有逾時，裝置沒有回應時回傳 false 而不會卡住呼叫端
+const size_t HAL_I2C_READ_MAX = 128;        // 單次讀取的上限 (Wire 緩衝區大小)
+bool halI2cBegin(int sda, int scl, uint32_t hz);
+bool halI2cWriteReg(uint8_t addr, uint8_t reg, uint8_t value);
+bool halI2cReadRegs(uint8_t addr, uint8_t reg, uint8_t *buf, size_t len);
+
+// --- 背景任務 (FreeRTOS) ---
+typedef void (*HalTaskFn)(void *arg);
+bool halTaskStart(const char *name, HalTaskFn fn, void *arg, uint32_t stackBytes, int priority);
+// 固定週期執行: lastWake 由 0 開始，每次等到上次醒來後 periodMs (不受任務本身的執行時間影響)
+void halTaskDelayUntil(uint32_t &lastWake, unsigned long periodMs);
+
+// --- ADC 連續取樣 (DMA) ---
+// 依序輪流取樣多個腳位，結果由 DMA 寫入驅動程式的緩衝區，由呼叫端定期取出。
+enum HalAdcAtten {
+    HAL_ADC_ATTEN_0DB = 0,      // 滿刻度約 750 mV (電流感測電阻)
+    HAL_ADC_ATTEN_11DB = 1,     // 滿刻度約 2500 mV (經分壓的電池電壓)
+};
+
+struct HalAdcInput {
+    int pin;                    // ADC1 腳位 (C3: GPIO0..4)
+    HalAdcAtten atten;
+};
+
+struct HalAdcSample {
+    uint8_t input;              // 在 halAdcStreamStart 清單中的索引
+    uint16_t raw;               // 12-bit 原始值
+};
+
+const int HAL_ADC_RAW_MAX = 4095;
+
+bool halAdcStreamStart(const HalAdcInput *inputs, int count, uint32_t sampleHz);
+// 不等待：取出目前已完成的樣本，回傳筆數
+int halAdcStreamRead(HalAdcSample *out, int max);
+int halAdcToMillivolts(int raw, HalAdcAtten atten);
+
+// --- Log 輸出 ---
+void halLog(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+// --- 系統狀態 ---
+size_t halHeapFree();                       // 目前可用 heap
+size_t halHeapMinFree();                    // 開機以來可用 heap 的最低點
+size_t halHeapMaxBlock();                   // 最大可配置的連續區塊 (反映碎片化程度)
+
+// --- 儲存區 (NVS 分區中的 key/blob) ---
+// 讀取長度必須與儲存時完全相同，否則視為不存在並回傳 false。
+bool halStoreLoad(const char *key, void *data, size_t len);
+bool halStoreSave(const char *key, const void *data, size_t len);
+
+// --- 資料分區 (partitions-4M.csv 中的原始 flash 區域，供大量循序資料使用) ---
+// 擦除與寫入期間 flash cache 關閉，整個系統 (含 Ramping) 會暫停：
+// 擦除只能在馬達停止時進行，寫入以小區塊 (數百位元組，約 1ms) 分次執行。
+struct HalFlashRegion {
+    const void *handle;         // 平台相關 (Arduino 版為 esp_partition_t)
+    size_t size;
+};
+
+bool halFlashRegionOpen(const char *label, HalFlashRegion &region);
+bool halFlashRegionErase(const HalFlashRegion &region);
+bool halFlashRegionWrite(const HalFlashRegion &region, size_t offset, const void *data, size_t len);
+bool halFlashRegionRead(const HalFlashRegion &region, size_t offset, void *data, size_t len);
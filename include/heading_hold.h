@@ -0,0 +1,36 @@
+#pragma once
+// --- 航向保持 (Heading Hold) ---
+// 轉向搖桿回中且車輛在行駛時，記住當下的航向，之後以陀螺儀的航向誤差與角速度 (PD)
+// 產生轉向修正 (與轉向搖桿同尺度，與搖桿命令一樣經過死區補償)，抵銷地面與左右輪阻力差造成的偏航。搖桿一離開中心立即放開。
+// 航向正值為右轉，正的轉向輸入為向右轉向；倒車時轉向對航向的作用相反，修正量跟著反向。
+// 純計算，不存取硬體，可在主機上搭配錄下的陀螺儀資料測試。
+
+#include <stdint.h>
+
+struct HeadingHoldConfig {
+    int minThrottle;            // T 輸出低於此 duty 時不介入 (低速時轉向幾乎不影響航向)
+    unsigned long engageMs;     // 搖桿回中且角速度穩定後，經過此時間才鎖定航向
+    int32_t settleRateMdps;     // 角速度低於此值才視為「穩定」(避免鎖在轉彎的餘勁上)
+    int kp;                     // 每 1° 誤差的修正量 (Q8)
+    int kd;                     // 每 1 °/s 角速度的修正量 (Q8，阻尼)
+    int maxTrim;                // 修正量上限 (0..255)
+};
+
+// 預設: 誤差 15° 時修正量達到上限 (約半個轉向行程)；角速度項較強，抑制轉向機構靜摩擦造成的擺動
+const HeadingHoldConfig HEADING_HOLD_DEFAULT = { 40, 150, 20000, 2048, 256, 120 };
+
+struct HeadingHoldState {
+    bool holding;               // 已鎖定航向
+    int32_t targetMdeg;         // 鎖定的航向 (m°)
+    unsigned long settledMs;    // 搖桿回中且角速度穩定的累計時間
+    int trim;                   // 最近一次的修正量 (含方向)
+    uint32_t engagements;       // 鎖定次數
+};
+
+void headingHoldReset(HeadingHoldState &state);
+
+// 每個 Ramping tick 呼叫一次，回傳轉向修正量 (0 = 不介入)
+// steeringCentered: 轉向目標為 0；throttle: 目前的 T 輸出 (含方向)；
+// headingMdeg / rateMdps: 陀螺儀的航向與角速度；elapsedMs: 與上次呼叫的間隔
+int headingHoldUpdate(HeadingHoldState &state, const HeadingHoldConfig &config, bool steeringCentered,
+                      int throttle, int32_t headingMdeg, int32_t rateMdps, unsigned long elapsedMs);
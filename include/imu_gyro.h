@@ -0,0 +1,62 @@
+#pragma once
+// --- I2C 陀螺儀 (MPU-6050，選用) ---
+// 感測器以內部時脈每秒取樣 1000 次並把 Z 軸角速度寫入自己的 FIFO；
+// 專用的低優先權任務每 10ms 以一次 burst 讀出 FIFO 中累積的樣本 (不逐一輪詢暫存器)，
+// 因此取樣間隔由感測器決定，任務的排程抖動不影響積分結果。
+// 任務只公開 32-bit 的航向與角速度，Ramping 任務讀取時不需要等待 I2C。
+
+#include <stddef.h>
+#include <stdint.h>
+
+const int GYRO_LSB_PER_DPS_X10 = 655;       // ±500 °/s 量程: 65.5 LSB/(°/s)
+const int32_t GYRO_DEG_UDEG = 1000000;      // 1° (µ°)
+
+struct GyroConfig {
+    int sampleHz;               // 感測器輸出 FIFO 的取樣率
+    int sign;                   // 1 或 -1: 讓右轉 (順時針) 為正
+    uint32_t calibrationSamples;    // 開機時估計零點偏移的連續靜止樣本數
+    int biasTrackShift;         // 靜止時追蹤零點漂移的濾波係數 (α = 1/2^shift)
+    int stillRawLimit;          // 靜止時與偏移差距超過此值 (原始值) 的樣本不列入追蹤 (例如被人拿起)
+};
+
+const GyroConfig GYRO_DEFAULT = { 1000, 1, 1000, 12, 200 };
+
+struct GyroIntegrator {
+    int64_t biasQ16;            // 零點偏移 (原始值 ×65536，追蹤時每個樣本的修正量很小)
+    int32_t biasSum;            // 開機校正期間的累加
+    uint32_t biasSamples;       // 開機校正已累計的樣本數
+    bool ready;                 // 開機校正完成
+    int32_t headingUdeg;        // 航向 (µ°，-180°..180°，右轉為正)
+    int32_t rateMdps;           // 最近一批樣本的平均角速度 (m°/s)
+};
+
+// --- 純計算 (不存取硬體，可在主機上以錄下的 FIFO 資料測試) ---
+// FIFO 內容轉成樣本 (每個樣本為 big-endian int16)；len 為奇數時忽略最後一個位元組
+int gyroFifoParse(const uint8_t *data, size_t len, int16_t *out, int max);
+
+void gyroIntegratorReset(GyroIntegrator &gyro);
+// 積分一批樣本；stationary 為 true 時 (馬達停止) 同時追蹤零點漂移
+void gyroIntegrate(GyroIntegrator &gyro, const GyroConfig &config, const int16_t *samples, int count,
+                   bool stationary);
+
+// 兩個航向的差 (a - b)，結果在 -180°..180° (m°)
+int32_t gyroHeadingDiffMdeg(int32_t aMdeg, int32_t bMdeg);
+
+// --- 韌體端 ---
+struct GyroStats {
+    uint32_t samples;           // 已積分的樣本數
+    uint32_t fifoOverflows;     // FIFO 溢位 (任務來不及讀取) 後重設的次數
+    uint32_t i2cErrors;         // I2C 傳輸失敗次數
+};
+
+// 確認感測器並設定量程與 FIFO，再啟動取樣任務 (sda/scl < 0 表示未安裝；yawSign 見 GyroConfig.sign)
+void gyroInit(int sda, int scl, int yawSign);
+// 讀出 FIFO 並更新公開的航向與角速度 (背景任務每 10ms 呼叫一次；主機端的模擬器直接呼叫)
+void gyroPoll();
+// 任務運行中且開機校正完成
+bool gyroPresent();
+// 由 Ramping 任務每個 tick 告知車輛是否靜止
+void gyroSetStationary(bool stationary);
+int32_t gyroHeadingMdeg();
+int32_t gyroYawRateMdps();
+const GyroStats &gyroStats();
@@ -0,0 +1,26 @@
+#pragma once
+// --- 搖桿輸入整形 (死區、Expo 曲線、各軸增益) ---
+// 每個 profile 的對照表都在編譯期以 constexpr 產生 (256 筆)，執行時每個樣本只需一次陣列索引。
+
+#include <stddef.h>
+#include "motor_control.h"
+
+// 可在執行期切換的預先計算 profile
+enum ShapeProfileId {
+    SHAPE_LINEAR = 0,       // 不整形 (與舊版韌體相同)
+    SHAPE_STANDARD = 1,     // 只有死區 (與網頁端 DEADZONE_PWM 相同)
+    SHAPE_SMOOTH = 2,       // 死區 + 中等 Expo，中心附近較細膩
+    SHAPE_PRECISE = 3,      // 死區 + 強 Expo，轉向增益降低
+    SHAPE_PROFILE_COUNT
+};
+
+const ShapeProfileId SHAPE_DEFAULT = SHAPE_STANDARD;
+
+// 依目前 profile 整形單軸輸入 (-255..255 → -255..255)
+int shapeInput(MotorId axis, int raw);
+
+// 切換 profile (單一 32-bit 寫入，Ramping 與 Web Server 任務之間不需要鎖)
+bool inputShapingSelect(ShapeProfileId profile);
+bool inputShapingSelectByName(const char *name, size_t len);
+ShapeProfileId inputShapingProfile();
+const char *inputShapingProfileName(ShapeProfileId profile);
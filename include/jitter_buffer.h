@@ -0,0 +1,33 @@
+#pragma once
+// --- 設定值抖動緩衝 (Jitter Buffer) 與定時播放 ---
+// 客戶端在命令中附上取樣時間 (ts)。緩衝啟用時，命令不直接套用，而是延遲
+// 固定的 playout 時間後，依原始的取樣間隔播放給 Ramping 引擎，兩筆之間做線性內插，
+// 把 Wi-Fi 傳遞抖動造成的跳動還原成平滑的搖桿動作。
+//
+// 單一寫入者 (Web Server 任務) / 單一讀取者 (loop) 的環形緩衝，不需要鎖。
+
+#include <stdint.h>
+
+const int JITTER_BUFFER_SIZE = 16;          // 緩衝筆數 (需為 2 的次方)
+const int JITTER_DELAY_MAX_MS = 200;        // playout 延遲上限
+
+struct JitterBufferStats {
+    int delayMs;            // 目前的 playout 延遲 (0 = 關閉)
+    int depth;              // 目前緩衝中的筆數
+    uint32_t underruns;     // 播放到緩衝尾端、沒有新資料可用的次數
+    uint32_t overflows;     // 緩衝已滿而丟棄的筆數
+    uint32_t late;          // 抵達時已超過播放時間的筆數
+};
+
+// 設定 playout 延遲 (0 = 關閉，命令直接套用)。由寫入端呼叫，
+// 讀取端在下一次 jitterBufferPlayout 時套用並丟棄先前緩衝的資料
+void jitterBufferSetDelay(int delayMs);
+bool jitterBufferEnabled();
+
+// 放入一筆帶時間戳的設定值 (ts 為客戶端的毫秒時鐘)，回傳是否被接受
+bool jitterBufferPush(uint32_t session, uint32_t ts, int t, int s, unsigned long nowMs);
+
+// 依目前時間計算應播放的設定值；沒有可播放的資料時回傳 false
+bool jitterBufferPlayout(unsigned long nowMs, int *t, int *s);
+
+JitterBufferStats jitterBufferStats();
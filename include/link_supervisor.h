@@ -0,0 +1,36 @@
+#pragma once
+// --- 控制連線監督 (命令遺失時的定時衰減停止) ---
+// 依控制命令的抵達時間判斷連線狀態：短暫中斷時維持最後的設定值 (grace)，
+// 超過後依設定的曲線把目標速度衰減到 0；命令恢復後立即回到正常控制。
+
+#include <stdint.h>
+
+enum LinkDecayProfile {
+    LINK_DECAY_LINEAR = 0,          // 在 decayMs 內線性降到 0
+    LINK_DECAY_EXPONENTIAL = 1,     // 每 decayMs/8 減半，decayMs 後歸零
+};
+
+struct LinkSupervisorConfig {
+    unsigned long graceMs;          // 維持最後設定值的時間
+    unsigned long decayMs;          // 從開始衰減到完全停止的時間
+    LinkDecayProfile profile;
+};
+
+const int LINK_SCALE_ONE = 256;     // 目標速度縮放的 1.0 (Q8)
+
+// 預設: 網頁每 100ms 重送一次，容許連續遺失兩次後才開始衰減
+const LinkSupervisorConfig LINK_SUPERVISOR_DEFAULT = { 300, 500, LINK_DECAY_LINEAR };
+
+// 由 Ramping 任務在 /config 公開新設定時呼叫 (link_grace_ms / link_decay_ms / link_decay)
+void linkSupervisorConfigure(const LinkSupervisorConfig &config);
+
+// 每收到一筆有效的控制命令時呼叫。moving 為命令的目標是否不為 0；
+// 只有最後的目標不為 0 時才監督命令的中斷 (停止狀態下沒有命令不算遺失)
+void linkSupervisorOnCommand(unsigned long nowMs, bool moving);
+
+// 目前的目標速度縮放 (0..LINK_SCALE_ONE)，由 Ramping 任務每個 tick 呼叫
+int linkSupervisorScale(unsigned long nowMs);
+
+bool linkSupervisorArmed();             // 最後一筆命令的目標是否不為 0 (正在監督命令中斷)
+uint32_t linkSupervisorLossCount();     // 進入衰減的次數
+bool linkSupervisorDegraded();          // 目前是否處於衰減中 (或已停止)
@@ -0,0 +1,20 @@
+#pragma once
+// --- 執行期統計 (透過 /metrics 以 JSON 提供) ---
+// 計數器由 Web Server 任務遞增、由 /metrics 讀取，單一 32-bit 寫入在 C3 上是原子的。
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Metrics {
+    volatile uint32_t rootRequests;       // "/" 頁面請求數
+    volatile uint32_t controlRequests;    // 成功套用的 /control 請求數
+    volatile uint32_t controlRejected;    // 參數錯誤的 /control 請求數
+    volatile uint32_t controlStale;       // 因序號較舊而丟棄的 /control 請求數
+    volatile uint32_t controlAckBytes;    // /control 回應寫到線上的總位元組數
+    volatile uint32_t notFound;           // 404 請求數
+};
+
+extern Metrics metrics;
+
+// 將統計 (含 heap、Ramping 時間與 playout 緩衝狀態) 格式化為 JSON，回傳寫入長度 (不含結尾 0)
+size_t metricsFormatJson(char *buf, size_t len);
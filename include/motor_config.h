@@ -0,0 +1,81 @@
+#pragma once
+// --- 執行期可調整的馬達參數 (NVS 保存、雙緩衝切換) ---
+// Ramping 參數原本是編譯期常數，每次調校都要重新燒錄。這裡把它們集中成一個
+// MotorConfig，開機時由 NVS 載入，之後可透過 /config 修改或一次切換整組 profile。
+//
+// 設定存放在兩個緩衝區中：寫入者 (Web Server 任務) 永遠寫入未使用的那一個，
+// 寫完後才遞增版本號公開；Ramping 任務每個 tick 只比較版本號，有變動時複製一份
+// 並確認複製期間版本沒有再改變，因此不需要鎖，也不會讀到寫到一半的設定。
+
+#include <stddef.h>
+#include <stdint.h>
+#include "motor_control.h"
+#include "speed_loop.h"
+#include "steering_schedule.h"
+
+const int MOTOR_CONFIG_KICK_MS_MAX = 500;       // 啟動推力維持時間上限
+const int MOTOR_CONFIG_INTERVAL_MAX_MS = 100;   // Ramping 週期上限
+const int MOTOR_CONFIG_NAME_LEN = 12;           // profile 名稱長度 (含結尾 '\0')
+const int MOTOR_CONFIG_LINK_MS_MAX = 5000;      // 連線監督 grace / 衰減時間上限
+const int MOTOR_CONFIG_SPEED_GAIN_MAX = 16 * SPEED_GAIN_ONE;    // 速度迴路增益上限 (Q8)
+
+// 單一馬達的 Ramping 參數與衰減模式
+struct MotorChannelConfig {
+    int16_t limit;      // 最高輸出 PWM
+    int16_t step;       // 每次 Ramping 的加速步長
+    int16_t kick;       // 由靜止啟動時的推力
+    int16_t kickMs;     // 推力維持的時間 (0 = 不使用推力)
+    int16_t minDuty;    // 最低有效 duty (搖桿 1..255 線性對應到 minDuty..limit)
+    uint8_t drive;      // DriveDecay
+    uint8_t stop;       // StopMode
+    int16_t holdDuty;   // 偵測到端點/堵轉後的維持 duty (0 = 不偵測)
+};
+
+// 與車體和連線有關的參數，不屬於 profile (切換 profile 時保留目前的值)
+struct MotorSystemConfig {
+    int16_t linkGraceMs;                // 命令中斷後維持最後設定值的時間
+    int16_t linkDecayMs;                // 之後衰減到 0 的時間
+    uint8_t linkDecay;                  // LinkDecayProfile
+    int16_t steeringPoints;             // 轉向權限表格的點數
+    SteeringSchedulePoint steering[STEERING_SCHEDULE_MAX_POINTS];
+    // 閉迴路速度控制 (SpeedLoopConfig，只在安裝輪速編碼器時生效)
+    int16_t speedPeriodMs;
+    int16_t speedKp;
+    int16_t speedKi;
+    int16_t speedKd;
+    int16_t speedTrim;
+    int16_t speedFull;                  // 輸出為 limit 時的輪速 (脈衝/秒)
+};
+
+struct MotorConfig {
+    uint16_t layout;                    // 結構版本，與 NVS 中的不符時改用預設值
+    int16_t rampIntervalMs;             // Ramping 週期
+    MotorChannelConfig t;               // 速度馬達 (Throttle)
+    MotorChannelConfig s;               // 轉向馬達 (Steering)
+    char profile[MOTOR_CONFIG_NAME_LEN];    // 最近一次套用的 profile 名稱
+    MotorSystemConfig system;
+};
+
+// 開機時由 NVS 載入；沒有儲存過或版本不符時使用 "default" profile
+void motorConfigLoad();
+
+// 取得目前設定的一致副本與其版本號 (任何任務都可呼叫，不會阻塞寫入者)
+void motorConfigSnapshot(MotorConfig &out, uint32_t &version);
+uint32_t motorConfigVersion();
+
+// 檢查並公開新設定；persist 為 true 時同時寫入 NVS (結果見 motor_control.h 的 MotorConfigResult)。
+// 只能由單一任務 (Web Server 任務) 呼叫。
+MotorConfigResult motorConfigPublish(const MotorConfig &config, bool persist);
+
+// 套用具名 profile (default、indoor、race)；保留目前校正過的最低有效 duty 與不屬於 profile 的欄位
+bool motorConfigSelectProfile(MotorConfig &config, const char *name, size_t len);
+
+// 修改單一欄位 (鍵名與 motorConfigFormatJson 的輸出相同，"profile" 為字串)
+bool motorConfigField(MotorConfig &config, const char *name, size_t nameLen,
+                      const char *value, size_t valueLen);
+
+// 解析扁平的 JSON 物件 (例如 {"step_t":8,"profile":"race"})，依序套用每個欄位
+bool motorConfigParseJson(MotorConfig &config, const char *json, size_t len);
+
+// 輸出目前設定的 JSON (欄位可直接修改後送回 /config)
+size_t motorConfigFormatJson(char *buf, size_t len);
@@ -0,0 +1,138 @@
+#pragma once
+// --- 馬達控制核心 (DRV8833 + Ramping) ---
+// 只依賴 hal.h，不直接呼叫 Arduino API。
+
+#include <stdint.h>
+#include "endstop_detector.h"
+#include "duty_ramp.h"
+#include "drive_mixer.h"
+#include "heading_hold.h"
+
+enum MotorId {
+    MOTOR_T = 0,    // 速度馬達 (Throttle)
+    MOTOR_S = 1,    // 轉向馬達 (Steering)
+};
+
+const int MOTOR_ROLE_COUNT = 2;
+
+// 搖桿輸入的滿刻度 (motorSetTarget 的輸入範圍為 -255 到 255)
+const int MOTOR_INPUT_MAX = 255;
+
+// --- DRV8833 衰減模式 (每顆馬達獨立設定) ---
+// 驅動時 PWM 關閉期間的電流路徑
+enum DriveDecay {
+    DECAY_FAST = 0,     // 快衰減: 一腳 PWM、另一腳 LOW，關閉期間滑行 (原本的行為)
+    DECAY_SLOW = 1,     // 慢衰減: 一腳 HIGH、另一腳輸出反相 PWM，關閉期間煞車，低速較線性
+};
+
+// 輸出為 0 時的停止方式
+enum StopMode {
+    STOP_COAST = 0,     // 滑行: IN1=IN2=LOW
+    STOP_BRAKE = 1,     // 煞車: IN1=IN2=HIGH (馬達兩端短路)
+};
+
+struct MotorDecayConfig {
+    DriveDecay drive;
+    StopMode stop;
+};
+
+// T 馬達在目標歸零時煞車以縮短停止距離；S 馬達維持滑行，讓轉向機構可以自行回正
+const MotorDecayConfig DECAY_DEFAULT_T = { DECAY_FAST, STOP_BRAKE };
+const MotorDecayConfig DECAY_DEFAULT_S = { DECAY_FAST, STOP_COAST };
+
+// --- Ramping 時間統計 (用於調校 RAMP_ACCEL_STEP / PWM_START_KICK) ---
+// 目標改變後，實際輸出追上目標所花的時間 (time-to-speed)。
+struct RampTiming {
+    int lastTarget;                 // 上次觀察到的目標值
+    unsigned long startMs;          // 目標改變的時間
+    bool settling;                  // 是否仍在追趕目標
+    unsigned long lastSettleMs;     // 最近一次到達目標的耗時
+    unsigned long maxSettleMs;      // 開機以來最長的到達耗時
+};
+
+// --- 馬達通道 ---
+// 每個通道是 DRV8833 的一個 H 橋，兩個輸入腳各佔一個 LEDC 通道 (同一個 LEDC timer，
+// 因此每個通道可以有自己的 PWM 頻率，解析度依頻率取最高值)。通道表在編譯期決定
+// (見 motor_control.cpp 的 MOTOR_CHANNELS)，Ramping 任務每個 tick 依序更新整個陣列。
+// role 決定通道使用哪一組參數 (MotorConfig 的 t 或 s)，mix 決定讀取哪一個混控輸出；
+// 同一個 role 可以有多個通道 (例如 4WD 的前後軸驅動馬達、滑移轉向的左右兩側)。
+struct MotorChannelDesc {
+    const char *name;       // 記錄與 /metrics 使用的名稱
+    MotorId role;
+    MixChannel mix;
+    int pinFwd;             // 正值 (前進/右轉) 時輸出 PWM 的腳位
+    int pinRev;             // 負值時輸出 PWM 的腳位
+    uint8_t ledcFwd;        // pinFwd 使用的 LEDC 通道
+    uint8_t ledcRev;        // pinRev 使用的 LEDC 通道
+    int8_t sense;           // 電流感測輸入 (MOTOR_T = ISENSE_A，MOTOR_S = ISENSE_B，-1 = 未接)
+    uint32_t pwmFreq;       // PWM 頻率 (Hz)
+};
+
+// 每個通道的執行期狀態 (只由 Ramping 任務寫入，target 除外)
+struct MotorChannelState {
+    volatile int target;    // 目標 duty (已做死區補償，-255 到 255)
+    volatile int current;   // Ramping 後的 duty
+    volatile int output;    // 寫入 PWM 的 duty (含閉迴路修正、電壓補償與各項限制)
+    int currentQ8;          // Ramping 累加器 (Q8，current 為其整數部分)
+    int pwmMax;             // 依 pwmFreq 選定解析度後的硬體滿刻度
+    PwmDither dither;       // 輸出 duty 小數部分的 dithering 狀態
+    KickState kick;
+    RampTiming timing;
+    EndstopDetector endstop;    // 端點/堵轉偵測 (hold duty 由 /config 的 hold_t / hold_s 設定)
+};
+
+int motorChannelCount();
+const MotorChannelDesc &motorChannelDesc(int index);
+const MotorChannelState &motorChannelState(int index);
+
+// 編碼器量到的輪速 (脈衝/秒，未安裝時為 0)
+uint32_t motorWheelSpeed();
+
+// 所有通道的輸出都為 0 (可以安全地擦除 flash)
+bool motorIdle();
+
+// 航向保持的狀態 (未安裝陀螺儀時永遠不會鎖定)
+const HeadingHoldState &motorHeadingHold();
+
+// --- 緊急停止 (E-Stop) ---
+// 由接收命令的執行環境直接寫入停止輸出，不等待下一個 Ramping tick；
+// 鎖定後所有目標速度都會被忽略，直到呼叫 motorRearm()。
+struct EstopStats {
+    unsigned long count;            // 觸發次數
+    unsigned long lastLatencyUs;    // 最近一次: 命令抵達到輸出歸零的時間
+    unsigned long maxLatencyUs;     // 開機以來最長的延遲
+    const char *lastSource;         // 最近一次觸發的來源 ("http"、"serial" ...)
+};
+
+extern EstopStats estopStats;
+
+// arrivalUs 為命令抵達時的 halMicros()，用於量測抵達到輸出的延遲
+void motorEmergencyStop(const char *source, unsigned long arrivalUs);
+void motorRearm();
+bool motorEstopLatched();
+
+// 初始化 DRV8833 (nSLEEP 致能、所有通道的 LEDC) 並確保馬達靜止
+void motorInit();
+
+// 設定新的目標速度 (原始搖桿輸入 -255..255，重播駕駛紀錄期間忽略)。輸入整形後經目前的混控模式換算成各通道的值，
+// 再線性對應到各通道 role 的 minDuty..limit
+void motorSetTarget(int rawT, int rawS);
+
+// motorConfigPublish (motor_config.h) 與校正標記的結果
+enum MotorConfigResult {
+    MOTOR_CONFIG_APPLIED = 0,       // 已公開 (需要儲存時也已寫入 NVS)
+    MOTOR_CONFIG_INVALID = 1,       // 數值超出範圍，未套用
+    MOTOR_CONFIG_NOT_SAVED = 2,     // 已公開，但 NVS 寫入失敗 (重新開機後恢復原本的設定)
+};
+
+// --- 最低有效 duty 校正程序 ---
+// Start 後該 role 所有通道的 duty 由 0 緩慢上升；輪子開始轉動時呼叫 Mark，
+// 當下的 duty 即成為該馬達的最低有效 duty 並存入 NVS。Start/Mark/Cancel 都會把目標歸零。
+// Mark 在校正未進行時回傳 false；否則回傳 true，並以 result 回報設定公開與儲存的結果
+void motorCalibrateStart(MotorId motor);
+bool motorCalibrateMark(MotorConfigResult *result);
+void motorCalibrateCancel();
+bool motorCalibrating();
+
+// 定時馬達 Ramping 任務，需在 loop() 中持續呼叫
+void motorRampTask();
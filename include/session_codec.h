@@ -0,0 +1,50 @@
+#pragma once
+// --- 駕駛紀錄的編碼格式 (錄製與重播共用) ---
+// 紀錄 Ramping 任務實際套用的各通道目標 duty，只在任一通道的目標改變時寫入一筆。
+//
+// 格式 (位元組):
+//   標頭   'R' 'S' <版本=1> <通道數 N>
+//   每筆   varint(dt) varint(zigzag(Δ目標[0])) ... varint(zigzag(Δ目標[N-1]))
+//          dt 為與上一筆的時間差 (ms，第一筆相對於開始錄製)；Δ 為與上一筆的差 (第一筆相對於 0)
+//   結尾   0xFF (flash 擦除後的值)；為了與資料區分，任何一筆的第一個位元組都不會是 0xFF
+//
+// varint 為 little-endian base-128 (每位元組 7 bits，最高位元表示後面還有)；
+// zigzag 把有號數對應到無號數 (0, -1, 1, -2 ... → 0, 1, 2, 3 ...)，小的變化只需一個位元組。
+// 純計算，不存取硬體，主機端可直接用來產生或解析紀錄檔。
+
+#include <stddef.h>
+#include <stdint.h>
+
+const uint8_t SESSION_FORMAT_VERSION = 1;
+const size_t SESSION_HEADER_LEN = 4;
+const int SESSION_MAX_CHANNELS = 4;
+const uint8_t SESSION_END = 0xFF;
+// 一筆的最大長度: dt (32-bit，5 bytes) + 每通道 duty 差 (±510，2 bytes)
+const size_t SESSION_RECORD_MAX = 5 + SESSION_MAX_CHANNELS * 2;
+
+size_t sessionWriteHeader(uint8_t *buf, int channelCount);
+// 標頭有效時回傳 true 並取出通道數
+bool sessionReadHeader(const uint8_t *buf, size_t len, int &channelCount);
+
+struct SessionEncoder {
+    int channels;
+    int last[SESSION_MAX_CHANNELS];     // 上一筆的目標
+    unsigned long stampMs;              // 上一筆的時間 (編碼後的時間軸)
+};
+
+void sessionEncoderInit(SessionEncoder &encoder, int channels, unsigned long startMs);
+// 目標與上一筆相同時回傳 false (不需要寫入)
+bool sessionChanged(const SessionEncoder &encoder, const int *targets);
+// 編碼一筆到 buf (至少 SESSION_RECORD_MAX)，回傳長度。
+// dt 的第一個位元組會是 0xFF 時少記 1ms，誤差由下一筆吸收，不會累積。
+size_t sessionEncode(SessionEncoder &encoder, unsigned long nowMs, const int *targets, uint8_t *buf);
+
+struct SessionDecoder {
+    int channels;
+    int targets[SESSION_MAX_CHANNELS];  // 目前解出的目標
+    unsigned long stampMs;              // 目前這筆相對於開始錄製的時間
+};
+
+void sessionDecoderInit(SessionDecoder &decoder, int channels);
+// 解出一筆，回傳使用的位元組數；遇到結尾、資料不足或損壞時回傳 0 且不改變 decoder
+size_t sessionDecode(SessionDecoder &decoder, const uint8_t *buf, size_t len);
@@ -0,0 +1,54 @@
+#pragma once
+// --- 駕駛紀錄的錄製與重播 (flash "rec" 分區) ---
+// 錄製: Ramping 任務每個 tick 把各通道實際套用的目標交給 sessionRecordTick()，
+// 只編碼到 RAM 環形緩衝區 (格式見 session_codec.h)；loop() 中的 sessionService()
+// 再以小區塊寫入 flash。控制 tick 從不存取 flash，緩衝區滿時該筆捨棄 (下一筆的差值
+// 仍以最後寫入的值為基準，紀錄保持一致)，並計入 overruns。
+//
+// 重播: sessionService() 預先把 flash 內容讀進同一個環形緩衝區，Ramping 任務在
+// sessionReplayTick() 中依原本的時間軸取出目標，經過與即時操作相同的 Ramping 路徑，
+// 可用來展示或在實際場地比較不同的 Ramping 參數。
+//
+// 開始錄製時會擦除整個分區 (約 1 秒，期間系統暫停)，因此只在馬達停止時接受。
+
+#include <stdint.h>
+
+enum SessionState {
+    SESSION_IDLE = 0,
+    SESSION_RECORDING = 1,
+    SESSION_REPLAYING = 2,
+};
+
+enum SessionAction {
+    SESSION_ACTION_NONE = 0,
+    SESSION_ACTION_RECORD = 1,
+    SESSION_ACTION_REPLAY = 2,
+    SESSION_ACTION_STOP = 3,
+};
+
+struct SessionStats {
+    uint32_t bytes;         // 已寫入 flash (錄製) 或已讀出 (重播) 的位元組數
+    uint32_t records;       // 已錄製或已重播的筆數
+    uint32_t overruns;      // 環形緩衝區滿而捨棄的筆數
+};
+
+// 開機時呼叫: 尋找 "rec" 分區 (不存在時錄製功能停用)
+void sessionRecorderInit();
+
+// 由 Web Server 任務要求動作，實際執行在 sessionService()；狀態不允許時回傳 false
+bool sessionRequest(SessionAction action);
+
+// 停止重播 (緊急停止時由任何執行環境呼叫)
+void sessionAbortReplay();
+
+// loop() 中呼叫: 擦除、寫入與預讀 flash。motorsIdle 為 false 時不開始錄製
+void sessionService(bool motorsIdle);
+
+// --- Ramping 任務每個 tick 呼叫 (只存取 RAM) ---
+void sessionRecordTick(unsigned long nowMs, const int *targets, int count);
+// 重播中有到期 (或結束時歸零) 的目標時寫入 targets 並回傳 true
+bool sessionReplayTick(unsigned long nowMs, int *targets, int count);
+
+SessionState sessionState();
+const char *sessionStateName(SessionState state);
+const SessionStats &sessionStats();
@@ -0,0 +1,38 @@
+#pragma once
+// --- T 馬達閉迴路速度控制 (定點 PID) ---
+// 位於 Ramping 與 PWM 輸出之間：Ramping 後的 duty 同時作為前饋與速度設定值，
+// 量到的輪速換算回同一個 duty 尺度後計算誤差，PID 只負責修正地面與電池電壓造成的差異。
+// 純計算，不存取硬體，可在主機上搭配模擬的馬達模型測試。
+
+#include <stdint.h>
+
+const int SPEED_GAIN_ONE = 256;             // 增益的 1.0 (Q8)
+
+struct SpeedLoopConfig {
+    unsigned long periodMs;     // 控制週期 (固定頻率執行)
+    int kp;                     // 比例增益 (Q8)
+    int ki;                     // 積分增益 (Q8，每個週期累加一次誤差)
+    int kd;                     // 微分增益 (Q8，作用在量測值上，設定值跳動不會造成突波)
+    int trimLimit;              // 積分項可修正的最大 duty (anti-windup)；誤差大於一半時不累加積分
+    uint32_t fullSpeed;         // 輸出為 limit 時的輪速 (脈衝/秒)，需依編碼器與齒輪比調整
+};
+
+// 預設: 50Hz；積分修正最多 ±60 duty，編碼器故障時輸出最多為前饋的 1.5 倍 (仍受 limit 限制)
+const SpeedLoopConfig SPEED_LOOP_DEFAULT = { 20, 128, 16, 0, 60, 2000 };
+
+struct SpeedLoopState {
+    int32_t integral;           // 誤差累加 (duty × 週期)
+    bool primed;                // lastMeasured 是否有效 (重設後的第一個週期不計算微分)
+    int lastMeasured;           // 上一週期的量測值 (換算後的 duty)
+    int direction;              // 目前的驅動方向 (0 = 停止)
+    int output;                 // 最近一次的輸出 duty (含方向)
+};
+
+// 歸零積分與狀態 (停止、方向反轉時自動呼叫)
+void speedLoopReset(SpeedLoopState &state);
+
+// 執行一個控制週期
+// command: Ramping 後的 duty (含方向)；measured: 量到的輪速 (脈衝/秒)；
+// minDuty/limit: 該馬達的最低有效 duty 與最高輸出。回傳要寫入的 duty (含方向)。
+int speedLoopStep(SpeedLoopState &state, const SpeedLoopConfig &config, int command,
+                  uint32_t measured, int minDuty, int limit);
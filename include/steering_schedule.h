@@ -0,0 +1,38 @@
+#pragma once
+// --- 依速度調整轉向權限 (Steering Feedforward) ---
+// 依驅動馬達目前的輸出 (T 通道中 |current| 最大者) 查表，縮放 S 馬達的目標 duty 與 Ramping 步長：
+// 高速時降低轉向權限避免甩尾，低速時加快轉向反應。表格點之間線性內插。
+
+#include <stddef.h>
+
+const int STEERING_SCALE_ONE = 256;         // 縮放的 1.0 (Q8)
+const int STEERING_SCALE_MAX = 4 * STEERING_SCALE_ONE;
+const int STEERING_SCHEDULE_MAX_POINTS = 6;
+
+struct SteeringSchedulePoint {
+    int throttle;       // T 馬達輸出 duty (0..255)，必須遞增
+    int targetScale;    // S 目標 duty 高於最低有效 duty 部分的縮放 (Q8)
+    int stepScale;      // S Ramping 步長的縮放 (Q8)
+};
+
+struct SteeringScale {
+    int target;
+    int step;
+};
+
+// 預設表格
+extern const SteeringSchedulePoint STEERING_SCHEDULE_DEFAULT[];
+extern const int STEERING_SCHEDULE_DEFAULT_COUNT;
+
+// 點數在 1..MAX_POINTS、throttle 在 0..255 且遞增、縮放在 0..STEERING_SCALE_MAX
+bool steeringScheduleValid(const SteeringSchedulePoint *points, int count);
+
+// 替換表格 (不合法時回傳 false 並保留原表格)。由 Ramping 任務在 /config 公開新設定時呼叫
+bool steeringScheduleConfigure(const SteeringSchedulePoint *points, int count);
+
+// /config 的 "steering" 欄位: "throttle:target:step" 以逗號分隔，例如 "0:256:384,80:256:256"
+bool steeringScheduleParse(const char *text, size_t len, SteeringSchedulePoint *points, int *count);
+size_t steeringScheduleFormat(const SteeringSchedulePoint *points, int count, char *buf, size_t len);
+
+// 查表取得目前 T 輸出下的縮放 (由 Ramping 任務每個 tick 呼叫)
+SteeringScale steeringScheduleLookup(int throttle);
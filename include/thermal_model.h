@@ -0,0 +1,61 @@
+#pragma once
+// --- 馬達與驅動器的集總熱模型 (預測式降額) ---
+// 每個節點 (T 馬達、S 馬達、DRV8833) 以一階模型估計溫升：
+//   穩態溫升 = 功率 × 熱阻，實際溫升以時間常數 tau 趨近穩態。
+// 功率為 I²R：有電流感測時由量測值換算，否則由 duty 估計。
+// 降額依「目前溫度」與「以目前功率持續 THERMAL_PREDICT_MS 後的預測溫度」中較高者，
+// 在到達關斷溫度前平滑地降低有效輸出上限。放寬上限需要上述較高者再低 THERMAL_RELEASE_HYSTERESIS_C
+// (遲滯)，降額邊緣的上限才不會隨著溫度的小幅變化來回跳動。全部使用定點運算，每個 Ramping tick 更新一次。
+
+#include <stdint.h>
+
+const int THERMAL_SCALE_ONE = 256;              // 降額縮放的 1.0 (Q8)
+const int THERMAL_AMBIENT_C = 25;               // 假設的環境溫度
+const unsigned long THERMAL_PREDICT_MS = 5000;  // 預測的時間範圍
+const int THERMAL_RELEASE_HYSTERESIS_C = 5;     // 放寬上限時的遲滯
+const int THERMAL_RISE_MAX_C = 1000;            // 穩態溫升的上限 (電流讀值異常時避免 Q16 溢位)
+
+struct ThermalParams {
+    int resistanceMohm;     // 發熱電阻 (馬達繞組，或驅動器 High/Low side 導通電阻合計)
+    int rthCPerW;           // 熱阻 (°C/W)
+    uint32_t tauMs;         // 熱時間常數
+    int derateStartC;       // 開始降額的溫度
+    int cutoffC;            // 輸出上限降到 0 的溫度
+};
+
+// 130 級小型有刷馬達與 DRV8833 (HTSSOP) 的估計值，需依實際硬體調整
+const ThermalParams THERMAL_MOTOR_DEFAULT = { 2000, 20, 60000, 80, 110 };
+const ThermalParams THERMAL_DRIVER_DEFAULT = { 360, 40, 5000, 120, 150 };
+
+struct ThermalNode {
+    int32_t riseQ16;        // 高於環境的溫升 (°C, Q16)
+    int32_t steadyQ16;      // 以目前功率的穩態溫升 (°C, Q16)
+    int derate;             // 輸出上限縮放 (Q8，立即收緊，溫度低於遲滯範圍才放寬)
+};
+
+// --- 純計算 (不存取硬體) ---
+void thermalNodeReset(ThermalNode &node);
+// 電流 (mA) 流經 resistanceMohm 時的發熱功率 (mW)
+int32_t thermalPowerMw(int currentMa, int resistanceMohm);
+// 以目前的發熱功率 (mW) 與經過時間更新溫升，回傳新的降額縮放 (Q8)
+int thermalNodeUpdate(ThermalNode &node, const ThermalParams &params, int32_t powerMw,
+                      unsigned long elapsedMs);
+inline int thermalNodeTempC(const ThermalNode &node) {
+    return THERMAL_AMBIENT_C + (int)(node.riseQ16 >> 16);
+}
+
+// --- 韌體端 ---
+enum ThermalNodeId {
+    THERMAL_MOTOR_T = 0,
+    THERMAL_MOTOR_S = 1,
+    THERMAL_DRIVER = 2,
+    THERMAL_NODE_COUNT = 3,
+};
+
+// 所有節點回到環境溫度 (motorInit 時呼叫)
+void thermalModelReset();
+// 由 Ramping 任務每個 tick 呼叫 (兩顆馬達的電流；驅動器的功率為兩個 H 橋的合計)
+void thermalModelTick(int currentT, int currentS, unsigned long elapsedMs);
+// 某顆馬達目前的輸出上限縮放 (馬達本身與驅動器中較嚴格者)
+int thermalDerate(int motorNode);
+const ThermalNode &thermalModelNode(ThermalNodeId id);
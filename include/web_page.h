@@ -0,0 +1,6 @@
+#pragma once
+// --- 搖桿網頁 (內嵌於韌體，由 "/" 提供) ---
+// %HOSTNAME% 與 %IPADDRESS% 在送出前替換成裝置的名稱與位址。
+// 韌體與主機端的替身伺服器 (test/host) 送出相同的內容。
+
+extern const char HTML_CONTENT[];
@@ -0,0 +1,25 @@
+#pragma once
+// --- 輪速編碼器 (GPIO 中斷計數) ---
+// ESP32-C3 沒有 PCNT，改以上升緣中斷計數。中斷中只做毛刺過濾與計數，
+// 速度由 Ramping 任務依「兩次取樣之間最後一個脈衝的時間差」計算，低速時也有足夠解析度。
+// 單相輸入沒有方向資訊，回傳的是速度大小，方向由驅動方向決定。
+
+#include <stdint.h>
+
+// 與前一個有效脈衝間隔短於此值的脈衝視為毛刺 (接點彈跳、PWM 耦合雜訊)
+const unsigned long ENCODER_GLITCH_US_DEFAULT = 100;
+
+// 超過此時間沒有脈衝即視為靜止
+const unsigned long ENCODER_STALL_US = 200000;
+
+// 掛上中斷並由 0 開始計數 (pin < 0 時停用，T 馬達維持開迴路)
+void wheelEncoderInit(int pin, unsigned long glitchUs);
+bool wheelEncoderPresent();
+
+// 中斷處理: 每個上升緣呼叫一次 (主機測試時可直接呼叫以模擬脈衝)
+void wheelEncoderEdge(unsigned long nowUs);
+
+// 目前的輪速 (脈衝/秒)，只能由單一任務 (Ramping 任務) 呼叫
+uint32_t wheelEncoderSpeed(unsigned long nowUs);
+
+uint32_t wheelEncoderGlitchCount();     // 被過濾掉的脈衝數
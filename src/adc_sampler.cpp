@@ -0,0 +1,69 @@
+// --- ADC 連續取樣的分派 ---
+#include "adc_sampler.h"
+
+struct AdcAccumulator {
+    HalAdcAtten atten;
+    uint32_t count;
+    uint32_t sumRaw;
+    int minRaw;
+    int maxRaw;
+};
+
+static HalAdcInput inputs[ADC_SAMPLER_INPUT_MAX];
+static AdcAccumulator accumulators[ADC_SAMPLER_INPUT_MAX];
+static int inputCount = 0;
+static bool running = false;
+
+int adcSamplerAddInput(int pin, HalAdcAtten atten) {
+    if (running || pin < 0 || inputCount >= ADC_SAMPLER_INPUT_MAX) return -1;
+    inputs[inputCount].pin = pin;
+    inputs[inputCount].atten = atten;
+    accumulators[inputCount] = AdcAccumulator();
+    accumulators[inputCount].atten = atten;
+    return inputCount++;
+}
+
+bool adcSamplerStart() {
+    if (inputCount == 0) return false;
+    running = halAdcStreamStart(inputs, inputCount, ADC_SAMPLE_HZ);
+    if (!running) halLog("ADC 連續取樣啟動失敗\n");
+    return running;
+}
+
+bool adcSamplerRunning() {
+    return running;
+}
+
+void adcSamplerPoll() {
+    if (!running) return;
+    HalAdcSample samples[64];
+    int n;
+    do {
+        n = halAdcStreamRead(samples, 64);
+        for (int i = 0; i < n; i++) {
+            if (samples[i].input >= inputCount) continue;
+            AdcAccumulator &acc = accumulators[samples[i].input];
+            acc.count++;
+            acc.sumRaw += samples[i].raw;
+            if (acc.count == 1 || samples[i].raw < acc.minRaw) acc.minRaw = samples[i].raw;
+            if (samples[i].raw > acc.maxRaw) acc.maxRaw = samples[i].raw;
+        }
+    } while (n == 64);
+}
+
+AdcBatch adcSamplerTake(int handle) {
+    AdcBatch batch = { 0, 0, 0, 0 };
+    if (handle < 0 || handle >= inputCount) return batch;
+    AdcAccumulator &acc = accumulators[handle];
+    if (acc.count > 0) {
+        batch.count = acc.count;
+        batch.meanMv = halAdcToMillivolts((int)(acc.sumRaw / acc.count), acc.atten);
+        batch.minMv = halAdcToMillivolts(acc.minRaw, acc.atten);
+        batch.maxMv = halAdcToMillivolts(acc.maxRaw, acc.atten);
+    }
+    acc.count = 0;
+    acc.sumRaw = 0;
+    acc.minRaw = 0;
+    acc.maxRaw = 0;
+    return batch;
+}
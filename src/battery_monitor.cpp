@@ -0,0 +1,116 @@
+// --- 電池電壓監控、壓降補償與剩餘電量 ---
+#include "adc_sampler.h"
+#include "battery_monitor.h"
+
+// 單一 tick 的積分時間上限 (避免開機或任務延遲時一次累加過多)
+static const unsigned long ENERGY_MAX_STEP_MS = 100;
+static const uint64_t NJ_PER_MWH = 3600000000ULL;
+
+void batteryReset(BatteryState &state) {
+    state.valid = false;
+    state.slowMvQ4 = 0;
+    state.lastMinMv = 0;
+    state.minMv = 0;
+    state.compScale = BATTERY_SCALE_ONE;
+    state.kickScale = BATTERY_SCALE_ONE;
+    state.sagEvents = 0;
+    state.sagging = false;
+    state.usedNj = 0;
+    state.initialMwh = 0;
+}
+
+int batteryCompensationScale(int voltageMv, const BatteryConfig &config) {
+    if (voltageMv <= 0) return BATTERY_SCALE_ONE;
+    int scale = (int)((int32_t)config.nominalMv * BATTERY_SCALE_ONE / voltageMv);
+    if (scale > config.maxBoost) scale = config.maxBoost;
+    if (scale < BATTERY_SCALE_ONE / 2) scale = BATTERY_SCALE_ONE / 2;
+    return scale;
+}
+
+void batteryUpdate(BatteryState &state, const BatteryConfig &config, int meanMv, int minMv,
+                   int loadMa, unsigned long elapsedMs) {
+    if (!state.valid) {
+        // 開機時馬達靜止，第一筆電壓視為靜止電壓，用來估計初始電量
+        state.valid = true;
+        state.slowMvQ4 = (int32_t)meanMv * 16;
+        state.minMv = minMv;
+        int span = config.fullMv - config.emptyMv;
+        int level = meanMv - config.emptyMv;
+        if (level < 0) level = 0;
+        if (level > span) level = span;
+        state.initialMwh = span > 0 ? (uint32_t)((uint64_t)config.capacityMwh * level / span) : 0;
+    } else {
+        // 補償只跟隨慢速濾波的電壓；若跟隨瞬間壓降，放大 duty 會造成更大的壓降
+        state.slowMvQ4 += ((int32_t)meanMv * 16 - state.slowMvQ4) / 64;
+    }
+    state.lastMinMv = minMv;
+    if (minMv < state.minMv) state.minMv = minMv;
+    state.compScale = batteryCompensationScale(batteryVoltageMv(state), config);
+
+    // 壓降限制: 低於門檻時立即把推力縮小 1/4，電壓恢復後慢慢回復
+    if (minMv < config.sagMv) {
+        if (!state.sagging) state.sagEvents++;
+        state.sagging = true;
+        state.kickScale = state.kickScale * 3 / 4;
+        if (state.kickScale < config.minKickScale) state.kickScale = config.minKickScale;
+    } else if (minMv >= config.sagRecoverMv) {
+        state.sagging = false;
+        state.kickScale += 4;
+        if (state.kickScale > BATTERY_SCALE_ONE) state.kickScale = BATTERY_SCALE_ONE;
+    }
+
+    // 能量積分: mV × mA × ms = nJ
+    if (elapsedMs > ENERGY_MAX_STEP_MS) elapsedMs = ENERGY_MAX_STEP_MS;
+    if (loadMa > 0) state.usedNj += (uint64_t)meanMv * (uint32_t)loadMa * elapsedMs;
+}
+
+uint32_t batteryUsedMwh(const BatteryState &state) {
+    return (uint32_t)(state.usedNj / NJ_PER_MWH);
+}
+
+int batteryRemainingPercent(const BatteryState &state, const BatteryConfig &config) {
+    if (!state.valid || config.capacityMwh == 0) return 0;
+    uint32_t used = batteryUsedMwh(state);
+    uint32_t remaining = used < state.initialMwh ? state.initialMwh - used : 0;
+    return (int)((uint64_t)remaining * 100 / config.capacityMwh);
+}
+
+// --- 韌體端狀態 ---
+static int inputHandle = -1;
+static int divider = 1;
+static BatteryConfig batteryConfig = BATTERY_DEFAULT;
+static BatteryState battery = { false, 0, 0, 0, BATTERY_SCALE_ONE, BATTERY_SCALE_ONE, 0, false, 0, 0 };
+
+void batteryMonitorInit(int pin, int dividerRatio) {
+    if (dividerRatio < 1) return;
+    divider = dividerRatio;
+    inputHandle = adcSamplerAddInput(pin, HAL_ADC_ATTEN_11DB);
+    if (inputHandle >= 0) halLog("電池電壓監控已啟用 (GPIO%d，分壓 1/%d)\n", pin, dividerRatio);
+}
+
+bool batteryMonitorPresent() {
+    return inputHandle >= 0;
+}
+
+void batteryMonitorTick(int loadMa, unsigned long elapsedMs) {
+    if (inputHandle < 0) return;
+    AdcBatch batch = adcSamplerTake(inputHandle);
+    if (batch.count == 0) return;
+    batteryUpdate(battery, batteryConfig, batch.meanMv * divider, batch.minMv * divider, loadMa, elapsedMs);
+}
+
+int batteryCompensation() {
+    return battery.valid ? battery.compScale : BATTERY_SCALE_ONE;
+}
+
+int batteryKickScale() {
+    return battery.kickScale;
+}
+
+const BatteryState &batteryMonitorState() {
+    return battery;
+}
+
+const BatteryConfig &batteryMonitorConfig() {
+    return batteryConfig;
+}
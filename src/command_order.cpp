@@ -0,0 +1,42 @@
+// --- 控制命令順序檢查 ---
+#include "command_order.h"
+
+struct SessionSlot {
+    bool used;
+    uint32_t session;
+    uint32_t lastSeq;           // 上一次套用的序號
+    unsigned long lastSeenMs;   // 用於挑選要被取代的 slot
+};
+
+static SessionSlot sessions[COMMAND_ORDER_SESSIONS] = {};
+
+bool commandOrderAccept(uint32_t session, uint32_t seq, unsigned long nowMs) {
+    SessionSlot *slot = nullptr;
+    SessionSlot *oldest = &sessions[0];
+    for (int i = 0; i < COMMAND_ORDER_SESSIONS; i++) {
+        SessionSlot &s = sessions[i];
+        if (s.used && s.session == session) {
+            slot = &s;
+            break;
+        }
+        if (!s.used) {
+            oldest = &s;
+        } else if (oldest->used && nowMs - s.lastSeenMs > nowMs - oldest->lastSeenMs) {
+            oldest = &s;
+        }
+    }
+
+    if (slot == nullptr) {
+        // 新的 session：不論序號為何都接受
+        slot = oldest;
+        slot->used = true;
+        slot->session = session;
+    } else if ((int32_t)(seq - slot->lastSeq) <= 0) {
+        // 以差值判斷先後，序號溢位回繞時仍然正確
+        return false;
+    }
+
+    slot->lastSeq = seq;
+    slot->lastSeenMs = nowMs;
+    return true;
+}
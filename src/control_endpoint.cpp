@@ -0,0 +1,57 @@
+// --- /control 命令的套用 ---
+#include "control_endpoint.h"
+#include "command_order.h"
+#include "hal.h"
+#include "jitter_buffer.h"
+#include "link_supervisor.h"
+#include "metrics.h"
+#include "motor_control.h"
+
+#if CONTROL_KEEP_ALIVE
+// 連線在回應後交接給新的請求物件 (見 control_response.h)，瀏覽器可以直接送出下一個命令。
+// Keep-Alive 的 timeout 短於伺服器關閉閒置連線的時間，客戶端不會在即將被關閉的連線上送出命令
+const char CONTROL_ACK_HEAD[] =
+    "HTTP/1.1 204 No Content\r\n"
+    "Connection: keep-alive\r\n"
+    "Keep-Alive: timeout=2\r\n"
+    "\r\n";
+#else
+// AsyncWebServer 每條連線只處理一個請求，因此明確告知瀏覽器不要重用連線，
+// 避免下一個命令卡在一條伺服器已不再解析的連線上。
+const char CONTROL_ACK_HEAD[] =
+    "HTTP/1.1 204 No Content\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+#endif
+const size_t CONTROL_ACK_HEAD_LEN = sizeof(CONTROL_ACK_HEAD) - 1;
+
+ControlOutcome controlEndpointApply(const ControlQuery &query, bool valid, unsigned long nowMs) {
+    if (!valid || !controlQueryComplete(query)) {
+        metrics.controlRejected++;
+        return CONTROL_REJECTED;
+    }
+
+    // 帶有序號的命令若比該 session 已套用的命令舊，直接丟棄
+    bool stale = query.hasSeq && !commandOrderAccept(query.session, query.seq, nowMs);
+
+    // 任何有效命令的抵達都代表連線仍然存活；舊命令的目標已被取代，不改變是否監督
+    bool moving = stale ? linkSupervisorArmed() : (query.t != 0 || query.s != 0);
+    linkSupervisorOnCommand(nowMs, moving);
+    if (stale) {
+        metrics.controlStale++;
+        return CONTROL_STALE;
+    }
+
+    // 啟用 playout 緩衝時，帶時間戳的命令由 loop() 依原始間隔播放
+    if (query.hasTs && jitterBufferEnabled()) {
+        jitterBufferPush(query.session, query.ts, query.t, query.s, nowMs);
+    } else {
+        // 目標速度由控制核心約束在 T 和 S 的有效限制內
+        motorSetTarget(query.t, query.s);
+    }
+
+    halLog("WebControl (Input): T馬達(速度)=%d, S馬達(轉向)=%d\n", query.t, query.s);
+    metrics.controlRequests++;
+    metrics.controlAckBytes += CONTROL_ACK_HEAD_LEN;
+    return CONTROL_APPLIED;
+}
@@ -0,0 +1,77 @@
+// --- /control 查詢參數解析 (不配置 heap) ---
+#include <string.h>
+#include "control_query.h"
+
+bool parseSaturatedInt(const char *text, size_t len, int *out) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < len && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        i++;
+    }
+    if (i == len) return false; // 沒有任何數字
+
+    // 以負數累加，讓 CONTROL_VALUE_MIN 也能精確表示
+    const int limit = negative ? CONTROL_VALUE_MIN : -CONTROL_VALUE_MAX;
+    int value = 0;
+    for (; i < len; i++) {
+        char c = text[i];
+        if (c < '0' || c > '9') return false;
+        int digit = c - '0';
+        if (value < (limit + digit) / 10) {
+            value = limit;      // 飽和，但仍繼續檢查剩餘字元是否合法
+        } else {
+            value = value * 10 - digit;
+        }
+    }
+    *out = negative ? value : -value;
+    return true;
+}
+
+bool parseSaturatedUint32(const char *text, size_t len, uint32_t *out) {
+    if (len == 0) return false;
+
+    uint32_t value = 0;
+    for (size_t i = 0; i < len; i++) {
+        char c = text[i];
+        if (c < '0' || c > '9') return false;
+        uint32_t digit = (uint32_t)(c - '0');
+        if (value > (UINT32_MAX - digit) / 10) {
+            value = UINT32_MAX;     // 飽和，但仍繼續檢查剩餘字元是否合法
+        } else {
+            value = value * 10 + digit;
+        }
+    }
+    *out = value;
+    return true;
+}
+
+static bool fieldIs(const char *name, size_t nameLen, const char *expected) {
+    size_t expectedLen = strlen(expected);
+    return nameLen == expectedLen && memcmp(name, expected, nameLen) == 0;
+}
+
+bool controlQueryField(ControlQuery &query, const char *name, size_t nameLen,
+                       const char *value, size_t valueLen) {
+    if (fieldIs(name, nameLen, "t")) {
+        query.hasT = parseSaturatedInt(value, valueLen, &query.t);
+        return query.hasT;
+    }
+    if (fieldIs(name, nameLen, "s")) {
+        query.hasS = parseSaturatedInt(value, valueLen, &query.s);
+        return query.hasS;
+    }
+    if (fieldIs(name, nameLen, "c")) {
+        query.hasSession = parseSaturatedUint32(value, valueLen, &query.session);
+        return query.hasSession;
+    }
+    if (fieldIs(name, nameLen, "q")) {
+        query.hasSeq = parseSaturatedUint32(value, valueLen, &query.seq);
+        return query.hasSeq;
+    }
+    if (fieldIs(name, nameLen, "ts")) {
+        query.hasTs = parseSaturatedUint32(value, valueLen, &query.ts);
+        return query.hasTs;
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+// --- /control 的最小回應 (204 No Content) ---
+#include "control_response.h"
+
+#if CONTROL_KEEP_ALIVE
+// 閒置的保持連線在這段時間後由伺服器關閉 (與 AsyncWebServer 接受新連線時的設定相同)
+const uint32_t CONTROL_IDLE_TIMEOUT_S = 3;
+
+// 已交接連線、等待釋放的請求物件。交接發生在舊請求的 handler 之內，
+// 要等呼叫堆疊返回後才能 delete；每次交接時釋放最舊的一個 (所有 handler 都在 Web Server 任務中執行)
+const int RETIRED_REQUEST_SLOTS = 4;
+static AsyncWebServerRequest *retiredRequests[RETIRED_REQUEST_SLOTS];
+static int retiredNext = 0;
+
+static void retireRequest(AsyncWebServerRequest *request) {
+    delete retiredRequests[retiredNext];
+    retiredRequests[retiredNext] = request;
+    retiredNext = (retiredNext + 1) % RETIRED_REQUEST_SLOTS;
+}
+#endif
+
+ControlAckResponse::ControlAckResponse(AsyncWebServer *server) : _server(server) {
+    _code = 204;
+    _sendContentLength = false;
+}
+
+void ControlAckResponse::_respond(AsyncWebServerRequest *request) {
+    AsyncClient *client = request->client();
+    // 控制命令很小，不要讓 Nagle 演算法延遲送出
+    client->setNoDelay(true);
+
+    _state = RESPONSE_HEADERS;
+    if (client->space() < CONTROL_ACK_HEAD_LEN) {
+        _state = RESPONSE_FAILED;
+        client->close(true);
+        return;
+    }
+    _writtenLength = client->write(CONTROL_ACK_HEAD, CONTROL_ACK_HEAD_LEN);
+
+#if CONTROL_KEEP_ALIVE
+    // 回應已寫入送出緩衝區，這條連線改由新的請求物件接收下一個命令。
+    // 之後的 ACK 交給新請求 (它沒有回應，直接忽略)，本回應隨舊請求一起釋放。
+    // send() 會把 RX timeout 設為 0，重新設定讓閒置的連線仍會被關閉
+    _state = RESPONSE_END;
+    client->setRxTimeout(CONTROL_IDLE_TIMEOUT_S);
+    new AsyncWebServerRequest(_server, client);
+    retireRequest(request);
+#else
+    _state = RESPONSE_WAIT_ACK;
+#endif
+}
+
+size_t ControlAckResponse::_ack(AsyncWebServerRequest *request, size_t len, uint32_t time) {
+    (void)time;
+    _ackedLength += len;
+    if (_state == RESPONSE_WAIT_ACK && _ackedLength >= _writtenLength) {
+        _state = RESPONSE_END;
+        request->client()->close(true);
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+// --- 馬達電流感測與限流 ---
+#include "adc_sampler.h"
+#include "current_sense.h"
+
+void currentChannelReset(CurrentChannel &channel) {
+    channel.fastMa = 0;
+    channel.demandMa = 0;
+    channel.avgMaQ4 = 0;
+    channel.peakMa = 0;
+    channel.scale = CURRENT_SCALE_ONE;
+    channel.limitedTicks = 0;
+}
+
+int currentChannelUpdate(CurrentChannel &channel, const CurrentLimitConfig &config,
+                         int meanMa, int maxMa) {
+    // 快速濾波 (α = 1/2) 濾掉單一 tick 的雜訊，慢速濾波 (α = 1/64) 供遙測使用
+    channel.fastMa += (meanMa - channel.fastMa) / 2;
+    channel.avgMaQ4 += ((int32_t)meanMa * 16 - channel.avgMaQ4) / 64;
+    if (maxMa > channel.peakMa) channel.peakMa = maxMa;
+
+    // 電流大致與 duty 成正比：這個 tick 量到的電流是在目前的縮放下產生的，換算回未縮放的需求
+    int demandMa = (int)((int32_t)meanMa * CURRENT_SCALE_ONE / channel.scale);
+    channel.demandMa += (demandMa - channel.demandMa) / 2;
+    // 需求突然增加時不等濾波，直接以這個 tick 的值限流
+    int demand = demandMa > channel.demandMa ? demandMa : channel.demandMa;
+
+    int target = CURRENT_SCALE_ONE;
+    if (demand > config.budgetMa) {
+        target = (int)((int32_t)CURRENT_SCALE_ONE * config.budgetMa / demand);
+        if (target < config.minScale) target = config.minScale;
+        channel.limitedTicks++;
+    }
+    if (target < channel.scale) {
+        // 一次縮小到預算，下一個 tick 即回到預算內
+        channel.scale = target;
+    } else {
+        // 需求下降後逐步回復，不超過需求允許的縮放
+        channel.scale += config.recoverStep;
+        if (channel.scale > target) channel.scale = target;
+    }
+    return channel.scale;
+}
+
+// --- 韌體端狀態 ---
+struct CurrentInput {
+    int handle;                 // adc_sampler 的輸入 (-1 = 未安裝)
+    CurrentLimitConfig config;
+    CurrentChannel channel;
+};
+
+// 滑移轉向車架的 B 橋也是驅動馬達，使用與 T 相同的預算
+#ifdef MOTOR_LAYOUT_SKID_STEER
+static CurrentInput inputs[2] = {
+    { -1, CURRENT_LIMIT_DEFAULT_T, { 0, 0, 0, 0, CURRENT_SCALE_ONE, 0 } },
+    { -1, CURRENT_LIMIT_DEFAULT_T, { 0, 0, 0, 0, CURRENT_SCALE_ONE, 0 } },
+};
+#else
+static CurrentInput inputs[2] = {
+    { -1, CURRENT_LIMIT_DEFAULT_T, { 0, 0, 0, 0, CURRENT_SCALE_ONE, 0 } },
+    { -1, CURRENT_LIMIT_DEFAULT_S, { 0, 0, 0, 0, CURRENT_SCALE_ONE, 0 } },
+};
+#endif
+static int senseResistorMohm = 1;
+
+void currentSenseInit(int pinT, int pinS, int resistorMohm) {
+    if (resistorMohm < 1) return;
+    senseResistorMohm = resistorMohm;
+    inputs[MOTOR_T].handle = adcSamplerAddInput(pinT, HAL_ADC_ATTEN_0DB);
+    inputs[MOTOR_S].handle = adcSamplerAddInput(pinS, HAL_ADC_ATTEN_0DB);
+    if (currentSensePresent()) {
+        halLog("電流感測已啟用 (T: GPIO%d, S: GPIO%d, %d mΩ)\n", pinT, pinS, resistorMohm);
+    }
+}
+
+bool currentSensePresent() {
+    return currentSensePresent(MOTOR_T) || currentSensePresent(MOTOR_S);
+}
+
+bool currentSensePresent(int input) {
+    return input >= 0 && input < 2 && inputs[input].handle >= 0;
+}
+
+void currentSenseTick() {
+    for (int i = 0; i < 2; i++) {
+        CurrentInput &input = inputs[i];
+        if (input.handle < 0) continue;
+        AdcBatch batch = adcSamplerTake(input.handle);
+        if (batch.count == 0) continue;
+        int meanMa = batch.meanMv * 1000 / senseResistorMohm;
+        int maxMa = batch.maxMv * 1000 / senseResistorMohm;
+        currentChannelUpdate(input.channel, input.config, meanMa, maxMa);
+    }
+}
+
+int currentSenseScale(MotorId motor) {
+    return inputs[motor].channel.scale;
+}
+
+const CurrentChannel &currentSenseChannel(MotorId motor) {
+    return inputs[motor].channel;
+}
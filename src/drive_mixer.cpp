@@ -0,0 +1,78 @@
+// --- 驅動混控 (Passthrough / Arcade / Tank) ---
+#include <stdlib.h>
+#include <string.h>
+#include "drive_mixer.h"
+
+static const char *const MIX_MODE_NAMES[MIX_MODE_COUNT] = { "passthrough", "arcade", "tank" };
+
+// 滑移轉向車架預設以單搖桿差速驅動，其他車架維持原本的行為
+#ifdef MOTOR_LAYOUT_SKID_STEER
+static volatile MixMode activeMode = MIX_ARCADE;
+#else
+static volatile MixMode activeMode = MIX_PASSTHROUGH;
+#endif
+
+// 四捨五入的 value * num / den (den > 0)
+static int scaleRounded(int value, int num, int den) {
+    int product = value * num;
+    return product >= 0 ? (product + den / 2) / den : -((-product + den / 2) / den);
+}
+
+void mixerDifferential(int t, int s, int limit, int &left, int &right) {
+    left = t + s;
+    right = t - s;
+    int peak = abs(left) > abs(right) ? abs(left) : abs(right);
+    if (peak > limit) {
+        left = scaleRounded(left, limit, peak);
+        right = scaleRounded(right, limit, peak);
+    }
+}
+
+void mixerApply(MixMode mode, int t, int s, int limit, MixResult &out) {
+    switch (mode) {
+    case MIX_ARCADE:
+        out.v[MIX_THROTTLE] = t;
+        out.v[MIX_STEERING] = s;
+        mixerDifferential(t, s, limit, out.v[MIX_LEFT], out.v[MIX_RIGHT]);
+        break;
+    case MIX_TANK:
+        // 左右履帶直接對應；Ackermann 車架以兩側平均為油門、差值為轉向
+        out.v[MIX_LEFT] = t;
+        out.v[MIX_RIGHT] = s;
+        out.v[MIX_THROTTLE] = (t + s) / 2;
+        out.v[MIX_STEERING] = (t - s) / 2;
+        break;
+    case MIX_PASSTHROUGH:
+    default:
+        out.v[MIX_THROTTLE] = t;
+        out.v[MIX_STEERING] = s;
+        out.v[MIX_LEFT] = t;
+        out.v[MIX_RIGHT] = s;
+        break;
+    }
+}
+
+bool mixerSelect(MixMode mode) {
+    if (mode < 0 || mode >= MIX_MODE_COUNT) return false;
+    activeMode = mode;
+    return true;
+}
+
+bool mixerSelectByName(const char *name, size_t len) {
+    for (int i = 0; i < MIX_MODE_COUNT; i++) {
+        const char *candidate = MIX_MODE_NAMES[i];
+        if (strlen(candidate) == len && memcmp(candidate, name, len) == 0) {
+            return mixerSelect((MixMode)i);
+        }
+    }
+    return false;
+}
+
+MixMode mixerMode() {
+    return activeMode;
+}
+
+const char *mixerModeName(MixMode mode) {
+    if (mode < 0 || mode >= MIX_MODE_COUNT) return "";
+    return MIX_MODE_NAMES[mode];
+}
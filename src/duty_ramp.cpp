@@ -0,0 +1,71 @@
+// --- Duty Ramping 累加器與 PWM dithering ---
+#include <stdlib.h>
+#include "duty_ramp.h"
+
+static int minInt(int a, int b) {
+    return a < b ? a : b;
+}
+
+int rampStepQ8(int currentQ8, int target, const RampParams &p, KickState &kick, unsigned long now) {
+    if (target == 0) {
+        // 目標為 0 時立即停止 (輸出依 StopMode 煞車或滑行)
+        kick.active = false;
+        return 0;
+    }
+    int dir = target > 0 ? 1 : -1;
+    int targetQ8 = target * DUTY_Q8_ONE;
+
+    // 啟動推力期間: 以固定推力維持 kickMs，不論目標大小
+    if (kick.active) {
+        bool sameDirection = currentQ8 * dir > 0;
+        if (sameDirection && (long)(now - kick.untilMs) < 0) {
+            return dir * p.kick * DUTY_Q8_ONE;
+        }
+        kick.active = false;
+        // 推力結束後從推力與目標中較小者繼續；方向反轉則重新從靜止開始
+        currentQ8 = sameDirection ? dir * minInt(p.kick, abs(target)) * DUTY_Q8_ONE : 0;
+    }
+
+    if (currentQ8 == 0) {
+        if (p.kickMs > 0) {
+            kick.active = true;
+            kick.untilMs = now + p.kickMs;
+            return dir * p.kick * DUTY_Q8_ONE;
+        }
+        // 不使用推力時，直接從最低有效 duty 開始
+        currentQ8 = dir * minInt(p.minDuty, abs(target)) * DUTY_Q8_ONE;
+    }
+
+    // 減速時直接降到目標
+    if (abs(currentQ8) > abs(targetQ8)) {
+        currentQ8 = targetQ8;
+    }
+
+    if (abs(targetQ8 - currentQ8) > p.stepQ8) {
+        currentQ8 += targetQ8 > currentQ8 ? p.stepQ8 : -p.stepQ8;
+    } else {
+        currentQ8 = targetQ8;
+    }
+    return currentQ8;
+}
+
+int pwmDitherStep(PwmDither &dither, int dutyQ8, int dutyMax, int hwMax) {
+    if (dutyQ8 <= 0) return 0;
+    // 精確的硬體計數 (Q8)；14-bit 滿刻度時乘積超過 32-bit，以 64-bit 計算
+    int scaled = (int)((int64_t)dutyQ8 * hwMax / dutyMax);
+    int counts = scaled / DUTY_Q8_ONE;
+    dither.error += scaled % DUTY_Q8_ONE;
+    if (dither.error >= DUTY_Q8_ONE) {
+        dither.error -= DUTY_Q8_ONE;
+        counts++;
+    }
+    return counts < hwMax ? counts : hwMax;
+}
+
+int pwmResolutionBits(uint32_t clockHz, uint32_t frequency, int maxBits) {
+    if (frequency == 0) return 1;
+    uint32_t divider = clockHz / frequency;
+    int bits = 1;
+    while (bits < maxBits && (divider >> (bits + 1)) != 0) bits++;
+    return bits;
+}
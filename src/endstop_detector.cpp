@@ -0,0 +1,44 @@
+// --- 機械端點 (End-stop) 與堵轉偵測 ---
+#include "endstop_detector.h"
+
+void endstopReset(EndstopDetector &detector) {
+    detector.state = ENDSTOP_FREE;
+    detector.direction = 0;
+    detector.evidenceMs = 0;
+}
+
+int endstopUpdate(EndstopDetector &detector, const EndstopConfig &config, int command,
+                  int saturationDuty, int holdDuty, int currentMa, unsigned long elapsedMs) {
+    if (command == 0 || holdDuty <= 0) {
+        endstopReset(detector);
+        return command;
+    }
+    int dir = command > 0 ? 1 : -1;
+    int magnitude = command * dir;
+
+    if (dir != detector.direction) {
+        // 命令反向: 離開端點，重新開始判斷
+        endstopReset(detector);
+        detector.direction = dir;
+    }
+    if (detector.state == ENDSTOP_HOLDING) {
+        return dir * (magnitude < holdDuty ? magnitude : holdDuty);
+    }
+
+    bool sensed = currentMa >= 0;
+    bool evidence = sensed ? currentMa >= config.stallCurrentMa : magnitude >= saturationDuty;
+    if (!evidence) {
+        detector.state = ENDSTOP_FREE;
+        detector.evidenceMs = 0;
+        return command;
+    }
+
+    detector.state = ENDSTOP_SUSPECT;
+    detector.evidenceMs += elapsedMs;
+    if (detector.evidenceMs >= (sensed ? config.currentConfirmMs : config.saturationMs)) {
+        detector.state = ENDSTOP_HOLDING;
+        detector.detections++;
+        return dir * (magnitude < holdDuty ? magnitude : holdDuty);
+    }
+    return command;
+}
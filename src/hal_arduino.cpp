@@ -0,0 +1,217 @@
+// --- HAL 的 Arduino-ESP32 實作 ---
+#include <Arduino.h>
+#include <Preferences.h>
+#include <Wire.h>
+#include <stdarg.h>
+#include "driver/adc.h"
+#include "esp_partition.h"
+#include "hal.h"
+
+// NVS 中存放本專案資料的命名空間
+static const char *STORE_NAMESPACE = "launcher";
+
+unsigned long halMillis() {
+    return millis();
+}
+
+unsigned long halMicros() {
+    return micros();
+}
+
+void halGpioOutput(int pin, bool high) {
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, high ? HIGH : LOW);
+}
+
+bool halPwmSetup(int channel, int pin, int freq, int resolution) {
+    // 同一對通道 (0/1、2/3、4/5) 共用一個 LEDC timer，設定第二個時會覆蓋第一個的頻率
+    if (ledcSetup(channel, freq, resolution) == 0) return false;
+    ledcAttachPin(pin, channel);
+    return true;
+}
+
+void halPwmWrite(int channel, int duty) {
+    ledcWrite(channel, duty);
+}
+
+static HalEdgeHandler edgeHandler = nullptr;
+
+static void IRAM_ATTR edgeIsr() {
+    edgeHandler(micros());
+}
+
+void halEdgeInterruptAttach(int pin, HalEdgeHandler handler) {
+    edgeHandler = handler;
+    pinMode(pin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(pin), edgeIsr, RISING);
+}
+
+bool halI2cBegin(int sda, int scl, uint32_t hz) {
+    if (!Wire.begin(sda, scl, hz)) return false;
+    Wire.setTimeOut(10);
+    return true;
+}
+
+bool halI2cWriteReg(uint8_t addr, uint8_t reg, uint8_t value) {
+    Wire.beginTransmission(addr);
+    Wire.write(reg);
+    Wire.write(value);
+    return Wire.endTransmission() == 0;
+}
+
+bool halI2cReadRegs(uint8_t addr, uint8_t reg, uint8_t *buf, size_t len) {
+    if (len > HAL_I2C_READ_MAX) return false;
+    Wire.beginTransmission(addr);
+    Wire.write(reg);
+    // repeated start: 暫存器位址與讀取之間不釋放匯流排
+    if (Wire.endTransmission(false) != 0) return false;
+    if (Wire.requestFrom(addr, len) != len) return false;
+    for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)Wire.read();
+    return true;
+}
+
+bool halTaskStart(const char *name, HalTaskFn fn, void *arg, uint32_t stackBytes, int priority) {
+    return xTaskCreate(fn, name, stackBytes, arg, priority, nullptr) == pdPASS;
+}
+
+void halTaskDelayUntil(uint32_t &lastWake, unsigned long periodMs) {
+    TickType_t wake = lastWake != 0 ? (TickType_t)lastWake : xTaskGetTickCount();
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(periodMs));
+    lastWake = (uint32_t)wake;
+}
+
+// --- ADC 連續取樣 (IDF 4.4 adc_digi API) ---
+static const int ADC_INPUT_MAX = 5;
+static int adcInputChannel[ADC_INPUT_MAX];
+static int adcInputCount = 0;
+
+bool halAdcStreamStart(const HalAdcInput *inputs, int count, uint32_t sampleHz) {
+    if (count < 1 || count > ADC_INPUT_MAX) return false;
+
+    adc_digi_pattern_config_t pattern[ADC_INPUT_MAX] = {};
+    uint32_t mask = 0;
+    for (int i = 0; i < count; i++) {
+        int channel = digitalPinToAnalogChannel(inputs[i].pin);
+        if (channel < 0) return false;
+        adcInputChannel[i] = channel;
+        mask |= 1u << channel;
+        pattern[i].atten = inputs[i].atten == HAL_ADC_ATTEN_11DB ? ADC_ATTEN_DB_11 : ADC_ATTEN_DB_0;
+        pattern[i].channel = channel;
+        pattern[i].unit = 0;    // ADC1
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+    adcInputCount = count;
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = 2048;
+    init.conv_num_each_intr = 256;
+    init.adc1_chan_mask = mask;
+    init.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = false;
+    config.conv_limit_num = 250;
+    config.pattern_num = count;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = sampleHz;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    if (adc_digi_controller_configure(&config) != ESP_OK) return false;
+    return adc_digi_start() == ESP_OK;
+}
+
+int halAdcStreamRead(HalAdcSample *out, int max) {
+    uint8_t buf[256];
+    int n = 0;
+    while (n < max) {
+        uint32_t want = (uint32_t)(max - n) * SOC_ADC_DIGI_RESULT_BYTES;
+        if (want > sizeof(buf)) want = sizeof(buf);
+        uint32_t got = 0;
+        if (adc_digi_read_bytes(buf, want, &got, 0) != ESP_OK || got == 0) break;
+        for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= got; i += SOC_ADC_DIGI_RESULT_BYTES) {
+            const adc_digi_output_data_t *d = (const adc_digi_output_data_t *)&buf[i];
+            if (d->type2.unit != 0) continue;
+            for (int k = 0; k < adcInputCount; k++) {
+                if (adcInputChannel[k] == (int)d->type2.channel) {
+                    out[n].input = (uint8_t)k;
+                    out[n].raw = (uint16_t)d->type2.data;
+                    n++;
+                    break;
+                }
+            }
+        }
+    }
+    return n;
+}
+
+int halAdcToMillivolts(int raw, HalAdcAtten atten) {
+    // 線性近似 (未使用 eFuse 校正值)，足以用於限流與電壓監控
+    int fullScaleMv = atten == HAL_ADC_ATTEN_11DB ? 2500 : 750;
+    return raw * fullScaleMv / HAL_ADC_RAW_MAX;
+}
+
+void halLog(const char *fmt, ...) {
+    // 使用固定大小的堆疊緩衝區，避免在 Log 中配置 heap
+    char buf[160];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    Serial.print(buf);
+}
+
+size_t halHeapFree() {
+    return ESP.getFreeHeap();
+}
+
+size_t halHeapMinFree() {
+    return ESP.getMinFreeHeap();
+}
+
+size_t halHeapMaxBlock() {
+    return ESP.getMaxAllocHeap();
+}
+
+bool halStoreLoad(const char *key, void *data, size_t len) {
+    Preferences prefs;
+    if (!prefs.begin(STORE_NAMESPACE, true)) return false;
+
+    size_t readLen = 0;
+    if (prefs.getBytesLength(key) == len) {
+        readLen = prefs.getBytes(key, data, len);
+    }
+    prefs.end();
+    return readLen == len;
+}
+
+bool halStoreSave(const char *key, const void *data, size_t len) {
+    Preferences prefs;
+    if (!prefs.begin(STORE_NAMESPACE, false)) return false;
+
+    size_t written = prefs.putBytes(key, data, len);
+    prefs.end();
+    return written == len;
+}
+
+bool halFlashRegionOpen(const char *label, HalFlashRegion &region) {
+    const esp_partition_t *partition =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (partition == nullptr) return false;
+    region.handle = partition;
+    region.size = partition->size;
+    return true;
+}
+
+bool halFlashRegionErase(const HalFlashRegion &region) {
+    const esp_partition_t *partition = (const esp_partition_t *)region.handle;
+    return esp_partition_erase_range(partition, 0, partition->size) == ESP_OK;
+}
+
+bool halFlashRegionWrite(const HalFlashRegion &region, size_t offset, const void *data, size_t len) {
+    return esp_partition_write((const esp_partition_t *)region.handle, offset, data, len) == ESP_OK;
+}
+
+bool halFlashRegionRead(const HalFlashRegion &region, size_t offset, void *data, size_t len) {
+    return esp_partition_read((const esp_partition_t *)region.handle, offset, data, len) == ESP_OK;
+}
@@ -0,0 +1,38 @@
+// --- 航向保持 (Heading Hold) ---
+#include "heading_hold.h"
+#include "imu_gyro.h"
+
+void headingHoldReset(HeadingHoldState &state) {
+    state.holding = false;
+    state.targetMdeg = 0;
+    state.settledMs = 0;
+    state.trim = 0;
+}
+
+int headingHoldUpdate(HeadingHoldState &state, const HeadingHoldConfig &config, bool steeringCentered,
+                      int throttle, int32_t headingMdeg, int32_t rateMdps, unsigned long elapsedMs) {
+    int speed = throttle < 0 ? -throttle : throttle;
+    if (!steeringCentered || speed < config.minThrottle) {
+        headingHoldReset(state);
+        return 0;
+    }
+
+    if (!state.holding) {
+        int32_t rate = rateMdps < 0 ? -rateMdps : rateMdps;
+        state.settledMs = rate < config.settleRateMdps ? state.settledMs + elapsedMs : 0;
+        if (state.settledMs < config.engageMs) return 0;
+        state.holding = true;
+        state.targetMdeg = headingMdeg;
+        state.engagements++;
+    }
+
+    // 偏右 (誤差為負) 時向左修正；角速度項抑制過衝
+    int32_t error = gyroHeadingDiffMdeg(state.targetMdeg, headingMdeg);
+    int64_t trimQ8 = (int64_t)config.kp * error / 1000 - (int64_t)config.kd * rateMdps / 1000;
+    int trim = (int)(trimQ8 / 256);
+    if (trim > config.maxTrim) trim = config.maxTrim;
+    if (trim < -config.maxTrim) trim = -config.maxTrim;
+    if (throttle < 0) trim = -trim;
+    state.trim = trim;
+    return trim;
+}
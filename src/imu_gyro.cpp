@@ -0,0 +1,201 @@
+// --- I2C 陀螺儀 (MPU-6050，選用) ---
+#include "hal.h"
+#include "imu_gyro.h"
+
+int gyroFifoParse(const uint8_t *data, size_t len, int16_t *out, int max) {
+    int count = 0;
+    for (size_t i = 0; i + 1 < len && count < max; i += 2) {
+        out[count++] = (int16_t)((data[i] << 8) | data[i + 1]);
+    }
+    return count;
+}
+
+void gyroIntegratorReset(GyroIntegrator &gyro) {
+    gyro.biasQ16 = 0;
+    gyro.biasSum = 0;
+    gyro.biasSamples = 0;
+    gyro.ready = false;
+    gyro.headingUdeg = 0;
+    gyro.rateMdps = 0;
+}
+
+void gyroIntegrate(GyroIntegrator &gyro, const GyroConfig &config, const int16_t *samples, int count,
+                   bool stationary) {
+    if (count <= 0) return;
+    int64_t rateSum = 0;
+    for (int i = 0; i < count; i++) {
+        int64_t rawQ16 = (int64_t)samples[i] * 65536;
+        if (!gyro.ready) {
+            // 開機校正: 平均靜止時連續 calibrationSamples 個樣本作為零點 (馬達轉動時重新開始)
+            if (!stationary) {
+                gyro.biasSum = 0;
+                gyro.biasSamples = 0;
+                continue;
+            }
+            gyro.biasSum += samples[i];
+            gyro.biasSamples++;
+            if (gyro.biasSamples >= config.calibrationSamples) {
+                gyro.biasQ16 = (int64_t)gyro.biasSum * 65536 / (int32_t)gyro.biasSamples;
+                gyro.ready = true;
+            }
+            continue;
+        }
+
+        int64_t offsetQ16 = rawQ16 - gyro.biasQ16;
+        int64_t stillQ16 = (int64_t)config.stillRawLimit * 65536;
+        if (stationary && offsetQ16 < stillQ16 && offsetQ16 > -stillQ16) {
+            gyro.biasQ16 += offsetQ16 >> config.biasTrackShift;
+            offsetQ16 = rawQ16 - gyro.biasQ16;
+        }
+        int32_t rateMdps = (int32_t)(offsetQ16 * 10000 / ((int64_t)GYRO_LSB_PER_DPS_X10 * 65536)) * config.sign;
+        rateSum += rateMdps;
+
+        // 每個樣本的角度增量 (µ°) = m°/s × 1000 / 取樣率
+        gyro.headingUdeg += rateMdps * 1000 / config.sampleHz;
+        if (gyro.headingUdeg >= 180 * GYRO_DEG_UDEG) gyro.headingUdeg -= 360 * GYRO_DEG_UDEG;
+        if (gyro.headingUdeg < -180 * GYRO_DEG_UDEG) gyro.headingUdeg += 360 * GYRO_DEG_UDEG;
+    }
+    if (gyro.ready) gyro.rateMdps = (int32_t)(rateSum / count);
+}
+
+int32_t gyroHeadingDiffMdeg(int32_t aMdeg, int32_t bMdeg) {
+    int32_t diff = aMdeg - bMdeg;
+    while (diff >= 180000) diff -= 360000;
+    while (diff < -180000) diff += 360000;
+    return diff;
+}
+
+// --- 韌體端狀態 ---
+// MPU-6050 暫存器
+const uint8_t MPU_ADDR = 0x68;
+const uint8_t MPU_SMPLRT_DIV = 0x19;
+const uint8_t MPU_CONFIG = 0x1A;
+const uint8_t MPU_GYRO_CONFIG = 0x1B;
+const uint8_t MPU_FIFO_EN = 0x23;
+const uint8_t MPU_INT_STATUS = 0x3A;
+const uint8_t MPU_USER_CTRL = 0x6A;
+const uint8_t MPU_PWR_MGMT_1 = 0x6B;
+const uint8_t MPU_FIFO_COUNT_H = 0x72;
+const uint8_t MPU_FIFO_R_W = 0x74;
+const uint8_t MPU_WHO_AM_I = 0x75;
+
+const uint8_t MPU_FIFO_ZG = 0x10;           // FIFO_EN: Z 軸角速度
+const uint8_t MPU_USER_FIFO_EN = 0x40;
+const uint8_t MPU_USER_FIFO_RESET = 0x04;
+const uint8_t MPU_INT_FIFO_OFLOW = 0x10;
+
+const unsigned long GYRO_TASK_PERIOD_MS = 10;   // 每次約 10 個樣本 (20 bytes)，FIFO 可容納 0.5 秒
+const uint32_t GYRO_I2C_HZ = 400000;
+
+static bool taskRunning = false;
+static GyroConfig gyroConfig = GYRO_DEFAULT;
+static GyroIntegrator integrator = {};
+static GyroStats stats = {};
+static volatile bool stationaryFlag = true;
+static volatile bool publishedReady = false;
+static volatile int32_t publishedHeadingMdeg = 0;
+static volatile int32_t publishedRateMdps = 0;
+
+static bool resetFifo() {
+    return halI2cWriteReg(MPU_ADDR, MPU_USER_CTRL, MPU_USER_FIFO_RESET) &&
+           halI2cWriteReg(MPU_ADDR, MPU_USER_CTRL, MPU_USER_FIFO_EN);
+}
+
+// 讀出 FIFO 中所有完整的樣本並積分
+void gyroPoll() {
+    uint8_t status;
+    uint8_t countBytes[2];
+    if (!halI2cReadRegs(MPU_ADDR, MPU_INT_STATUS, &status, 1) ||
+        !halI2cReadRegs(MPU_ADDR, MPU_FIFO_COUNT_H, countBytes, 2)) {
+        stats.i2cErrors++;
+        return;
+    }
+    if (status & MPU_INT_FIFO_OFLOW) {
+        // 溢位後 FIFO 內的樣本可能錯位，整個丟棄重新開始 (這段時間的角度變化會遺失)
+        stats.fifoOverflows++;
+        if (!resetFifo()) stats.i2cErrors++;
+        return;
+    }
+
+    size_t pending = (size_t)((countBytes[0] << 8) | countBytes[1]) & ~(size_t)1;
+    while (pending > 0) {
+        uint8_t burst[HAL_I2C_READ_MAX];
+        size_t len = pending < sizeof(burst) ? pending : sizeof(burst);
+        if (!halI2cReadRegs(MPU_ADDR, MPU_FIFO_R_W, burst, len)) {
+            stats.i2cErrors++;
+            return;
+        }
+        int16_t samples[HAL_I2C_READ_MAX / 2];
+        int count = gyroFifoParse(burst, len, samples, HAL_I2C_READ_MAX / 2);
+        gyroIntegrate(integrator, gyroConfig, samples, count, stationaryFlag);
+        stats.samples += count;
+        pending -= len;
+    }
+
+    publishedHeadingMdeg = integrator.headingUdeg / 1000;
+    publishedRateMdps = integrator.rateMdps;
+    publishedReady = integrator.ready;
+}
+
+static void gyroTask(void *arg) {
+    (void)arg;
+    uint32_t lastWake = 0;
+    for (;;) {
+        gyroPoll();
+        halTaskDelayUntil(lastWake, GYRO_TASK_PERIOD_MS);
+    }
+}
+
+void gyroInit(int sda, int scl, int yawSign) {
+    // 重新初始化時先回到未安裝的狀態 (主機端的模擬器在同一個行程中重複初始化)
+    taskRunning = false;
+    stationaryFlag = true;
+    publishedReady = false;
+    publishedHeadingMdeg = 0;
+    publishedRateMdps = 0;
+    stats = GyroStats();
+    gyroIntegratorReset(integrator);
+    if (sda < 0 || scl < 0) return;
+    gyroConfig.sign = yawSign;
+    uint8_t id = 0;
+    if (!halI2cBegin(sda, scl, GYRO_I2C_HZ) || !halI2cReadRegs(MPU_ADDR, MPU_WHO_AM_I, &id, 1) ||
+        id != MPU_ADDR) {
+        halLog("找不到陀螺儀 (SDA GPIO%d, SCL GPIO%d, WHO_AM_I=0x%02x)\n", sda, scl, id);
+        return;
+    }
+
+    // 喚醒並使用陀螺儀 X 軸 PLL 作為時脈；DLPF 98Hz (陀螺儀內部 1kHz)；±500 °/s；只把 Z 軸寫入 FIFO
+    bool ok = halI2cWriteReg(MPU_ADDR, MPU_PWR_MGMT_1, 0x01) &&
+              halI2cWriteReg(MPU_ADDR, MPU_CONFIG, 0x02) &&
+              halI2cWriteReg(MPU_ADDR, MPU_SMPLRT_DIV, (uint8_t)(1000 / gyroConfig.sampleHz - 1)) &&
+              halI2cWriteReg(MPU_ADDR, MPU_GYRO_CONFIG, 0x08) &&
+              halI2cWriteReg(MPU_ADDR, MPU_FIFO_EN, MPU_FIFO_ZG) &&
+              resetFifo();
+    if (!ok) {
+        halLog("陀螺儀設定失敗\n");
+        return;
+    }
+
+    taskRunning = halTaskStart("gyro", gyroTask, nullptr, 3072, 1);
+    halLog("陀螺儀已啟用 (%d Hz FIFO)，開機校正期間請保持靜止\n", gyroConfig.sampleHz);
+}
+
+bool gyroPresent() {
+    return taskRunning && publishedReady;
+}
+
+void gyroSetStationary(bool stationary) {
+    stationaryFlag = stationary;
+}
+
+int32_t gyroHeadingMdeg() {
+    return publishedHeadingMdeg;
+}
+
+int32_t gyroYawRateMdps() {
+    return publishedRateMdps;
+}
+
+const GyroStats &gyroStats() {
+    return stats;
+}
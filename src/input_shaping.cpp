@@ -0,0 +1,116 @@
+// --- 搖桿輸入整形 (死區、Expo 曲線、各軸增益) ---
+#include <stdint.h>
+#include <string.h>
+#include "input_shaping.h"
+
+// --- 曲線參數 ---
+struct ShapeParams {
+    int deadzone;   // 死區 (0..254)，死區以外重新拉伸到 0..255
+    int expo;       // Expo 比例 (0..100%)：y = (1-e)·u + e·u³
+    int gain;       // 增益 (%)，結果飽和在 255
+};
+
+struct ShapeTable {
+    uint8_t v[MOTOR_INPUT_MAX + 1];
+};
+
+// --- 編譯期計算 (C++11 constexpr：每個函式只有一個 return 運算式) ---
+constexpr int shapeStretch(int x, int deadzone) {
+    return x <= deadzone ? 0 : (x - deadzone) * MOTOR_INPUT_MAX / (MOTOR_INPUT_MAX - deadzone);
+}
+
+constexpr int shapeExpo(int u, int expo) {
+    return ((100 - expo) * u + expo * (u * u / MOTOR_INPUT_MAX) * u / MOTOR_INPUT_MAX) / 100;
+}
+
+constexpr int shapeSaturate(int y) {
+    return y > MOTOR_INPUT_MAX ? MOTOR_INPUT_MAX : y;
+}
+
+constexpr uint8_t shapeValue(int x, ShapeParams p) {
+    return (uint8_t)shapeSaturate(shapeExpo(shapeStretch(x, p.deadzone), p.expo) * p.gain / 100);
+}
+
+// 以索引序列在編譯期展開 256 筆
+template<int... I> struct IndexList {};
+template<int N, int... I> struct MakeIndexList : MakeIndexList<N - 1, N - 1, I...> {};
+template<int... I> struct MakeIndexList<0, I...> { typedef IndexList<I...> type; };
+
+template<int... I>
+constexpr ShapeTable buildShapeTable(ShapeParams p, IndexList<I...>) {
+    return ShapeTable{ { shapeValue(I, p)... } };
+}
+
+constexpr ShapeTable makeShapeTable(ShapeParams p) {
+    return buildShapeTable(p, MakeIndexList<MOTOR_INPUT_MAX + 1>::type());
+}
+
+// 對照表必須單調不減 (搖桿推得越多，輸出不會變小)，且 0 必須對應到 0
+constexpr bool shapeMonotonic(const ShapeTable &t, int i) {
+    return i > MOTOR_INPUT_MAX ? true : (t.v[i] >= t.v[i - 1] && shapeMonotonic(t, i + 1));
+}
+
+constexpr bool shapeValid(const ShapeTable &t) {
+    return t.v[0] == 0 && shapeMonotonic(t, 1);
+}
+
+struct ShapeProfile {
+    const char *name;
+    ShapeTable throttle;    // T 軸
+    ShapeTable steering;    // S 軸
+};
+
+// 死區 20 與網頁端的 DEADZONE_PWM 相同，讓其他客戶端也有一致的手感
+static constexpr ShapeProfile SHAPE_PROFILES[SHAPE_PROFILE_COUNT] = {
+    { "linear",   makeShapeTable({ 0, 0, 100 }),  makeShapeTable({ 0, 0, 100 }) },
+    { "standard", makeShapeTable({ 20, 0, 100 }), makeShapeTable({ 20, 0, 100 }) },
+    { "smooth",   makeShapeTable({ 20, 35, 100 }), makeShapeTable({ 20, 50, 100 }) },
+    { "precise",  makeShapeTable({ 12, 70, 100 }), makeShapeTable({ 12, 70, 80 }) },
+};
+
+static_assert(shapeValid(SHAPE_PROFILES[SHAPE_LINEAR].throttle) &&
+              shapeValid(SHAPE_PROFILES[SHAPE_LINEAR].steering), "linear 曲線表必須單調遞增");
+static_assert(shapeValid(SHAPE_PROFILES[SHAPE_STANDARD].throttle) &&
+              shapeValid(SHAPE_PROFILES[SHAPE_STANDARD].steering), "standard 曲線表必須單調遞增");
+static_assert(shapeValid(SHAPE_PROFILES[SHAPE_SMOOTH].throttle) &&
+              shapeValid(SHAPE_PROFILES[SHAPE_SMOOTH].steering), "smooth 曲線表必須單調遞增");
+static_assert(shapeValid(SHAPE_PROFILES[SHAPE_PRECISE].throttle) &&
+              shapeValid(SHAPE_PROFILES[SHAPE_PRECISE].steering), "precise 曲線表必須單調遞增");
+static_assert(SHAPE_PROFILES[SHAPE_LINEAR].throttle.v[MOTOR_INPUT_MAX] == MOTOR_INPUT_MAX,
+              "linear 曲線表必須是恆等對應");
+
+static const ShapeProfile *volatile activeProfile = &SHAPE_PROFILES[SHAPE_DEFAULT];
+
+int shapeInput(MotorId axis, int raw) {
+    const ShapeProfile *profile = activeProfile;
+    const ShapeTable &table = axis == MOTOR_T ? profile->throttle : profile->steering;
+    if (raw >= 0) {
+        return table.v[raw > MOTOR_INPUT_MAX ? MOTOR_INPUT_MAX : raw];
+    }
+    return -table.v[raw < -MOTOR_INPUT_MAX ? MOTOR_INPUT_MAX : -raw];
+}
+
+bool inputShapingSelect(ShapeProfileId profile) {
+    if (profile < 0 || profile >= SHAPE_PROFILE_COUNT) return false;
+    activeProfile = &SHAPE_PROFILES[profile];
+    return true;
+}
+
+bool inputShapingSelectByName(const char *name, size_t len) {
+    for (int i = 0; i < SHAPE_PROFILE_COUNT; i++) {
+        const char *candidate = SHAPE_PROFILES[i].name;
+        if (strlen(candidate) == len && memcmp(candidate, name, len) == 0) {
+            return inputShapingSelect((ShapeProfileId)i);
+        }
+    }
+    return false;
+}
+
+ShapeProfileId inputShapingProfile() {
+    return (ShapeProfileId)(activeProfile - SHAPE_PROFILES);
+}
+
+const char *inputShapingProfileName(ShapeProfileId profile) {
+    if (profile < 0 || profile >= SHAPE_PROFILE_COUNT) return "";
+    return SHAPE_PROFILES[profile].name;
+}
@@ -0,0 +1,183 @@
+// --- 設定值抖動緩衝 (Jitter Buffer) 與定時播放 ---
+#include "jitter_buffer.h"
+
+static const uint32_t INDEX_MASK = JITTER_BUFFER_SIZE - 1;
+
+// 時鐘偏移估計的視窗長度：視窗內最快抵達的封包代表最小傳遞延遲，
+// 每個視窗結束時採用該最小值，以追蹤兩端時鐘的漂移
+static const unsigned long OFFSET_WINDOW_MS = 2000;
+
+// 緩衝播完後仍持續輸出最後一筆的時間，超過後交還給直接命令
+static const unsigned long PLAYOUT_IDLE_MS = 500;
+
+struct PlayoutSample {
+    unsigned long playAt;   // 本地播放時間 (ms)
+    int t;
+    int s;
+};
+
+static PlayoutSample ring[JITTER_BUFFER_SIZE];
+static volatile uint32_t ringHead = 0;      // 由寫入者遞增
+static volatile uint32_t ringTail = 0;      // 由讀取者遞增
+
+// 延遲設定由寫入端以單一 32 位元欄位公開，讀取端在 jitterBufferPlayout 中套用並清空自己的狀態：
+//   bit 0-7 延遲 (ms)、bit 8-15 設定序號、bit 16-31 設定當下 ringHead 的低 16 位元
+// 讀取端只丟棄設定之前寫入的資料，設定之後以新延遲寫入的資料保留
+static volatile uint32_t delayRequest = 0;
+static_assert(JITTER_DELAY_MAX_MS <= 0xFF, "延遲需放得進 delayRequest 的 8 個位元");
+
+// --- 寫入端狀態 (Web Server 任務) ---
+static bool haveSession = false;
+static uint32_t currentSession = 0;
+static uint32_t lastTs = 0;
+static bool haveOffset = false;
+static int32_t clockOffset = 0;             // 本地時間 - 客戶端時間
+static int32_t windowMinOffset = 0;
+static unsigned long windowStartMs = 0;
+static unsigned long lastPlayAt = 0;
+
+// --- 讀取端狀態 (loop) ---
+static uint32_t appliedRequest = 0;
+static int playoutDelayMs = 0;
+static bool currentValid = false;
+static PlayoutSample current;
+static bool inUnderrun = false;
+
+static volatile uint32_t underrunCount = 0;
+static volatile uint32_t overflowCount = 0;
+static volatile uint32_t lateCount = 0;
+
+void jitterBufferSetDelay(int delayMs) {
+    if (delayMs < 0) delayMs = 0;
+    if (delayMs > JITTER_DELAY_MAX_MS) delayMs = JITTER_DELAY_MAX_MS;
+
+    // ringTail 與播放狀態屬於讀取端，這裡只重設寫入端的狀態並公開新的設定
+    haveSession = false;
+    haveOffset = false;
+    uint32_t generation = ((delayRequest >> 8) + 1) & 0xFF;
+    delayRequest = (ringHead << 16) | (generation << 8) | (uint32_t)delayMs;
+}
+
+static int requestedDelayMs() {
+    return (int)(delayRequest & 0xFF);
+}
+
+bool jitterBufferEnabled() {
+    return requestedDelayMs() > 0;
+}
+
+bool jitterBufferPush(uint32_t session, uint32_t ts, int t, int s, unsigned long nowMs) {
+    int delayMs = requestedDelayMs();
+    if (delayMs == 0) return false;
+
+    // 新的 session 使用自己的時鐘，重新估計偏移
+    if (!haveSession || session != currentSession) {
+        haveSession = true;
+        currentSession = session;
+        haveOffset = false;
+    } else if ((int32_t)(ts - lastTs) <= 0) {
+        return false;   // 時間戳沒有前進：重複或亂序的舊命令
+    }
+    lastTs = ts;
+
+    int32_t offset = (int32_t)(nowMs - ts);
+    if (!haveOffset) {
+        haveOffset = true;
+        clockOffset = offset;
+        windowMinOffset = offset;
+        windowStartMs = nowMs;
+    } else {
+        // 更快抵達的封包表示先前的估計偏高，立即採用
+        if (offset < clockOffset) clockOffset = offset;
+        if (offset < windowMinOffset) windowMinOffset = offset;
+        if (nowMs - windowStartMs >= OFFSET_WINDOW_MS) {
+            clockOffset = windowMinOffset;
+            windowMinOffset = offset;
+            windowStartMs = nowMs;
+        }
+    }
+
+    unsigned long playAt = ts + clockOffset + delayMs;
+    // 偏移估計變動時仍保持播放時間嚴格遞增
+    if ((long)(playAt - lastPlayAt) <= 0) {
+        playAt = lastPlayAt + 1;
+    }
+    if ((long)(nowMs - playAt) > 0) lateCount++;
+
+    uint32_t head = ringHead;
+    if (head - ringTail >= (uint32_t)JITTER_BUFFER_SIZE) {
+        overflowCount++;
+        return false;
+    }
+    PlayoutSample &slot = ring[head & INDEX_MASK];
+    slot.playAt = playAt;
+    slot.t = t;
+    slot.s = s;
+    lastPlayAt = playAt;
+    ringHead = head + 1;    // 資料寫完後才公開給讀取端
+    return true;
+}
+
+// 套用寫入端公開的新延遲: 丟棄設定之前寫入的資料並清除播放點
+static void applyDelayRequest() {
+    uint32_t request = delayRequest;
+    if (request == appliedRequest) return;
+    appliedRequest = request;
+    // 設定後寫入的筆數不會超過緩衝大小，由目前的 ringHead 還原完整的索引
+    uint32_t head = ringHead;
+    ringTail = head - ((head - (request >> 16)) & 0xFFFF);
+    currentValid = false;
+    inUnderrun = false;
+    playoutDelayMs = (int)(request & 0xFF);
+}
+
+bool jitterBufferPlayout(unsigned long nowMs, int *t, int *s) {
+    applyDelayRequest();
+    if (playoutDelayMs == 0) return false;
+
+    // 取出所有已到播放時間的資料，最後一筆成為目前的播放點
+    uint32_t tail = ringTail;
+    uint32_t head = ringHead;
+    while (tail != head && (long)(nowMs - ring[tail & INDEX_MASK].playAt) >= 0) {
+        current = ring[tail & INDEX_MASK];
+        currentValid = true;
+        inUnderrun = false;
+        tail++;
+    }
+    ringTail = tail;
+
+    if (!currentValid) return false;
+
+    if (tail != head) {
+        // 在目前播放點與下一筆之間線性內插 (包含中間漏掉命令的空隙)
+        const PlayoutSample &next = ring[tail & INDEX_MASK];
+        long span = (long)(next.playAt - current.playAt);
+        long elapsed = (long)(nowMs - current.playAt);
+        *t = current.t + (int)((long)(next.t - current.t) * elapsed / span);
+        *s = current.s + (int)((long)(next.s - current.s) * elapsed / span);
+        return true;
+    }
+
+    // 緩衝已空：維持最後一筆，並記錄一次 underrun
+    if (!inUnderrun) {
+        inUnderrun = true;
+        underrunCount++;
+    }
+    if (nowMs - current.playAt > PLAYOUT_IDLE_MS) {
+        currentValid = false;
+        return false;
+    }
+    *t = current.t;
+    *s = current.s;
+    return true;
+}
+
+JitterBufferStats jitterBufferStats() {
+    JitterBufferStats stats;
+    stats.delayMs = requestedDelayMs();
+    stats.depth = (int)(ringHead - ringTail);
+    stats.underruns = underrunCount;
+    stats.overflows = overflowCount;
+    stats.late = lateCount;
+    return stats;
+}
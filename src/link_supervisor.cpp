@@ -0,0 +1,70 @@
+// --- 控制連線監督 (命令遺失時的定時衰減停止) ---
+#include "hal.h"
+#include "link_supervisor.h"
+
+static LinkSupervisorConfig linkConfig = LINK_SUPERVISOR_DEFAULT;
+static volatile bool armed = false;        // 最後一筆命令的目標不為 0
+static volatile unsigned long lastCommandMs = 0;
+
+static bool degraded = false;
+static uint32_t lossCount = 0;
+
+void linkSupervisorConfigure(const LinkSupervisorConfig &config) {
+    linkConfig = config;
+    if (linkConfig.decayMs == 0) linkConfig.decayMs = 1;
+}
+
+void linkSupervisorOnCommand(unsigned long nowMs, bool moving) {
+    lastCommandMs = nowMs;
+    armed = moving;
+}
+
+// 衰減曲線: elapsed 為進入衰減後經過的時間 (0..decayMs)
+static int decayScale(unsigned long elapsed, const LinkSupervisorConfig &config) {
+    if (elapsed >= config.decayMs) return 0;
+
+    if (config.profile == LINK_DECAY_EXPONENTIAL) {
+        // 8 段減半，段內線性內插
+        unsigned long pos = elapsed * 8 * LINK_SCALE_ONE / config.decayMs;
+        int halvings = (int)(pos / LINK_SCALE_ONE);
+        int frac = (int)(pos % LINK_SCALE_ONE);
+        int high = LINK_SCALE_ONE >> halvings;
+        int low = high >> 1;
+        return high - (high - low) * frac / LINK_SCALE_ONE;
+    }
+    return (int)(LINK_SCALE_ONE - elapsed * LINK_SCALE_ONE / config.decayMs);
+}
+
+int linkSupervisorScale(unsigned long nowMs) {
+    // 命令可能在讀取 nowMs 之後才更新 lastCommandMs，此時視為剛收到
+    long sinceLast = (long)(nowMs - lastCommandMs);
+    unsigned long silence = sinceLast > 0 ? (unsigned long)sinceLast : 0;
+
+    // 最後的目標已是 0 (放開搖桿) 時客戶端可能停止送出命令，沒有需要衰減的目標，不視為遺失
+    if (!armed || silence <= linkConfig.graceMs) {
+        if (degraded) {
+            degraded = false;
+            halLog("✅ 控制連線恢復，目標速度立即回復\n");
+        }
+        return LINK_SCALE_ONE;
+    }
+
+    if (!degraded) {
+        degraded = true;
+        lossCount++;
+        halLog("⚠️ %lu ms 未收到控制命令，目標速度開始衰減\n", silence);
+    }
+    return decayScale(silence - linkConfig.graceMs, linkConfig);
+}
+
+bool linkSupervisorArmed() {
+    return armed;
+}
+
+uint32_t linkSupervisorLossCount() {
+    return lossCount;
+}
+
+bool linkSupervisorDegraded() {
+    return degraded;
+}
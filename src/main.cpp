@@ -8,7 +8,19 @@
 #include "esp_ota_ops.h"             // OTA 相關操作
 #include "esp_partition.h"           // 分區表操作
 #include "esp_task_wdt.h"            // Watchdog Timer 函式庫
-#include "esp32c3_gpio.h" 
+#include "motor_control.h"           // 馬達控制核心 (透過 HAL 存取硬體)
+#include "motor_config.h"            // 執行期可調整的 Ramping 參數 (/config)
+#include "metrics.h"                 // 執行期統計 (/metrics)
+#include "control_query.h"           // /control 參數解析 (不配置 heap)
+#include "control_response.h"        // /control 的最小 204 回應
+#include "control_endpoint.h"        // /control 命令的套用 (序號、playout、Ramping)
+#include "jitter_buffer.h"           // 設定值抖動緩衝與定時播放
+#include "link_supervisor.h"         // 命令中斷時的定時衰減停止
+#include "input_shaping.h"           // 搖桿輸入整形 profile
+#include "drive_mixer.h"             // 驅動混控模式 (/mix)
+#include "session_recorder.h"        // 駕駛紀錄錄製/重播 (/record)
+#include "web_page.h"                // 搖桿網頁 (HTML_CONTENT)
+#include "hal.h"                     // halLog (固定緩衝區，不配置 heap)
 
 // --- 全域變數 ---
 String globalHostname;              // 基於 MAC 位址的唯一 Hostname
@@ -18,312 +30,6 @@ AsyncWebServer server(80);          // 實例化 Async Web Server
 ESPAsync_WiFiManager *wm;           // 實例化 Async WiFiManager
 AsyncDNSServer dns;
 
-// LEDC PWM 設定
-const int PWM_FREQ = 20000;        // 頻率 (Hz)
-const int PWM_RESOLUTION = 8;      // 解析度 8-bit (0-255)
-const int PWM_MAX = 255;           // PWM 訊號最大值 (2^8 - 1)
-
-// PWM 通道 (用於 DRV8833 的四個輸入腳)
-const int LEDC_CH_A1 = 0;          // 馬達 T (速度) - AIN1
-const int LEDC_CH_A2 = 1;          // 馬達 T (速度) - AIN2
-const int LEDC_CH_B1 = 2;          // 馬達 S (轉向) - BIN1
-const int LEDC_CH_B2 = 3;          // 馬達 S (轉向) - BIN2
-
-// --- 馬達 Ramping 核心變數 ---
-volatile int targetSpeedT = 0;     // 速度馬達的目標速度 (-255 到 255)
-volatile int currentSpeedT = 0;    // 速度馬達的實際輸出速度 (-255 到 255)
-volatile int targetSpeedS = 0;     // 轉向馬達的目標速度 (-255 到 255)
-volatile int currentSpeedS = 0;    // 轉向馬達的實際輸出速度 (-255 到 255)
-
-// --- 速度過渡配置 ---
-const int RAMP_INTERVAL_MS = 10;    // 每 10ms 檢查一次 PWM 速度
-unsigned long lastRampTime = 0;
-
-// --- T 馬達 (速度/Throttle) Ramping 參數 ---
-// PWM_EFFECTIVE_LIMIT_T: 限制速度馬達的最高輸出 PWM。
-const int PWM_EFFECTIVE_LIMIT_T = 200; 
-// RAMP_ACCEL_STEP_T: 速度馬達的加速步長 (越小越平穩，越能保護電源)
-const int RAMP_ACCEL_STEP_T = 5; 
-// PWM_START_KICK_T: 速度馬達的啟動推力 (128 = 約 50% PWM)
-const int PWM_START_KICK_T = 128;
-
-// --- S 馬達 (轉向/Steering) Ramping 參數 ---
-// PWM_EFFECTIVE_LIMIT_S: 限制轉向馬達的最高輸出 PWM。
-const int PWM_EFFECTIVE_LIMIT_S = 250; 
-// RAMP_ACCEL_STEP_S: 轉向馬達的加速步長 (越大越靈敏)
-const int RAMP_ACCEL_STEP_S = 20; 
-// PWM_START_KICK_S: 轉向馬達的啟動推力 (150 = 約 59% PWM, 略高於速度馬達以提高靈敏度)
-const int PWM_START_KICK_S = 150;
-
-
-// --- HTML 網頁內容 (內嵌虛擬搖桿) ---
-const char* HTML_CONTENT = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>ESP32 馬達搖桿控制</title>
-    <script src="https://cdn.tailwindcss.com"></script>
-    <style>
-        /* 確保全螢幕高度和柔軟的背景色 */
-        body { 
-            background-color: #1f2937; 
-            color: #f9fafb; 
-            font-family: ui-sans-serif, system-ui, -apple-system, BlinkMacSystemFont, "Segoe UI", Roboto, "Helvetica Neue", Arial, "Noto Sans", sans-serif;
-            display: flex; 
-            justify-content: center; 
-            align-items: center; 
-            min-height: 100vh; 
-            margin: 0; 
-            padding: 1rem;
-        }
-        .container { 
-            max-width: 400px; 
-            width: 100%; 
-            padding: 20px; 
-        }
-        /* 搖桿圓盤樣式 */
-        #joystick { 
-            position: relative; 
-            width: 100%;
-            padding-top: 100%; /* 1:1 比例 */
-            margin: 0 auto; 
-            border-radius: 50%; 
-            background: linear-gradient(145deg, #2d3748, #1a202c); 
-            box-shadow: 10px 10px 20px #171d26, -10px -10px 20px #273142, inset 0 0 10px rgba(0,0,0,0.5);
-            touch-action: none; /* 禁用瀏覽器預設的觸摸行為 */
-        }
-        /* 實際可拖曳區域 (內縮 5% 讓邊緣有陰影效果) */
-        #joystick-inner {
-            position: absolute;
-            top: 5%; left: 5%; right: 5%; bottom: 5%;
-            width: 90%;
-            height: 90%;
-        }
-        /* 搖桿中心點 (Thumb) */
-        #joystick-thumb {
-            position: absolute;
-            width: 70px; 
-            height: 70px;
-            top: 50%;
-            left: 50%;
-            transform: translate(-50%, -50%);
-            border-radius: 50%;
-            background: #4f46e5;
-            box-shadow: 0 0 15px #4f46e5, inset 0 0 10px #7c3aed;
-            cursor: grab;
-            transition: box-shadow 0.1s;
-        }
-        #joystick-thumb.active { cursor: grabbing; box-shadow: 0 0 25px #7c3aed, inset 0 0 15px #4f46e5; }
-        /* 狀態文字 */
-        #status { font-weight: 700; text-shadow: 0 0 5px rgba(79, 70, 229, 0.5); }
-    </style>
-</head>
-<body class="p-4">
-    <div class="container bg-gray-800 rounded-xl shadow-2xl">
-        <h1 class="text-3xl font-extrabold text-center text-indigo-400 mb-2">Vibe Racer</h1>
-        <p class="text-center text-sm mb-6 text-gray-400">
-            裝置名稱: <span id="hostname">%HOSTNAME%</span><br>
-            IP: <span id="ipaddress">%IPADDRESS%</span>
-        </p>
-
-        <!-- 搖桿區域 -->
-        <div id="joystick" class="mb-6">
-            <div id="joystick-inner">
-                 <div id="joystick-thumb"></div>
-            </div>
-        </div>
-
-        <!-- 狀態顯示區 -->
-        <div class="text-center space-y-2">
-            <p class="text-xl">狀態: <span id="status" class="text-green-400">靜止</span></p>
-            <p class="text-xs text-gray-500">
-                X (轉向): <span id="val_x">0</span> | Y (速度): <span id="val_y">0</span>
-            </p>
-        </div>
-    </div>
-
-    <script>
-        const joystickContainer = document.getElementById('joystick'); 
-        const joystick = document.getElementById('joystick-inner'); 
-        const thumb = document.getElementById('joystick-thumb');
-        const statusEl = document.getElementById('status');
-        const valXEl = document.getElementById('val_x');
-        const valYEl = document.getElementById('val_y');
-        
-        // Deadzone 設定 (PWM 值，範圍 0-255)
-        const DEADZONE_PWM = 20; 
-
-        // maxRadius 是實際拖曳區域 (joystick-inner) 的半徑
-        const maxRadius = joystick.clientWidth / 2;
-        let isDragging = false;
-        let controlInterval;
-        let lastMotorT = 0; // 上次發送的 T 馬達速度
-        let lastMotorS = 0; // 上次發送的 S 馬達速度
-
-        // 檢查當前 IP，用於 AP 模式下的絕對路徑
-        const currentIP = document.getElementById('ipaddress').textContent;
-        const baseIp = currentIP.startsWith('192.168.4.1') ? 'http://192.168.4.1' : '';
-        
-        /**
-         * @brief 根據搖桿位置 (Cartesian 座標) 計算並發送馬達速度。
-         * @param rawX X 軸位移 (Cartesian: 右為正)
-         * @param rawY Y 軸位移 (Cartesian: 上為正)
-         */
-        function updateMotorValues(rawX, rawY) {
-            
-            // 1. 計算幅度和角度
-            const distance = Math.sqrt(rawX*rawX + rawY*rawY);
-            const magnitude = Math.min(1.0, distance / maxRadius);
-            const angle = Math.atan2(rawY, rawX);
-            
-            // 2. 計算歸一化後的 X, Y (範圍 -1.0 到 1.0)
-            const normX = magnitude * Math.cos(angle); // 轉向 (Steering)
-            const normY = magnitude * Math.sin(angle); // 速度 (Throttle)
-
-            // 3. 轉換為 -255 到 255 的整數 (注意：ESP32 端會將 255 限制為 230)
-            let speedT = Math.round(normY * 255);
-            let speedS = Math.round(normX * 255);
-
-            // --- 4. 關鍵：在 Web 端實作 Deadzone 邏輯 ---
-            if (Math.abs(speedT) < DEADZONE_PWM) {
-                speedT = 0;
-            }
-            if (Math.abs(speedS) < DEADZONE_PWM) {
-                speedS = 0;
-            }
-            // ----------------------------------------------------
-
-            // 更新顯示
-            valYEl.textContent = speedT; // 顯示 T 馬達 (速度)
-            valXEl.textContent = speedS; // 顯示 S 馬達 (轉向)
-            
-            // 更新狀態文字和顏色
-            let currentStatus = "靜止";
-            let statusColor = "text-green-400";
-            if (Math.abs(speedT) > 0 || Math.abs(speedS) > 0) {
-                 statusColor = "text-yellow-400";
-                 if (speedT > 50 && Math.abs(speedS) < 50) currentStatus = "前進加速中";
-                 else if (speedT < -50 && Math.abs(speedS) < 50) currentStatus = "後退減速中";
-                 else if (speedS > 50) currentStatus = "右轉中";
-                 else if (speedS < -50) currentStatus = "左轉中";
-                 else currentStatus = "移動中";
-            } else {
-                 statusColor = "text-green-400";
-            }
-            statusEl.textContent = currentStatus;
-            statusEl.className = statusColor;
-
-            // 如果數值有變化，發送控制請求
-            if (speedT !== lastMotorT || speedS !== lastMotorS) {
-                lastMotorT = speedT;
-                lastMotorS = speedS;
-                // 發送 T 馬達速度 (t) 和 S 馬達速度 (s)
-                sendControl(speedT, speedS); 
-            }
-        }
-
-        function sendControl(T, S) {
-            // 使用非同步請求發送馬達速度
-            fetch(`${baseIp}/control?t=${T}&s=${S}`, { method: 'GET' })
-                .then(response => {
-                    if (!response.ok) {
-                        console.error('Server responded with an error:', response.status);
-                    }
-                })
-                .catch(error => {
-                    // console.error('Control command failed:', error);
-                });
-        }
-
-        function resetThumbPosition() {
-            thumb.style.left = '50%';
-            thumb.style.top = '50%';
-            thumb.style.transform = 'translate(-50%, -50%)';
-            thumb.classList.remove('active');
-        }
-
-        function stopMotors() {
-            isDragging = false;
-            if (controlInterval) clearInterval(controlInterval);
-            resetThumbPosition();
-            // 發送 T=0, S=0，觸發 ESP32 端的即時停止
-            updateMotorValues(0, 0); 
-        }
-
-        function handleMove(e) {
-            e.preventDefault();
-            if (!isDragging) return;
-
-            // 取得觸摸或滑鼠位置
-            const clientX = e.touches ? e.touches[0].clientX : e.clientX;
-            const clientY = e.touches ? e.touches[0].clientY : e.clientY;
-
-            // 取得搖桿容器 (joystick-inner) 的位置
-            const rect = joystick.getBoundingClientRect();
-            const centerX = rect.left + maxRadius;
-            const centerY = rect.top + maxRadius;
-
-            // 1. 原始位移 (CSS 座標: X 向右為正, Y 向下為正)
-            let offsetX = clientX - centerX;
-            let offsetY = clientY - centerY; 
-            
-            // 2. 限制位移在搖桿圓盤內
-            const distance = Math.sqrt(offsetX * offsetX + offsetY * offsetY);
-            if (distance > maxRadius) {
-                const angle = Math.atan2(offsetY, offsetX);
-                offsetX = maxRadius * Math.cos(angle);
-                offsetY = maxRadius * Math.sin(angle);
-            }
-            
-            // 3. 更新搖桿中心點位置 (使用 CSS 座標)
-            const thumbX = maxRadius + offsetX;
-            const thumbY = maxRadius + offsetY; 
-
-            thumb.style.left = `${thumbX}px`;
-            thumb.style.top = `${thumbY}px`;
-            thumb.style.transform = 'translate(-50%, -50%)';
-
-            // 4. 更新馬達值 (使用 Cartesian 座標: Y 軸向上為正)
-            // 將 CSS Y 軸反轉: -offsetY
-            updateMotorValues(offsetX, -offsetY);
-        }
-
-        function handleStart(e) {
-            isDragging = true;
-            thumb.classList.add('active');
-            handleMove(e); // 立即更新一次位置和值
-
-            // 設置間隔發送，確保命令持續性
-            if (controlInterval) clearInterval(controlInterval);
-            controlInterval = setInterval(() => {
-                // 重新讀取上次計算的值並發送，確保命令持續性
-                sendControl(lastMotorT, lastMotorS);
-            }, 100); // 每 100ms 發送一次
-        }
-
-        function handleEnd() {
-            stopMotors();
-        }
-
-        // --- 事件監聽 ---
-        joystick.addEventListener('mousedown', handleStart);
-        document.addEventListener('mousemove', handleMove);
-        document.addEventListener('mouseup', handleEnd);
-
-        joystick.addEventListener('touchstart', handleStart);
-        document.addEventListener('touchmove', handleMove);
-        // 觸摸結束可能在搖桿外，監聽大容器確保停止命令發出
-        joystickContainer.addEventListener('touchend', handleEnd); 
-
-        // 初始化時發送一次停止命令
-        stopMotors(); 
-    </script>
-</body>
-</html>
-)rawliteral";
-
 // 產生基於 MAC 位址的 Hostname ---
 void generateHostname() {    
     globalHostname = "esp32c3-" + WiFi.macAddress(); 
@@ -332,155 +38,222 @@ void generateHostname() {
     Serial.printf("Generated Hostname: %s\n", globalHostname.c_str());
 }
 
-// --- 輔助函數: 實際寫入 PWM 值 ---
-void setMotorPwm(int speedT, int speedS) {
-    // T 馬達 (速度)
-    if (speedT > 0) { 
-        // Forward
-        ledcWrite(LEDC_CH_A1, speedT);
-        ledcWrite(LEDC_CH_A2, 0);
-    } else if (speedT < 0) { 
-        // Reverse
-        ledcWrite(LEDC_CH_A1, 0);
-        ledcWrite(LEDC_CH_A2, -speedT); 
-    } else { 
-        // STOP: Coast mode (IN1=LOW, IN2=LOW)
-        ledcWrite(LEDC_CH_A1, 0);
-        ledcWrite(LEDC_CH_A2, 0);
+// --- Web Server 處理函式 (Async 版本) ---
+void handleRoot(AsyncWebServerRequest *request) {
+    metrics.rootRequests++;
+
+    String html = HTML_CONTENT; 
+    // 根據當前模式顯示正確的 IP 位址
+    String ipAddress = WiFi.getMode() == WIFI_MODE_AP ? WiFi.softAPIP().toString() : WiFi.localIP().toString();
+    
+    html.replace("%HOSTNAME%", globalHostname);
+    html.replace("%IPADDRESS%", ipAddress);
+
+    request->send(200, "text/html", html);
+}
+
+void handleControl(AsyncWebServerRequest *request) {
+    // 直接走訪已解析的參數，用索引存取並在原始位元組上解析數值，
+    // 避免 hasParam()/arg() 在最常被呼叫的端點上建立暫存 String
+    ControlQuery query = {};
+    bool valid = true;
+    size_t count = request->params();
+    for (size_t i = 0; i < count && valid; i++) {
+        const AsyncWebParameter *p = request->getParam(i);
+        if (p->isPost() || p->isFile()) continue;
+        const String &name = p->name();
+        const String &value = p->value();
+        valid = controlQueryField(query, name.c_str(), name.length(), value.c_str(), value.length());
     }
 
-    // S 馬達 (轉向)
-    if (speedS > 0) { // 正值: 右轉 (BIN1 LOW, BIN2 HIGH)
-        ledcWrite(LEDC_CH_B1, 0);
-        ledcWrite(LEDC_CH_B2, speedS);
-    } else if (speedS < 0) { // 負值: 左轉 (BIN1 HIGH, BIN2 LOW)
-        ledcWrite(LEDC_CH_B1, -speedS); 
-        ledcWrite(LEDC_CH_B2, 0);
-    } else { 
-        // STOP: Coast mode (IN1=LOW, IN2=LOW)
-        ledcWrite(LEDC_CH_B1, 0);
-        ledcWrite(LEDC_CH_B2, 0);
+    // 序號較舊的命令同樣回覆成功 (客戶端無需重送)
+    if (controlEndpointApply(query, valid, millis()) == CONTROL_REJECTED) {
+        request->send(400, "text/plain", "Invalid arguments (Missing or malformed t/s)");
+        return;
     }
+    request->send(new ControlAckResponse(&server));
 }
 
+// 緊急停止: 在 Web Server 任務中直接歸零輸出，不經過 /control 與 Ramping
+void handleEstop(AsyncWebServerRequest *request) {
+    motorEmergencyStop("http", micros());
+    request->send(new ControlAckResponse(&server));
+}
 
-// --- 定時馬達 Ramping 任務 (T 和 S 獨立參數) ---
-void motorRampTask() {
-    if (millis() - lastRampTime < RAMP_INTERVAL_MS) return;
-    lastRampTime = millis();
-    
-    // ------------------------------------------------------------------
-    // 速度馬達 (T Motor) 邏輯
-    // ------------------------------------------------------------------
-    if (targetSpeedT == 0) {
-        // 優化修正：當目標為 0 時，強制當前速度立即為 0
-        currentSpeedT = 0; 
-    } else {
-        // 目標不為 0 (加速或減速到新的非零目標)
-
-        // *** 啟動推力邏輯 (Kick Start) ***
-        if (currentSpeedT == 0) {
-            // 如果當前速度為 0，且目標速度非 0，則跳轉到 PWM_START_KICK_T
-            if (targetSpeedT > 0) {
-                currentSpeedT = PWM_START_KICK_T;
-            } else {
-                currentSpeedT = -PWM_START_KICK_T;
-            }
-        }
-        
-        // 確保 Kick Start 後的速度不會超過目標速度
-        if (abs(currentSpeedT) > abs(targetSpeedT)) {
-             currentSpeedT = targetSpeedT;
-        }
+void handleArm(AsyncWebServerRequest *request) {
+    motorRearm();
+    request->send(new ControlAckResponse(&server));
+}
 
-        // *** 繼續 Ramping 邏輯 ***
-        if (abs(targetSpeedT - currentSpeedT) > RAMP_ACCEL_STEP_T) {
-            if (targetSpeedT > currentSpeedT) {
-                // 平穩加速
-                currentSpeedT += RAMP_ACCEL_STEP_T;
-            } else {
-                // 平穩減速 
-                currentSpeedT -= RAMP_ACCEL_STEP_T;
-            }
-        } else {
-            // 距離目標值很近，直接設定為目標值
-            currentSpeedT = targetSpeedT;
-        }
+// 切換輸入整形 profile: /shape?p=linear|standard|smooth|precise
+void handleShape(AsyncWebServerRequest *request) {
+    const AsyncWebParameter *p = request->getParam("p");
+    if (p == nullptr || !inputShapingSelectByName(p->value().c_str(), p->value().length())) {
+        request->send(400, "text/plain", "Invalid arguments (p must be linear, standard, smooth or precise)");
+        return;
+    }
+    halLog("輸入整形 profile: %s\n", inputShapingProfileName(inputShapingProfile()));
+    request->send(204);
+}
+
+// 切換驅動混控模式: /mix?m=passthrough|arcade|tank
+void handleMix(AsyncWebServerRequest *request) {
+    const AsyncWebParameter *m = request->getParam("m");
+    if (m == nullptr || !mixerSelectByName(m->value().c_str(), m->value().length())) {
+        request->send(400, "text/plain", "Invalid arguments (m must be passthrough, arcade or tank)");
+        return;
     }
+    halLog("驅動混控模式: %s\n", mixerModeName(mixerMode()));
+    request->send(204);
+}
 
-    // ------------------------------------------------------------------
-    // 轉向馬達 (S Motor) 邏輯 (使用更激進的參數)
-    // ------------------------------------------------------------------
-    if (targetSpeedS == 0) {
-        // 優化修正：當目標為 0 時，強制當前速度立即為 0
-        currentSpeedS = 0; 
+// 駕駛紀錄: /record?a=start|stop|replay (開始錄製只在馬達停止時接受)
+void handleRecord(AsyncWebServerRequest *request) {
+    const AsyncWebParameter *action = request->getParam("a");
+    if (action == nullptr) {
+        request->send(400, "text/plain", "Invalid arguments (Missing a)");
+        return;
+    }
+    const String &a = action->value();
+    SessionAction requested;
+    if (a == "start") {
+        requested = SESSION_ACTION_RECORD;
+    } else if (a == "replay") {
+        requested = SESSION_ACTION_REPLAY;
+    } else if (a == "stop") {
+        requested = SESSION_ACTION_STOP;
     } else {
-        // 目標不為 0 (轉向加速/減速)
-        
-        // *** 啟動推力邏輯 (Kick Start) ***
-        if (currentSpeedS == 0) {
-            // 如果當前速度為 0，且目標速度非 0，則跳轉到 PWM_START_KICK_S
-            if (targetSpeedS > 0) {
-                currentSpeedS = PWM_START_KICK_S;
-            } else {
-                currentSpeedS = -PWM_START_KICK_S;
-            }
-        }
+        request->send(400, "text/plain", "Invalid arguments (a must be start, stop or replay)");
+        return;
+    }
+    if ((requested == SESSION_ACTION_RECORD && !motorIdle()) || !sessionRequest(requested)) {
+        request->send(409, "text/plain", "Recorder busy, unavailable or motors running");
+        return;
+    }
+    request->send(204);
+}
 
-        // 確保 Kick Start 後的速度不會超過目標速度
-        if (abs(currentSpeedS) > abs(targetSpeedS)) {
-             currentSpeedS = targetSpeedS;
+// 最低有效 duty 校正: /calibrate?m=t|s&a=start|mark|cancel
+void handleCalibrate(AsyncWebServerRequest *request) {
+    const AsyncWebParameter *action = request->getParam("a");
+    if (action == nullptr) {
+        request->send(400, "text/plain", "Invalid arguments (Missing a)");
+        return;
+    }
+    const String &a = action->value();
+    if (a == "start") {
+        const AsyncWebParameter *motor = request->getParam("m");
+        if (motor == nullptr || (motor->value() != "t" && motor->value() != "s")) {
+            request->send(400, "text/plain", "Invalid arguments (m must be t or s)");
+            return;
         }
-
-        // *** 繼續 Ramping 邏輯 ***
-        if (abs(targetSpeedS - currentSpeedS) > RAMP_ACCEL_STEP_S) {
-             if (targetSpeedS > currentSpeedS) {
-                currentSpeedS += RAMP_ACCEL_STEP_S;
-            } else {
-                currentSpeedS -= RAMP_ACCEL_STEP_S;
-            }
-        } else {
-            // 距離目標值很近，直接設定為目標值
-            currentSpeedS = targetSpeedS;
+        motorCalibrateStart(motor->value() == "t" ? MOTOR_T : MOTOR_S);
+    } else if (a == "mark") {
+        MotorConfigResult result;
+        if (!motorCalibrateMark(&result)) {
+            request->send(409, "text/plain", "Calibration not running");
+            return;
         }
+        if (result == MOTOR_CONFIG_INVALID) {
+            request->send(422, "text/plain", "Measured duty out of range (not applied)");
+            return;
+        }
+        if (result == MOTOR_CONFIG_NOT_SAVED) {
+            request->send(500, "text/plain", "Calibration applied but not saved to NVS");
+            return;
+        }
+    } else if (a == "cancel") {
+        motorCalibrateCancel();
+    } else {
+        request->send(400, "text/plain", "Invalid arguments (a must be start, mark or cancel)");
+        return;
     }
+    request->send(204);
+}
 
-    // 實際寫入 PWM
-    setMotorPwm(currentSpeedT, currentSpeedS); 
-    
-    // Serial.printf("Ramp: T(Curr/Targ)=%d/%d, S(Curr/Targ)=%d/%d\n", 
-    //               currentSpeedT, targetSpeedT, currentSpeedS, targetSpeedS);
+void handleMetrics(AsyncWebServerRequest *request) {
+    // 在固定緩衝區格式化，回應直接從緩衝區讀取而不複製成 String
+    // (handler 都在 Web Server 任務中依序執行，且不佔用該任務的堆疊)。
+    // 函式庫仍會配置回應物件與送出時的暫存區，送完即釋放，不會累積在 heap 統計中。
+    // 本文 (< 3 KB) 通常在 _respond 中一次寫入 TCP 送出緩衝區；緩衝區不足時其餘部分在 ACK 後才讀取，
+    // 若其間又收到 /metrics，後半段會是較新的統計 (只影響該次讀值的一致性)
+    static char json[3072];
+    size_t len = metricsFormatJson(json, sizeof(json));
+    request->send(request->beginResponse_P(200, "application/json", (const uint8_t *)json, len));
 }
 
-// --- Web Server 處理函式 (Async 版本) ---
-void handleRoot(AsyncWebServerRequest *request) {
-    
-    String html = HTML_CONTENT; 
-    // 根據當前模式顯示正確的 IP 位址
-    String ipAddress = WiFi.getMode() == WIFI_MODE_AP ? WiFi.softAPIP().toString() : WiFi.localIP().toString();
-    
-    html.replace("%HOSTNAME%", globalHostname);
-    html.replace("%IPADDRESS%", ipAddress);
+// --- 馬達參數 /config ---
+// GET 回傳目前設定的 JSON；帶查詢參數 (例如 /config?profile=race&step_t=8) 或
+// POST 扁平 JSON 物件時，依序套用到目前設定的副本，全部有效才公開並存入 NVS。
+const size_t CONFIG_BODY_MAX = 512;
+static char configBody[CONFIG_BODY_MAX];
+static size_t configBodyLen = 0;
+static bool configBodyOverflow = false;
+
+// POST 的本文可能分段抵達，先收集到固定緩衝區 (Web Server 任務依序處理，不需要鎖)
+void handleConfigBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    if (index == 0) {
+        configBodyLen = 0;
+        configBodyOverflow = total > CONFIG_BODY_MAX;
+    }
+    if (configBodyOverflow || index + len > CONFIG_BODY_MAX) {
+        configBodyOverflow = true;
+        return;
+    }
+    memcpy(configBody + index, data, len);
+    configBodyLen = index + len;
+}
 
-    request->send(200, "text/html", html);
+void handleConfig(AsyncWebServerRequest *request) {
+    MotorConfig config;
+    uint32_t version;
+    motorConfigSnapshot(config, version);
+
+    bool valid = true;
+    bool changed = false;
+    if (request->method() == HTTP_POST) {
+        valid = !configBodyOverflow && motorConfigParseJson(config, configBody, configBodyLen);
+        configBodyLen = 0;
+        changed = true;
+    }
+    size_t count = request->params();
+    for (size_t i = 0; i < count && valid; i++) {
+        const AsyncWebParameter *p = request->getParam(i);
+        if (p->isPost() || p->isFile()) continue;
+        const String &name = p->name();
+        const String &value = p->value();
+        valid = motorConfigField(config, name.c_str(), name.length(), value.c_str(), value.length());
+        changed = true;
+    }
+
+    MotorConfigResult result = valid && changed ? motorConfigPublish(config, true) : MOTOR_CONFIG_APPLIED;
+    if (!valid || result == MOTOR_CONFIG_INVALID) {
+        request->send(400, "text/plain",
+                      "Invalid config (unknown field, value out of range, or profile not default/indoor/race)");
+        return;
+    }
+    if (result == MOTOR_CONFIG_NOT_SAVED) {
+        request->send(500, "text/plain", "Config applied but not saved to NVS");
+        return;
+    }
+    if (changed) halLog("馬達參數已更新 (profile: %s)\n", config.profile);
+
+    static char json[768];
+    motorConfigFormatJson(json, sizeof(json));
+    request->send(200, "application/json", json);
 }
 
-void handleControl(AsyncWebServerRequest *request) {
-    if (request->hasParam("t") && request->hasParam("s")) {
-        
-        // 讀取原始搖桿輸入
-        int rawT = request->arg("t").toInt();
-        int rawS = request->arg("s").toInt();
-        
-        // *** 關鍵修正：將目標速度分別約束在 T 和 S 的有效限制內 ***
-        targetSpeedT = constrain(rawT, -PWM_EFFECTIVE_LIMIT_T, PWM_EFFECTIVE_LIMIT_T); 
-        targetSpeedS = constrain(rawS, -PWM_EFFECTIVE_LIMIT_S, PWM_EFFECTIVE_LIMIT_S);
-
-        Serial.printf("WebControl (Target): T馬達(速度)=%d, S馬達(轉向)=%d\n", targetSpeedT, targetSpeedS);        
-        request->send(200, "text/plain", "OK"); 
-    } else {
-        request->send(400, "text/plain", "Invalid arguments (Missing t or s)");
+// 設定 playout 緩衝延遲: /playout?d=30 (毫秒，0 = 關閉)
+void handlePlayout(AsyncWebServerRequest *request) {
+    int delayMs = 0;
+    const AsyncWebParameter *p = request->getParam("d");
+    if (p == nullptr || !parseSaturatedInt(p->value().c_str(), p->value().length(), &delayMs)) {
+        request->send(400, "text/plain", "Invalid arguments (Missing or malformed d)");
+        return;
     }
+    jitterBufferSetDelay(delayMs);
+    halLog("Playout 緩衝延遲設定為 %d ms\n", jitterBufferStats().delayMs);
+    request->send(204);
 }
 
 void setupWebServer() {
@@ -492,8 +265,35 @@ void setupWebServer() {
     // 處理馬達控制 API 請求
     server.on("/control", HTTP_GET, handleControl);
 
+    // 緊急停止 (鎖定) 與解除鎖定
+    server.on("/estop", HTTP_ANY, handleEstop);
+    server.on("/arm", HTTP_ANY, handleArm);
+
+    // 搖桿輸入整形 profile
+    server.on("/shape", HTTP_GET, handleShape);
+
+    // 驅動混控模式 (Ackermann / 滑移轉向)
+    server.on("/mix", HTTP_GET, handleMix);
+
+    // 駕駛紀錄錄製與重播
+    server.on("/record", HTTP_GET, handleRecord);
+
+    // 最低有效 duty 校正程序
+    server.on("/calibrate", HTTP_GET, handleCalibrate);
+
+    // 執行期統計 (heap、請求數、Ramping 時間)，供壓力測試時觀察裝置狀態
+    server.on("/metrics", HTTP_GET, handleMetrics);
+
+    // 執行期調整馬達參數 (不需重新燒錄)
+    server.on("/config", HTTP_GET, handleConfig);
+    server.on("/config", HTTP_POST, handleConfig, nullptr, handleConfigBody);
+
+    // 設定值 playout 緩衝 (吸收 Wi-Fi 傳遞抖動)
+    server.on("/playout", HTTP_GET, handlePlayout);
+
     // 處理所有未定義的請求 (選用)
     server.onNotFound([](AsyncWebServerRequest *request){
+        metrics.notFound++;
         request->send(404, "text/plain", "Not Found");
     });
 
@@ -567,29 +367,28 @@ void connectToWiFi() {
 
 }
 
+// --- 序列埠命令 ---
+// '!' 立即觸發緊急停止，'~' 解除鎖定 (單一字元，不需要換行)
+void serialCommandTask() {
+    while (Serial.available() > 0) {
+        unsigned long arrivalUs = micros();
+        int c = Serial.read();
+        if (c == '!') {
+            motorEmergencyStop("serial", arrivalUs);
+        } else if (c == '~') {
+            motorRearm();
+        }
+    }
+}
+
 // --- Setup ---
 void setup() {
     Serial.begin(115200);
     delay(1000);
 
-    // --- 初始化馬達控制腳位 (DRV8833) ---
-    pinMode(NSLEEP_PIN, OUTPUT);
-    digitalWrite(NSLEEP_PIN, HIGH); 
-    Serial.printf("馬達驅動 (nSLEEP) 已致能於 GPIO%d\n", NSLEEP_PIN);
-
-    // PWM 設定
-    ledcSetup(LEDC_CH_A1, PWM_FREQ, PWM_RESOLUTION);
-    ledcSetup(LEDC_CH_A2, PWM_FREQ, PWM_RESOLUTION);
-    ledcSetup(LEDC_CH_B1, PWM_FREQ, PWM_RESOLUTION);
-    ledcSetup(LEDC_CH_B2, PWM_FREQ, PWM_RESOLUTION);
-
-    // PWM 腳位連接
-    ledcAttachPin(AIN1_PIN, LEDC_CH_A1);
-    ledcAttachPin(AIN2_PIN, LEDC_CH_A2);
-    ledcAttachPin(BIN1_PIN, LEDC_CH_B1);
-    ledcAttachPin(BIN2_PIN, LEDC_CH_B2);
-
-    setMotorPwm(0, 0); // 確保馬達啟動時靜止
+    // --- 初始化馬達控制腳位 (DRV8833) 與 PWM ---
+    motorInit();
+    Serial.println("序列埠命令: '!' 緊急停止, '~' 解除鎖定");
     
     // --- 啟動器核心邏輯 ---
     wm = new ESPAsync_WiFiManager(&server, &dns, "ESP32-Setup");
@@ -622,8 +421,17 @@ void setup() {
 void loop() {
     // 由於使用了 AsyncWebServer，我們只需要處理 OTA
     ArduinoOTA.handle();
+    // 序列埠的緊急停止命令優先處理
+    serialCommandTask();
+    // playout 緩衝啟用時，依原始取樣間隔把設定值送進 Ramping 引擎
+    int playoutT, playoutS;
+    if (jitterBufferPlayout(millis(), &playoutT, &playoutS)) {
+        motorSetTarget(playoutT, playoutS);
+    }
     // *** 關鍵：定時執行馬達 Ramping 任務 ***
     motorRampTask();
+    // 駕駛紀錄的 flash 寫入與預讀 (不在 Ramping tick 中進行)
+    sessionService(motorIdle());
     // AsyncWebServer 在內部 FreeRTOS 任務中運行，無需 server.handleClient()
     yield();
 }
@@ -0,0 +1,100 @@
+// --- 執行期統計 ---
+#include <stdarg.h>
+#include <stdio.h>
+#include "hal.h"
+#include "metrics.h"
+#include "motor_control.h"
+#include "jitter_buffer.h"
+#include "link_supervisor.h"
+#include "input_shaping.h"
+#include "drive_mixer.h"
+#include "session_recorder.h"
+#include "imu_gyro.h"
+#include "wheel_encoder.h"
+#include "current_sense.h"
+#include "battery_monitor.h"
+#include "thermal_model.h"
+
+Metrics metrics = {};
+
+// 接在 buf[used] 之後輸出，空間不足時截斷；回傳新的長度
+static size_t append(char *buf, size_t len, size_t used, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + used, len - used, fmt, args);
+    va_end(args);
+    if (n < 0) return used;
+    return used + ((size_t)n < len - used ? (size_t)n : len - used - 1);
+}
+
+size_t metricsFormatJson(char *buf, size_t len) {
+    JitterBufferStats playout = jitterBufferStats();
+    const CurrentChannel &currentT = currentSenseChannel(MOTOR_T);
+    const CurrentChannel &currentS = currentSenseChannel(MOTOR_S);
+    const BatteryState &battery = batteryMonitorState();
+    const SessionStats &session = sessionStats();
+    int n = snprintf(buf, len,
+        "{\"uptime_ms\":%lu,\"shape\":\"%s\",\"mix\":\"%s\","
+        "\"heap\":{\"free\":%lu,\"min_free\":%lu,\"max_block\":%lu},"
+        "\"requests\":{\"root\":%lu,\"control\":%lu,\"control_rejected\":%lu,\"control_stale\":%lu,\"not_found\":%lu},"
+        "\"control_ack_bytes\":%lu,"
+        "\"playout\":{\"delay_ms\":%d,\"depth\":%d,\"underruns\":%lu,\"overflows\":%lu,\"late\":%lu},"
+        "\"link\":{\"degraded\":%d,\"losses\":%lu},"
+        "\"speed_loop\":{\"encoder\":%d,\"wheel_pps\":%lu,\"glitches\":%lu},"
+        "\"current\":{\"sensed\":%d,\"t_avg_ma\":%d,\"t_peak_ma\":%d,\"t_scale\":%d,\"t_limited\":%lu,"
+        "\"s_avg_ma\":%d,\"s_peak_ma\":%d,\"s_scale\":%d,\"s_limited\":%lu},"
+        "\"battery\":{\"sensed\":%d,\"mv\":%d,\"min_mv\":%d,\"comp_scale\":%d,\"kick_scale\":%d,"
+        "\"sag_events\":%lu,\"used_mwh\":%lu,\"remaining_pct\":%d},"
+        "\"session\":{\"state\":\"%s\",\"bytes\":%lu,\"records\":%lu,\"overruns\":%lu},"
+        "\"thermal\":{\"t_c\":%d,\"s_c\":%d,\"driver_c\":%d,\"t_derate\":%d,\"s_derate\":%d},"
+        "\"estop\":{\"latched\":%d,\"count\":%lu,\"source\":\"%s\",\"last_latency_us\":%lu,\"max_latency_us\":%lu},",
+        halMillis(), inputShapingProfileName(inputShapingProfile()), mixerModeName(mixerMode()),
+        (unsigned long)halHeapFree(), (unsigned long)halHeapMinFree(), (unsigned long)halHeapMaxBlock(),
+        (unsigned long)metrics.rootRequests, (unsigned long)metrics.controlRequests,
+        (unsigned long)metrics.controlRejected, (unsigned long)metrics.controlStale,
+        (unsigned long)metrics.notFound,
+        (unsigned long)metrics.controlAckBytes,
+        playout.delayMs, playout.depth, (unsigned long)playout.underruns,
+        (unsigned long)playout.overflows, (unsigned long)playout.late,
+        linkSupervisorDegraded() ? 1 : 0, (unsigned long)linkSupervisorLossCount(),
+        wheelEncoderPresent() ? 1 : 0, (unsigned long)motorWheelSpeed(),
+        (unsigned long)wheelEncoderGlitchCount(),
+        currentSensePresent() ? 1 : 0,
+        currentChannelAverageMa(currentT), currentT.peakMa, currentT.scale, (unsigned long)currentT.limitedTicks,
+        currentChannelAverageMa(currentS), currentS.peakMa, currentS.scale, (unsigned long)currentS.limitedTicks,
+        batteryMonitorPresent() ? 1 : 0, batteryVoltageMv(battery), battery.minMv, battery.compScale,
+        battery.kickScale, (unsigned long)battery.sagEvents, (unsigned long)batteryUsedMwh(battery),
+        batteryRemainingPercent(battery, batteryMonitorConfig()),
+        sessionStateName(sessionState()), (unsigned long)session.bytes, (unsigned long)session.records,
+        (unsigned long)session.overruns,
+        thermalNodeTempC(thermalModelNode(THERMAL_MOTOR_T)), thermalNodeTempC(thermalModelNode(THERMAL_MOTOR_S)),
+        thermalNodeTempC(thermalModelNode(THERMAL_DRIVER)),
+        thermalDerate(THERMAL_MOTOR_T), thermalDerate(THERMAL_MOTOR_S),
+        motorEstopLatched() ? 1 : 0, estopStats.count, estopStats.lastSource,
+        estopStats.lastLatencyUs, estopStats.maxLatencyUs);
+    if (n < 0) return 0;
+    size_t used = (size_t)n < len ? (size_t)n : len - 1;
+
+    // 陀螺儀與航向保持
+    const GyroStats &gyro = gyroStats();
+    const HeadingHoldState &hold = motorHeadingHold();
+    used = append(buf, len, used,
+        "\"imu\":{\"present\":%d,\"heading_mdeg\":%ld,\"rate_mdps\":%ld,\"samples\":%lu,"
+        "\"fifo_overflows\":%lu,\"i2c_errors\":%lu,\"hold\":%d,\"trim\":%d,\"engagements\":%lu},",
+        gyroPresent() ? 1 : 0, (long)gyroHeadingMdeg(), (long)gyroYawRateMdps(), (unsigned long)gyro.samples,
+        (unsigned long)gyro.fifoOverflows, (unsigned long)gyro.i2cErrors, hold.holding ? 1 : 0, hold.trim,
+        (unsigned long)hold.engagements);
+
+    // 每個馬達通道: Ramping、輸出與端點偵測
+    used = append(buf, len, used, "\"channels\":[");
+    for (int i = 0; i < motorChannelCount(); i++) {
+        const MotorChannelState &ch = motorChannelState(i);
+        used = append(buf, len, used,
+            "%s{\"name\":\"%s\",\"target\":%d,\"current\":%d,\"output\":%d,"
+            "\"settle_last_ms\":%lu,\"settle_max_ms\":%lu,\"endstop\":%d,\"endstop_hits\":%lu}",
+            i > 0 ? "," : "", motorChannelDesc(i).name, ch.target, ch.current, ch.output,
+            ch.timing.lastSettleMs, ch.timing.maxSettleMs,
+            (int)ch.endstop.state, (unsigned long)ch.endstop.detections);
+    }
+    return append(buf, len, used, "]}");
+}
@@ -0,0 +1,331 @@
+// --- 執行期可調整的馬達參數 (NVS 保存、雙緩衝切換) ---
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+#include "motor_config.h"
+#include "control_query.h"
+#include "link_supervisor.h"
+
+static const uint16_t MOTOR_CONFIG_LAYOUT = 1;
+static const char *CONFIG_KEY = "motor_cfg";
+
+// --- "default" profile (原本的編譯期常數) ---
+const int RAMP_INTERVAL_MS = 10;    // 每 10ms 檢查一次 PWM 速度
+
+// --- T 馬達 (速度/Throttle) Ramping 參數 ---
+// PWM_EFFECTIVE_LIMIT_T: 限制速度馬達的最高輸出 PWM。
+const int PWM_EFFECTIVE_LIMIT_T = 200;
+// RAMP_ACCEL_STEP_T: 速度馬達的加速步長 (越小越平穩，越能保護電源)
+const int RAMP_ACCEL_STEP_T = 5;
+// PWM_START_KICK_T: 速度馬達的啟動推力 (128 = 約 50% PWM)
+const int PWM_START_KICK_T = 128;
+// PWM_START_KICK_MS_T: 啟動推力維持的時間 (克服靜摩擦後才開始 Ramping)
+const int PWM_START_KICK_MS_T = 40;
+// PWM_MIN_EFFECTIVE_T: 馬達開始轉動的最低 duty (預設值，可用校正程序量測並存入 NVS)
+const int PWM_MIN_EFFECTIVE_T = 50;
+
+// --- S 馬達 (轉向/Steering) Ramping 參數 ---
+// PWM_EFFECTIVE_LIMIT_S: 限制轉向馬達的最高輸出 PWM。
+const int PWM_EFFECTIVE_LIMIT_S = 250;
+// RAMP_ACCEL_STEP_S: 轉向馬達的加速步長 (越大越靈敏)
+const int RAMP_ACCEL_STEP_S = 20;
+// PWM_START_KICK_S: 轉向馬達的啟動推力 (150 = 約 59% PWM, 略高於速度馬達以提高靈敏度)
+const int PWM_START_KICK_S = 150;
+// PWM_START_KICK_MS_S: 轉向馬達啟動推力維持的時間
+const int PWM_START_KICK_MS_S = 30;
+// PWM_MIN_EFFECTIVE_S: 轉向馬達開始轉動的最低 duty (預設值，可校正)
+const int PWM_MIN_EFFECTIVE_S = 60;
+// PWM_HOLD_S: 轉向打到端點後維持的 duty (足以抵抗回正力即可)
+const int PWM_HOLD_S = 90;
+
+// 不屬於 profile 的參數的預設值
+static const MotorSystemConfig SYSTEM_DEFAULT = {
+    (int16_t)LINK_SUPERVISOR_DEFAULT.graceMs, (int16_t)LINK_SUPERVISOR_DEFAULT.decayMs,
+    (uint8_t)LINK_SUPERVISOR_DEFAULT.profile,
+    (int16_t)STEERING_SCHEDULE_DEFAULT_COUNT,
+    { STEERING_SCHEDULE_DEFAULT[0], STEERING_SCHEDULE_DEFAULT[1], STEERING_SCHEDULE_DEFAULT[2],
+      STEERING_SCHEDULE_DEFAULT[3] },
+    (int16_t)SPEED_LOOP_DEFAULT.periodMs, (int16_t)SPEED_LOOP_DEFAULT.kp, (int16_t)SPEED_LOOP_DEFAULT.ki,
+    (int16_t)SPEED_LOOP_DEFAULT.kd, (int16_t)SPEED_LOOP_DEFAULT.trimLimit, (int16_t)SPEED_LOOP_DEFAULT.fullSpeed,
+};
+
+static const MotorConfig PROFILES[] = {
+    // default: 原本的調校
+    { MOTOR_CONFIG_LAYOUT, RAMP_INTERVAL_MS,
+      { PWM_EFFECTIVE_LIMIT_T, RAMP_ACCEL_STEP_T, PWM_START_KICK_T, PWM_START_KICK_MS_T,
+        PWM_MIN_EFFECTIVE_T, (uint8_t)DECAY_DEFAULT_T.drive, (uint8_t)DECAY_DEFAULT_T.stop, 0 },
+      { PWM_EFFECTIVE_LIMIT_S, RAMP_ACCEL_STEP_S, PWM_START_KICK_S, PWM_START_KICK_MS_S,
+        PWM_MIN_EFFECTIVE_S, (uint8_t)DECAY_DEFAULT_S.drive, (uint8_t)DECAY_DEFAULT_S.stop, PWM_HOLD_S },
+      "default", SYSTEM_DEFAULT },
+    // indoor: 降低最高速度與加速度，慢衰減讓低速更好控制
+    { MOTOR_CONFIG_LAYOUT, RAMP_INTERVAL_MS,
+      { 140, 3, 110, 40, PWM_MIN_EFFECTIVE_T, DECAY_SLOW, STOP_BRAKE, 0 },
+      { 220, 12, 130, 30, PWM_MIN_EFFECTIVE_S, DECAY_FAST, STOP_COAST, PWM_HOLD_S },
+      "indoor", SYSTEM_DEFAULT },
+    // race: 全輸出、快速加速
+    { MOTOR_CONFIG_LAYOUT, RAMP_INTERVAL_MS,
+      { 255, 12, 150, 30, PWM_MIN_EFFECTIVE_T, DECAY_FAST, STOP_BRAKE, 0 },
+      { 255, 30, 170, 25, PWM_MIN_EFFECTIVE_S, DECAY_FAST, STOP_COAST, 110 },
+      "race", SYSTEM_DEFAULT },
+};
+
+static const int PROFILE_COUNT = sizeof(PROFILES) / sizeof(PROFILES[0]);
+
+// 兩個緩衝區：configVersion 的最低位元指出目前公開的是哪一個
+static MotorConfig configSlots[2] = { PROFILES[0], PROFILES[0] };
+static volatile uint32_t configVersion = 0;
+
+static bool channelValid(const MotorChannelConfig &c) {
+    return c.limit >= 1 && c.limit <= MOTOR_INPUT_MAX
+        && c.step >= 1 && c.step <= MOTOR_INPUT_MAX
+        && c.kick >= 0 && c.kick <= MOTOR_INPUT_MAX
+        && c.kickMs >= 0 && c.kickMs <= MOTOR_CONFIG_KICK_MS_MAX
+        && c.minDuty >= 0 && c.minDuty <= c.limit
+        && c.drive <= DECAY_SLOW && c.stop <= STOP_BRAKE
+        && c.holdDuty >= 0 && c.holdDuty <= c.limit;
+}
+
+static bool gainValid(int gain) {
+    return gain >= 0 && gain <= MOTOR_CONFIG_SPEED_GAIN_MAX;
+}
+
+static bool speedValid(const MotorSystemConfig &c) {
+    return c.speedPeriodMs >= 1 && c.speedPeriodMs <= MOTOR_CONFIG_INTERVAL_MAX_MS
+        && gainValid(c.speedKp) && gainValid(c.speedKi) && gainValid(c.speedKd)
+        && c.speedTrim >= 0 && c.speedTrim <= MOTOR_INPUT_MAX
+        && c.speedFull >= 1;
+}
+
+static bool configValid(const MotorConfig &config) {
+    return config.layout == MOTOR_CONFIG_LAYOUT
+        && config.rampIntervalMs >= 1 && config.rampIntervalMs <= MOTOR_CONFIG_INTERVAL_MAX_MS
+        && channelValid(config.t) && channelValid(config.s)
+        && memchr(config.profile, '\0', sizeof(config.profile)) != nullptr
+        && config.system.linkGraceMs >= 0 && config.system.linkGraceMs <= MOTOR_CONFIG_LINK_MS_MAX
+        && config.system.linkDecayMs >= 1 && config.system.linkDecayMs <= MOTOR_CONFIG_LINK_MS_MAX
+        && config.system.linkDecay <= LINK_DECAY_EXPONENTIAL
+        && steeringScheduleValid(config.system.steering, config.system.steeringPoints)
+        && speedValid(config.system);
+}
+
+void motorConfigLoad() {
+    MotorConfig config = PROFILES[0];
+    MotorConfig stored;
+    if (halStoreLoad(CONFIG_KEY, &stored, sizeof(stored)) && configValid(stored)) {
+        config = stored;
+    }
+    motorConfigPublish(config, false);
+    halLog("馬達參數 profile: %s (最低有效 duty: T=%d, S=%d)\n",
+           config.profile, config.t.minDuty, config.s.minDuty);
+}
+
+void motorConfigSnapshot(MotorConfig &out, uint32_t &version) {
+    uint32_t v;
+    do {
+        v = configVersion;
+        __sync_synchronize();
+        out = configSlots[v & 1];
+        __sync_synchronize();
+        // 複製期間寫入者已連續公開兩次時，剛才讀的緩衝區可能被覆寫，重新讀取
+    } while (configVersion != v);
+    version = v;
+}
+
+uint32_t motorConfigVersion() {
+    return configVersion;
+}
+
+MotorConfigResult motorConfigPublish(const MotorConfig &config, bool persist) {
+    if (!configValid(config)) return MOTOR_CONFIG_INVALID;
+
+    // 寫入目前未公開的緩衝區，完成後才切換版本號
+    uint32_t next = configVersion + 1;
+    configSlots[next & 1] = config;
+    __sync_synchronize();
+    configVersion = next;
+
+    if (persist && !halStoreSave(CONFIG_KEY, &config, sizeof(config))) {
+        halLog("馬達參數儲存失敗\n");
+        return MOTOR_CONFIG_NOT_SAVED;
+    }
+    return MOTOR_CONFIG_APPLIED;
+}
+
+bool motorConfigSelectProfile(MotorConfig &config, const char *name, size_t len) {
+    for (int i = 0; i < PROFILE_COUNT; i++) {
+        const MotorConfig &profile = PROFILES[i];
+        if (strlen(profile.profile) != len || memcmp(profile.profile, name, len) != 0) continue;
+
+        // 最低有效 duty 是硬體的校正結果，不隨 profile 改變；profile 只包含 Ramping 參數
+        MotorConfig previous = config;
+        config = profile;
+        config.t.minDuty = previous.t.minDuty < config.t.limit ? previous.t.minDuty : config.t.limit;
+        config.s.minDuty = previous.s.minDuty < config.s.limit ? previous.s.minDuty : config.s.limit;
+        config.system = previous.system;
+        return true;
+    }
+    return false;
+}
+
+static bool nameEquals(const char *name, size_t len, const char *literal) {
+    return strlen(literal) == len && memcmp(literal, name, len) == 0;
+}
+
+bool motorConfigField(MotorConfig &config, const char *name, size_t nameLen,
+                      const char *value, size_t valueLen) {
+    if (nameEquals(name, nameLen, "profile")) {
+        return motorConfigSelectProfile(config, value, valueLen);
+    }
+    if (nameEquals(name, nameLen, "version")) {
+        return true;    // 唯讀欄位，讓 GET 的輸出可以原樣送回
+    }
+    if (nameEquals(name, nameLen, "steering")) {
+        SteeringSchedulePoint points[STEERING_SCHEDULE_MAX_POINTS];
+        int count;
+        if (!steeringScheduleParse(value, valueLen, points, &count)) return false;
+        config.system.steeringPoints = (int16_t)count;
+        for (int i = 0; i < STEERING_SCHEDULE_MAX_POINTS; i++) {
+            SteeringSchedulePoint unused = { 0, 0, 0 };
+            config.system.steering[i] = i < count ? points[i] : unused;
+        }
+        return true;
+    }
+
+    int number;
+    if (!parseSaturatedInt(value, valueLen, &number)) return false;
+
+    if (nameEquals(name, nameLen, "ramp_interval_ms")) {
+        config.rampIntervalMs = (int16_t)number;
+        return true;
+    }
+    if (nameEquals(name, nameLen, "link_grace_ms")) {
+        config.system.linkGraceMs = (int16_t)number;
+        return true;
+    }
+    if (nameEquals(name, nameLen, "link_decay_ms")) {
+        config.system.linkDecayMs = (int16_t)number;
+        return true;
+    }
+    if (nameEquals(name, nameLen, "link_decay")) {
+        if (number != LINK_DECAY_LINEAR && number != LINK_DECAY_EXPONENTIAL) return false;
+        config.system.linkDecay = (uint8_t)number;
+        return true;
+    }
+
+    // 速度迴路
+    MotorSystemConfig &system = config.system;
+    int16_t *speedField = nameEquals(name, nameLen, "speed_period_ms") ? &system.speedPeriodMs
+                        : nameEquals(name, nameLen, "speed_kp") ? &system.speedKp
+                        : nameEquals(name, nameLen, "speed_ki") ? &system.speedKi
+                        : nameEquals(name, nameLen, "speed_kd") ? &system.speedKd
+                        : nameEquals(name, nameLen, "speed_trim") ? &system.speedTrim
+                        : nameEquals(name, nameLen, "speed_full") ? &system.speedFull : nullptr;
+    if (speedField != nullptr) {
+        *speedField = (int16_t)number;
+        return true;
+    }
+
+    // 其餘欄位以 _t / _s 結尾，指定套用的馬達
+    if (nameLen < 3 || name[nameLen - 2] != '_') return false;
+    MotorChannelConfig *channel;
+    if (name[nameLen - 1] == 't') {
+        channel = &config.t;
+    } else if (name[nameLen - 1] == 's') {
+        channel = &config.s;
+    } else {
+        return false;
+    }
+    size_t baseLen = nameLen - 2;
+
+    if (nameEquals(name, baseLen, "limit")) {
+        channel->limit = (int16_t)number;
+    } else if (nameEquals(name, baseLen, "step")) {
+        channel->step = (int16_t)number;
+    } else if (nameEquals(name, baseLen, "kick")) {
+        channel->kick = (int16_t)number;
+    } else if (nameEquals(name, baseLen, "kick_ms")) {
+        channel->kickMs = (int16_t)number;
+    } else if (nameEquals(name, baseLen, "min_duty")) {
+        channel->minDuty = (int16_t)number;
+    } else if (nameEquals(name, baseLen, "hold")) {
+        channel->holdDuty = (int16_t)number;
+    } else if (nameEquals(name, baseLen, "drive") && (number == DECAY_FAST || number == DECAY_SLOW)) {
+        channel->drive = (uint8_t)number;
+    } else if (nameEquals(name, baseLen, "stop") && (number == STOP_COAST || number == STOP_BRAKE)) {
+        channel->stop = (uint8_t)number;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static size_t skipSpace(const char *json, size_t i, size_t len) {
+    while (i < len && (json[i] == ' ' || json[i] == '\t' || json[i] == '\r' || json[i] == '\n')) i++;
+    return i;
+}
+
+// 只接受單層物件，值為整數或不含跳脫字元的字串
+bool motorConfigParseJson(MotorConfig &config, const char *json, size_t len) {
+    size_t i = skipSpace(json, 0, len);
+    if (i >= len || json[i] != '{') return false;
+    i = skipSpace(json, i + 1, len);
+    if (i < len && json[i] == '}') return skipSpace(json, i + 1, len) == len;
+
+    for (;;) {
+        // 鍵
+        if (i >= len || json[i] != '"') return false;
+        size_t nameStart = ++i;
+        while (i < len && json[i] != '"' && json[i] != '\\') i++;
+        if (i >= len || json[i] != '"') return false;
+        size_t nameLen = i - nameStart;
+        i = skipSpace(json, i + 1, len);
+        if (i >= len || json[i] != ':') return false;
+        i = skipSpace(json, i + 1, len);
+
+        // 值
+        size_t valueStart;
+        size_t valueLen;
+        if (i < len && json[i] == '"') {
+            valueStart = ++i;
+            while (i < len && json[i] != '"' && json[i] != '\\') i++;
+            if (i >= len || json[i] != '"') return false;
+            valueLen = i - valueStart;
+            i++;
+        } else {
+            valueStart = i;
+            while (i < len && ((json[i] >= '0' && json[i] <= '9') || json[i] == '-' || json[i] == '+')) i++;
+            valueLen = i - valueStart;
+        }
+        if (!motorConfigField(config, json + nameStart, nameLen, json + valueStart, valueLen)) {
+            return false;
+        }
+
+        i = skipSpace(json, i, len);
+        if (i >= len) return false;
+        if (json[i] == '}') return skipSpace(json, i + 1, len) == len;
+        if (json[i] != ',') return false;
+        i = skipSpace(json, i + 1, len);
+    }
+}
+
+size_t motorConfigFormatJson(char *buf, size_t len) {
+    MotorConfig c;
+    uint32_t version;
+    motorConfigSnapshot(c, version);
+    char steering[STEERING_SCHEDULE_MAX_POINTS * 16];
+    steeringScheduleFormat(c.system.steering, c.system.steeringPoints, steering, sizeof(steering));
+    int n = snprintf(buf, len,
+        "{\"profile\":\"%s\",\"version\":%lu,\"ramp_interval_ms\":%d,"
+        "\"limit_t\":%d,\"step_t\":%d,\"kick_t\":%d,\"kick_ms_t\":%d,\"min_duty_t\":%d,\"drive_t\":%d,\"stop_t\":%d,\"hold_t\":%d,"
+        "\"limit_s\":%d,\"step_s\":%d,\"kick_s\":%d,\"kick_ms_s\":%d,\"min_duty_s\":%d,\"drive_s\":%d,\"stop_s\":%d,\"hold_s\":%d,"
+        "\"link_grace_ms\":%d,\"link_decay_ms\":%d,\"link_decay\":%d,\"steering\":\"%s\","
+        "\"speed_period_ms\":%d,\"speed_kp\":%d,\"speed_ki\":%d,\"speed_kd\":%d,\"speed_trim\":%d,\"speed_full\":%d}",
+        c.profile, (unsigned long)version, c.rampIntervalMs,
+        c.t.limit, c.t.step, c.t.kick, c.t.kickMs, c.t.minDuty, c.t.drive, c.t.stop, c.t.holdDuty,
+        c.s.limit, c.s.step, c.s.kick, c.s.kickMs, c.s.minDuty, c.s.drive, c.s.stop, c.s.holdDuty,
+        c.system.linkGraceMs, c.system.linkDecayMs, c.system.linkDecay, steering,
+        c.system.speedPeriodMs, c.system.speedKp, c.system.speedKi, c.system.speedKd, c.system.speedTrim,
+        c.system.speedFull);
+    if (n < 0) return 0;
+    return (size_t)n < len ? (size_t)n : len - 1;
+}
@@ -0,0 +1,640 @@
+// --- 馬達控制核心 (DRV8833 + Ramping) ---
+#include <stdlib.h>
+#include <stdint.h>
+#include "hal.h"
+#include "motor_control.h"
+#include "motor_config.h"
+#include "esp32c3_gpio.h"
+#include "link_supervisor.h"
+#include "input_shaping.h"
+#include "steering_schedule.h"
+#include "wheel_encoder.h"
+#include "speed_loop.h"
+#include "adc_sampler.h"
+#include "current_sense.h"
+#include "battery_monitor.h"
+#include "thermal_model.h"
+#include "endstop_detector.h"
+#include "duty_ramp.h"
+#include "drive_mixer.h"
+#include "session_codec.h"
+#include "session_recorder.h"
+#include "imu_gyro.h"
+#include "heading_hold.h"
+
+// duty 的邏輯滿刻度 (Ramping 參數與 /config 都以 0-255 表示，寫入時才換算成硬體解析度)
+const int PWM_MAX = 255;
+
+// ESP32-C3 的 LEDC: 6 個通道，每兩個共用一個 timer；計數時脈為 80MHz APB，最高 14-bit
+const int LEDC_CHANNEL_COUNT = 6;
+const uint32_t LEDC_CLOCK_HZ = 80000000;
+const int LEDC_MAX_BITS = 14;
+
+// --- 馬達通道表 ---
+// 預設為一顆 DRV8833: A 橋接速度馬達、B 橋接轉向馬達。
+// MOTOR_LAYOUT_4WD: 第二顆 DRV8833 的 A 橋驅動後軸馬達，與前軸共用 T 的參數與搖桿軸。
+// MOTOR_LAYOUT_SKID_STEER: A 橋接左側、B 橋接右側，兩側都使用 T 的參數，由混控產生差速。
+#if defined(MOTOR_LAYOUT_SKID_STEER) && defined(MOTOR_LAYOUT_4WD)
+#error "MOTOR_LAYOUT_SKID_STEER 與 MOTOR_LAYOUT_4WD 不能同時使用 (LEDC 通道不足以驅動四個獨立的輪子)"
+#endif
+
+static constexpr MotorChannelDesc MOTOR_CHANNELS[] = {
+#ifdef MOTOR_LAYOUT_SKID_STEER
+    // 左右兩側: 正值前進 (右側馬達鏡像安裝，方向相反時對調 BIN1/BIN2 的接線)
+    { "L", MOTOR_T, MIX_LEFT, AIN1_PIN, AIN2_PIN, 0, 1, MOTOR_T, MOTOR_T_PWM_FREQ },
+    { "R", MOTOR_T, MIX_RIGHT, BIN2_PIN, BIN1_PIN, 3, 2, MOTOR_S, MOTOR_T_PWM_FREQ },
+#else
+    // T 馬達 (速度): 正值前進 (AIN1 PWM)，負值後退 (AIN2 PWM)
+    { "T", MOTOR_T, MIX_THROTTLE, AIN1_PIN, AIN2_PIN, 0, 1, MOTOR_T, MOTOR_T_PWM_FREQ },
+    // S 馬達 (轉向): 正值右轉 (BIN2 PWM)，負值左轉 (BIN1 PWM)
+    { "S", MOTOR_S, MIX_STEERING, BIN2_PIN, BIN1_PIN, 3, 2, MOTOR_S, MOTOR_S_PWM_FREQ },
+#ifdef MOTOR_LAYOUT_4WD
+    { "T2", MOTOR_T, MIX_THROTTLE, CIN1_PIN, CIN2_PIN, 4, 5, -1, MOTOR_T_PWM_FREQ },
+#endif
+#endif
+};
+
+const int MOTOR_CHANNEL_COUNT = sizeof(MOTOR_CHANNELS) / sizeof(MOTOR_CHANNELS[0]);
+static_assert(MOTOR_CHANNEL_COUNT * 2 <= LEDC_CHANNEL_COUNT, "LEDC 通道不足");
+static_assert(MOTOR_CHANNEL_COUNT <= SESSION_MAX_CHANNELS, "駕駛紀錄格式的通道數不足");
+
+// 每個通道的兩個 LEDC 通道必須共用同一個 timer，頻率才不會互相覆蓋
+static constexpr bool ledcPairsShareTimer(int i) {
+    return i >= MOTOR_CHANNEL_COUNT ||
+           (MOTOR_CHANNELS[i].ledcFwd / 2 == MOTOR_CHANNELS[i].ledcRev / 2 && ledcPairsShareTimer(i + 1));
+}
+static_assert(ledcPairsShareTimer(0), "同一馬達的兩個 LEDC 通道必須是 0/1、2/3 或 4/5");
+
+// --- 馬達 Ramping 核心變數 (與通道表一一對應) ---
+static MotorChannelState channels[MOTOR_CHANNEL_COUNT] = {};
+static volatile uint32_t wheelSpeed = 0;
+
+// --- 速度過渡配置 (週期與各馬達參數由 motor_config 提供，可於執行期修改) ---
+static unsigned long lastRampTime = 0;
+
+// --- 最低有效 duty 校正程序 ---
+const int CALIBRATION_STEP_MS = 150;        // 每個 duty 維持的時間
+
+// --- Ramping 任務使用的參數副本 (版本號改變時才重新複製) ---
+static MotorConfig tickConfig;
+static uint32_t tickConfigVersion = 0;
+
+// --- T 馬達閉迴路速度控制 (安裝編碼器時啟用，編碼器裝在第一個通道的馬達上) ---
+const int ENCODER_CHANNEL = 0;
+static SpeedLoopConfig speedLoopConfig = SPEED_LOOP_DEFAULT;
+static SpeedLoopState speedLoop = {};
+static unsigned long lastSpeedLoopMs = 0;
+
+// --- 航向保持 (安裝陀螺儀時，轉向搖桿回中後修正 S 通道的目標) ---
+static HeadingHoldConfig headingHoldConfig = HEADING_HOLD_DEFAULT;
+static HeadingHoldState headingHold = {};
+
+// --- 緊急停止狀態 ---
+static volatile bool estopLatched = false;
+static volatile uint32_t estopSequence = 0;     // 每次觸發遞增 (由觸發的執行環境寫入)
+static uint32_t estopHandled = 0;               // Ramping 任務已清除狀態的觸發序號
+EstopStats estopStats = { 0, 0, 0, "" };
+
+// 校正程序狀態 (由 Ramping 任務執行)
+struct CalibrationRun {
+    volatile bool active;
+    MotorId motor;
+    volatile int duty;
+    unsigned long nextStepMs;
+};
+
+static CalibrationRun calibration = {};
+
+static void writeChannel(int index, int speedQ8, const MotorChannelConfig &config);
+static void writeStopOutputs(const MotorConfig &config);
+static void stopAllChannels();
+
+static int clampInt(int value, int low, int high) {
+    if (value < low) return low;
+    if (value > high) return high;
+    return value;
+}
+
+static const MotorChannelConfig &roleConfig(const MotorConfig &config, MotorId role) {
+    return role == MOTOR_T ? config.t : config.s;
+}
+
+// 換上目前公開的設定，並交給同樣只在 Ramping 任務中讀取參數的模組
+static void loadTickConfig() {
+    motorConfigSnapshot(tickConfig, tickConfigVersion);
+    const MotorSystemConfig &system = tickConfig.system;
+    LinkSupervisorConfig link = { (unsigned long)system.linkGraceMs, (unsigned long)system.linkDecayMs,
+                                  (LinkDecayProfile)system.linkDecay };
+    linkSupervisorConfigure(link);
+    steeringScheduleConfigure(system.steering, system.steeringPoints);
+    SpeedLoopConfig speed = { (unsigned long)system.speedPeriodMs, system.speedKp, system.speedKi, system.speedKd,
+                              system.speedTrim, (uint32_t)system.speedFull };
+    speedLoopConfig = speed;
+}
+
+int motorChannelCount() {
+    return MOTOR_CHANNEL_COUNT;
+}
+
+const MotorChannelDesc &motorChannelDesc(int index) {
+    return MOTOR_CHANNELS[index];
+}
+
+const MotorChannelState &motorChannelState(int index) {
+    return channels[index];
+}
+
+uint32_t motorWheelSpeed() {
+    return wheelSpeed;
+}
+
+bool motorIdle() {
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        if (channels[i].output != 0) return false;
+    }
+    return true;
+}
+
+const HeadingHoldState &motorHeadingHold() {
+    return headingHold;
+}
+
+// --- 依速度縮放轉向: 只縮放高於最低有效 duty 的部分，避免轉向落入不會轉動的區間 ---
+static int scaleSteeringTarget(int target, int scale, const MotorChannelConfig &p) {
+    if (target == 0) return 0;
+    int magnitude = abs(target);
+    if (magnitude > p.minDuty) {
+        magnitude = p.minDuty + (magnitude - p.minDuty) * scale / STEERING_SCALE_ONE;
+    }
+    magnitude = clampInt(magnitude, 0, p.limit);
+    return target > 0 ? magnitude : -magnitude;
+}
+
+// --- 死區補償: 搖桿 1..255 線性對應到馬達實際會轉動的 minDuty..limit ---
+static int remapDuty(int raw, const MotorChannelConfig &p) {
+    raw = clampInt(raw, -MOTOR_INPUT_MAX, MOTOR_INPUT_MAX);
+    if (raw == 0) return 0;
+    int duty = p.minDuty + abs(raw) * (p.limit - p.minDuty) / MOTOR_INPUT_MAX;
+    return raw > 0 ? duty : -duty;
+}
+
+// --- 記錄目標改變到輸出到達目標的時間 ---
+static void updateRampTiming(RampTiming &timing, const char *name, int current, int target,
+                             unsigned long now) {
+    if (target != timing.lastTarget) {
+        timing.lastTarget = target;
+        timing.startMs = now;
+        timing.settling = true;
+    }
+    if (timing.settling && current == target) {
+        timing.settling = false;
+        if (target == 0) return;   // 停止 (目標為 0) 是立即生效的，不列入統計
+        timing.lastSettleMs = now - timing.startMs;
+        if (timing.lastSettleMs > timing.maxSettleMs) timing.maxSettleMs = timing.lastSettleMs;
+        halLog("Ramp %s: 到達目標 %d 花費 %lu ms\n", name, target, timing.lastSettleMs);
+    }
+}
+
+void motorInit() {
+    // --- 初始化馬達控制腳位 (DRV8833) ---
+    halGpioOutput(NSLEEP_PIN, true);
+    halLog("馬達驅動 (nSLEEP) 已致能於 GPIO%d\n", NSLEEP_PIN);
+
+    // PWM 設定與腳位連接
+    // (每個通道依自己的頻率取最高解析度，低速時的 duty 級距因此更細)。
+    // Ramping 狀態由 0 開始 (主機端的模擬器在同一個行程中重複初始化)
+    lastRampTime = halMillis();
+    lastSpeedLoopMs = lastRampTime;
+    speedLoopReset(speedLoop);
+    headingHold = HeadingHoldState();
+    thermalModelReset();
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        const MotorChannelDesc &desc = MOTOR_CHANNELS[i];
+        channels[i] = MotorChannelState();
+        int bits = pwmResolutionBits(LEDC_CLOCK_HZ, desc.pwmFreq, LEDC_MAX_BITS);
+        bool ok = halPwmSetup(desc.ledcFwd, desc.pinFwd, desc.pwmFreq, bits) &&
+                  halPwmSetup(desc.ledcRev, desc.pinRev, desc.pwmFreq, bits);
+        channels[i].pwmMax = (1 << bits) - 1;
+        halLog("馬達 %s: PWM %lu Hz, %d-bit%s\n", desc.name, (unsigned long)desc.pwmFreq, bits,
+               ok ? "" : " (LEDC 設定失敗)");
+    }
+
+    // 載入 NVS 中的 Ramping 參數 (包含校正過的最低有效 duty 與停止方式)
+    motorConfigLoad();
+    loadTickConfig();
+
+    stopAllChannels(); // 確保馬達啟動時靜止
+
+    wheelEncoderInit(ENCODER_PIN, ENCODER_GLITCH_US_DEFAULT);
+
+    // 類比輸入全部登記後才啟動 DMA 取樣
+    currentSenseInit(ISENSE_A_PIN, ISENSE_B_PIN, ISENSE_RESISTOR_MOHM);
+    batteryMonitorInit(VBAT_SENSE_PIN, VBAT_DIVIDER_RATIO);
+    adcSamplerStart();
+
+    sessionRecorderInit();
+
+    // 陀螺儀由自己的任務讀取，開機校正需要車輛靜止約 1 秒
+    gyroInit(IMU_SDA_PIN, IMU_SCL_PIN, IMU_YAW_SIGN);
+}
+
+void motorSetTarget(int rawT, int rawS) {
+    // 重播駕駛紀錄時，目標由紀錄提供
+    if (sessionState() == SESSION_REPLAYING) return;
+
+    // 由 Web Server 任務或 loop 呼叫，使用自己的設定副本
+    MotorConfig config;
+    uint32_t version;
+    motorConfigSnapshot(config, version);
+
+    // 先依目前的 profile 整形 (死區/Expo/增益)；雙搖桿模式下兩軸都是履帶，都使用油門的曲線
+    MixMode mode = mixerMode();
+    int t = shapeInput(MOTOR_T, rawT);
+    int s = shapeInput(mode == MIX_TANK ? MOTOR_T : MOTOR_S, rawS);
+
+    // 混控後再對應到各通道 role 的有效範圍內
+    MixResult mixed;
+    mixerApply(mode, t, s, MOTOR_INPUT_MAX, mixed);
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        const MotorChannelDesc &desc = MOTOR_CHANNELS[i];
+        channels[i].target = remapDuty(mixed.v[desc.mix], roleConfig(config, desc.role));
+    }
+}
+
+// --- 最低有效 duty 校正程序 ---
+// 由 0 開始緩慢提高指定馬達的 duty，使用者看到輪子開始轉動時呼叫 motorCalibrateMark()。
+// 開始、標記與取消時都把目標歸零: 校正結束後不會衝向校正前 (或校正期間) 收到的設定值
+static void clearTargets() {
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) channels[i].target = 0;
+}
+
+void motorCalibrateStart(MotorId motor) {
+    clearTargets();
+    calibration.motor = motor;
+    calibration.duty = 0;
+    calibration.nextStepMs = halMillis() + CALIBRATION_STEP_MS;
+    calibration.active = true;
+    halLog("開始校正 %s 馬達最低有效 duty，輪子開始轉動時請標記\n", motor == MOTOR_T ? "T" : "S");
+}
+
+bool motorCalibrateMark(MotorConfigResult *result) {
+    if (!calibration.active) return false;
+    calibration.active = false;
+    clearTargets();
+
+    int duty = calibration.duty;
+    MotorConfig config;
+    uint32_t version;
+    motorConfigSnapshot(config, version);
+    MotorChannelConfig &p = calibration.motor == MOTOR_T ? config.t : config.s;
+    p.minDuty = (int16_t)duty;
+
+    // 以新版本公開並存入 NVS，Ramping 任務在下一個 tick 採用
+    *result = motorConfigPublish(config, true);
+    const char *note = *result == MOTOR_CONFIG_INVALID ? " (超出範圍，未套用)"
+                     : *result == MOTOR_CONFIG_NOT_SAVED ? " (已套用，但未存入 NVS)" : "";
+    halLog("校正完成: %s 馬達最低有效 duty = %d%s\n", calibration.motor == MOTOR_T ? "T" : "S", duty, note);
+    return true;
+}
+
+void motorCalibrateCancel() {
+    if (!calibration.active) return;
+    calibration.active = false;
+    clearTargets();
+    halLog("校正已取消\n");
+}
+
+bool motorCalibrating() {
+    return calibration.active;
+}
+
+// 校正期間由 Ramping 任務呼叫：只驅動受測 role 的通道 (正轉)，其他通道保持停止
+static void calibrationTick(unsigned long now) {
+    const MotorChannelConfig &p = roleConfig(tickConfig, calibration.motor);
+    if ((long)(now - calibration.nextStepMs) >= 0) {
+        calibration.nextStepMs = now + CALIBRATION_STEP_MS;
+        calibration.duty = calibration.duty + 1;
+        if (calibration.duty % 10 == 0) halLog("校正中: duty = %d\n", calibration.duty);
+    }
+    bool failed = calibration.duty > p.limit;
+    if (failed) {
+        calibration.active = false;
+        halLog("校正失敗: 已達最高輸出 %d 仍未標記\n", p.limit);
+    }
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        const MotorChannelDesc &desc = MOTOR_CHANNELS[i];
+        MotorChannelState &ch = channels[i];
+        ch.current = !failed && desc.role == calibration.motor ? calibration.duty : 0;
+        ch.currentQ8 = ch.current * DUTY_Q8_ONE;
+        ch.output = ch.current;
+        ch.kick.active = false;
+        writeChannel(i, ch.currentQ8, roleConfig(tickConfig, desc.role));
+    }
+}
+
+void motorEmergencyStop(const char *source, unsigned long arrivalUs) {
+    // 先鎖定，讓正在進行的 Ramping tick 在寫入前後都能看到。
+    // 這裡不在 Ramping 任務中執行，只寫入 PWM 輸出；Ramping 狀態由 Ramping 任務看到新的序號後自行清除
+    estopLatched = true;
+    estopSequence = estopSequence + 1;
+    calibration.active = false;
+    sessionAbortReplay();
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) channels[i].target = 0;
+    MotorConfig config;
+    uint32_t version;
+    motorConfigSnapshot(config, version);
+    writeStopOutputs(config);
+
+    unsigned long latencyUs = halMicros() - arrivalUs;
+
+    estopStats.count++;
+    estopStats.lastLatencyUs = latencyUs;
+    if (latencyUs > estopStats.maxLatencyUs) estopStats.maxLatencyUs = latencyUs;
+    estopStats.lastSource = source;
+    halLog("⛔ 緊急停止 (%s)，輸出已停止，延遲 %lu us\n", source, latencyUs);
+}
+
+void motorRearm() {
+    if (!estopLatched) return;
+    // 清除鎖定前先把目標歸零，避免解除後直接衝向停止前的設定值
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) channels[i].target = 0;
+    estopLatched = false;
+    halLog("✅ 緊急停止已解除\n");
+}
+
+bool motorEstopLatched() {
+    return estopLatched;
+}
+
+// --- 輔助函數: 寫入單一馬達通道 (Q8 duty，正負號代表方向，0 依 StopMode 滑行或煞車) ---
+static void writeChannel(int index, int speedQ8, const MotorChannelConfig &config) {
+    const MotorChannelDesc &desc = MOTOR_CHANNELS[index];
+    MotorChannelState &ch = channels[index];
+    int chFwd = desc.ledcFwd;
+    int chRev = desc.ledcRev;
+    if (speedQ8 == 0) {
+        if (config.stop == STOP_BRAKE) {
+            // STOP: Brake mode (IN1=HIGH, IN2=HIGH)
+            halPwmWrite(chFwd, ch.pwmMax);
+            halPwmWrite(chRev, ch.pwmMax);
+        } else {
+            // STOP: Coast mode (IN1=LOW, IN2=LOW)
+            halPwmWrite(chFwd, 0);
+            halPwmWrite(chRev, 0);
+        }
+        return;
+    }
+
+    int drivePin = speedQ8 > 0 ? chFwd : chRev;
+    int otherPin = speedQ8 > 0 ? chRev : chFwd;
+    int duty = pwmDitherStep(ch.dither, abs(speedQ8), PWM_MAX, ch.pwmMax);
+    if (config.drive == DECAY_SLOW) {
+        // 慢衰減: 驅動腳保持 HIGH，另一腳輸出反相 PWM (LOW 的時間比例即為驅動比例)
+        halPwmWrite(drivePin, ch.pwmMax);
+        halPwmWrite(otherPin, ch.pwmMax - duty);
+    } else {
+        // 快衰減: 驅動腳輸出 PWM，另一腳 LOW
+        halPwmWrite(drivePin, duty);
+        halPwmWrite(otherPin, 0);
+    }
+}
+
+// --- 輔助函數: 所有通道輸出停止 (只寫入 PWM，可由任何執行環境呼叫) ---
+static void writeStopOutputs(const MotorConfig &config) {
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        writeChannel(i, 0, roleConfig(config, MOTOR_CHANNELS[i].role));
+    }
+}
+
+// --- 輔助函數: 所有通道輸出停止並清除 Ramping 狀態 (只在 Ramping 任務中呼叫) ---
+static void stopAllChannels() {
+    writeStopOutputs(tickConfig);
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        channels[i].current = 0;
+        channels[i].currentQ8 = 0;
+        channels[i].output = 0;
+        channels[i].kick.active = false;
+    }
+}
+
+// --- 閉迴路: 以固定週期取樣輪速並執行 PID，週期之間維持上次的輸出 ---
+static int speedLoopOutput(int command, const MotorChannelConfig &p, unsigned long now) {
+    if (!wheelEncoderPresent()) return command;
+
+    bool due = now - lastSpeedLoopMs >= speedLoopConfig.periodMs;
+    if (due) {
+        lastSpeedLoopMs = now;
+        wheelSpeed = wheelEncoderSpeed(halMicros());
+    }
+    if (command == 0) {
+        speedLoopReset(speedLoop);
+        return 0;
+    }
+    // 方向改變時不等下一個週期，避免沿用反方向的輸出
+    int dir = command > 0 ? 1 : -1;
+    if (due || dir != speedLoop.direction) {
+        speedLoopStep(speedLoop, speedLoopConfig, command, wheelSpeed, p.minDuty, p.limit);
+    }
+    return speedLoop.output;
+}
+
+// --- 馬達繞組電流 ---
+// 感測電阻只在 PWM 導通期間有電流，繞組電流約為量測平均值除以 duty 比例；
+// duty 很低時除法會放大雜訊，直接使用量測值。沒有感測時依 duty 估計。
+static int windingCurrentMa(const MotorChannelDesc &desc, int duty) {
+    int magnitude = abs(duty);
+    if (magnitude == 0) return 0;
+    if (!currentSensePresent(desc.sense)) return magnitude * BATTERY_ESTIMATED_FULL_DUTY_MA / PWM_MAX;
+
+    int sensed = currentSenseChannel((MotorId)desc.sense).fastMa;
+    if (magnitude < PWM_MAX / 8) return sensed;
+    return sensed * PWM_MAX / magnitude;
+}
+
+// --- 電池負載電流: 有電流感測的通道使用量測值，其他依上個 tick 的輸出 duty 估計 ---
+static int estimateLoadMa() {
+    int total = 0;
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        const MotorChannelDesc &desc = MOTOR_CHANNELS[i];
+        if (currentSensePresent(desc.sense)) {
+            total += currentSenseChannel((MotorId)desc.sense).fastMa;
+        } else {
+            total += abs(channels[i].output) * BATTERY_ESTIMATED_FULL_DUTY_MA / PWM_MAX;
+        }
+    }
+    return total;
+}
+
+// --- 熱模型: 同一 role 的多個通道共用一個節點，以電流最大者計算 ---
+static void thermalTick(unsigned long elapsed) {
+    int winding[MOTOR_ROLE_COUNT] = { 0, 0 };
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        const MotorChannelDesc &desc = MOTOR_CHANNELS[i];
+        int ma = windingCurrentMa(desc, channels[i].output);
+        if (ma > winding[desc.role]) winding[desc.role] = ma;
+    }
+    thermalModelTick(winding[MOTOR_T], winding[MOTOR_S], elapsed);
+}
+
+// --- 轉向排程的依據: 驅動 (T) 通道中目前輸出最大者 ---
+static int driveSpeed() {
+    int speed = 0;
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        if (MOTOR_CHANNELS[i].role != MOTOR_T) continue;
+        int current = channels[i].current;
+        if (abs(current) > abs(speed)) speed = current;
+    }
+    return speed;
+}
+
+// --- 輸出階段的 duty 縮放 (duty 與縮放皆為 Q8)，結果限制在 PWM 範圍內 ---
+static int scaleOutput(int dutyQ8, int scale) {
+    return clampInt(dutyQ8 * scale / 256, -PWM_MAX * DUTY_Q8_ONE, PWM_MAX * DUTY_Q8_ONE);
+}
+
+static RampParams rampParams(const MotorChannelConfig &p, int stepQ8, int kickScale) {
+    RampParams params = { stepQ8, p.kick * kickScale / BATTERY_SCALE_ONE, p.kickMs, p.minDuty };
+    return params;
+}
+
+// --- 定時馬達 Ramping 任務 (所有通道在同一次迴圈中更新，參數依 role 取用) ---
+void motorRampTask() {
+    // /config 公開新版本時，在這裡一次換上整組參數
+    if (motorConfigVersion() != tickConfigVersion) {
+        loadTickConfig();
+    }
+
+    unsigned long now = halMillis();
+    unsigned long elapsed = now - lastRampTime;
+    if (elapsed < (unsigned long)tickConfig.rampIntervalMs) return;
+    lastRampTime = now;
+
+    // 每個 tick 都取出 ADC 樣本，避免 DMA 緩衝溢位
+    adcSamplerPoll();
+    currentSenseTick();
+    batteryMonitorTick(estimateLoadMa(), elapsed);
+    thermalTick(elapsed);
+
+    // 緊急停止觸發後第一次執行時清除 Ramping 狀態 (即使已經解除，也不會沿用停止前的輸出)
+    uint32_t sequence = estopSequence;
+    if (sequence != estopHandled) {
+        estopHandled = sequence;
+        stopAllChannels();
+    }
+    if (estopLatched) {
+        // 緊急停止鎖定中：持續輸出停止，不執行 Ramping
+        stopAllChannels();
+        return;
+    }
+
+    if (calibration.active) {
+        calibrationTick(now);
+        if (estopLatched) stopAllChannels();
+        return;
+    }
+
+    // 重播中由紀錄提供目標 (視同持續收到命令)；錄製中記下本次套用的目標
+    int sessionTargets[MOTOR_CHANNEL_COUNT];
+    if (sessionReplayTick(now, sessionTargets, MOTOR_CHANNEL_COUNT)) {
+        for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) channels[i].target = sessionTargets[i];
+    }
+    bool moving = false;
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        sessionTargets[i] = channels[i].target;
+        if (sessionTargets[i] != 0) moving = true;
+    }
+    if (sessionState() == SESSION_REPLAYING) linkSupervisorOnCommand(now, moving);
+    sessionRecordTick(now, sessionTargets, MOTOR_CHANNEL_COUNT);
+
+    // 航向保持: 只讀取陀螺儀任務公開的數值，不在這裡等待 I2C。
+    // 修正量在轉向搖桿回中時作為轉向目標，之後與一般命令一樣經過連線衰減與轉向排程
+    // (只作用在轉向通道上；差速轉向的配置沒有轉向通道，不會介入)。
+    // 重播紀錄時目標已包含當時的轉向，不再疊加修正
+    gyroSetStationary(motorIdle());
+    int headingTrim = 0;
+    bool hasSteering = false;
+    bool steeringCentered = true;
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        if (MOTOR_CHANNELS[i].mix != MIX_STEERING) continue;
+        hasSteering = true;
+        if (channels[i].target != 0) steeringCentered = false;
+    }
+    if (sessionState() == SESSION_REPLAYING) {
+        headingHoldReset(headingHold);
+    } else if (hasSteering && gyroPresent()) {
+        headingTrim = headingHoldUpdate(headingHold, headingHoldConfig, steeringCentered, driveSpeed(),
+                                        gyroHeadingMdeg(), gyroYawRateMdps(), elapsed);
+    }
+
+    // 控制命令中斷時，連線監督會把目標速度逐步衰減到 0
+    int linkScale = linkSupervisorScale(now);
+
+    // 轉向權限依驅動馬達目前的輸出調整 (每個 tick 都重新查表，不需要客戶端配合)；
+    // 步長縮放保留小數，由 Q8 累加器累積
+    SteeringScale steering = steeringScheduleLookup(driveSpeed());
+    int stepS = tickConfig.s.step * steering.step * DUTY_Q8_ONE / STEERING_SCALE_ONE;
+    if (stepS < DUTY_Q8_ONE) stepS = DUTY_Q8_ONE;
+
+    // 電池電壓驟降時縮小啟動推力，避免 MCU 因壓降重置
+    int kickScale = batteryKickScale();
+    RampParams ramp[MOTOR_ROLE_COUNT] = {
+        rampParams(tickConfig.t, tickConfig.t.step * DUTY_Q8_ONE, kickScale),
+        rampParams(tickConfig.s, stepS, kickScale),
+    };
+
+    // 依電池電壓補償 duty，讓有效電壓不隨電量改變 (未安裝電壓量測時縮放為 1.0)；
+    // 熱模型預測將超溫時，平滑降低有效輸出上限 (含電壓補償後的上限)
+    int compensation = batteryCompensation();
+    int cap[MOTOR_ROLE_COUNT] = {
+        scaleOutput(scaleOutput(tickConfig.t.limit * DUTY_Q8_ONE, compensation), thermalDerate(THERMAL_MOTOR_T)),
+        scaleOutput(scaleOutput(tickConfig.s.limit * DUTY_Q8_ONE, compensation), thermalDerate(THERMAL_MOTOR_S)),
+    };
+
+    for (int i = 0; i < MOTOR_CHANNEL_COUNT; i++) {
+        const MotorChannelDesc &desc = MOTOR_CHANNELS[i];
+        const MotorChannelConfig &p = roleConfig(tickConfig, desc.role);
+        MotorChannelState &ch = channels[i];
+
+        // 航向修正只在轉向目標為 0 時出現，與搖桿命令一樣經過死區補償 (小的修正量也從 minDuty 起跳)。
+        // 停住的轉向機構要靠啟動推力才推得動: 修正方向反轉時從靜止重新開始，反向也會先推一下
+        // (逐步減速穿過 0 的話，反向的小 duty 推不動轉向，修正會卡在原本的方向)
+        int target = ch.target;
+        if (desc.mix == MIX_STEERING && headingTrim != 0) {
+            target = remapDuty(headingTrim, p);
+            if (ch.currentQ8 != 0 && (ch.currentQ8 > 0) != (target > 0)) ch.currentQ8 = 0;
+        }
+        target = target * linkScale / LINK_SCALE_ONE;
+        if (desc.role == MOTOR_S) target = scaleSteeringTarget(target, steering.target, p);
+        ch.currentQ8 = rampStepQ8(ch.currentQ8, target, ramp[desc.role], ch.kick, now);
+        ch.current = ch.currentQ8 / DUTY_Q8_ONE;
+        updateRampTiming(ch.timing, desc.name, ch.current, target, now);
+
+        // 安裝編碼器時，該通道的 duty 由速度迴路依實際輪速修正；
+        // 打到端點或堵轉時改以 holding duty 輸出，直到命令歸零或反向
+        int sensedMa = currentSensePresent(desc.sense) ? windingCurrentMa(desc, ch.output) : -1;
+        int outputQ8 = ch.currentQ8;
+        if (i == ENCODER_CHANNEL && wheelEncoderPresent()) {
+            outputQ8 = speedLoopOutput(ch.current, p, now) * DUTY_Q8_ONE;
+        }
+        // 「接近上限」以目前實際可到達的上限判斷: 高速時轉向排程把 S 縮到 limit 以下，
+        // 以 limit 判斷的話打到端點時永遠不會進入 holding
+        int reach = desc.role == MOTOR_S ? scaleSteeringTarget(p.limit, steering.target, p) : p.limit;
+        int command = outputQ8 / DUTY_Q8_ONE;
+        int held = endstopUpdate(ch.endstop, ENDSTOP_DEFAULT, command, reach - reach / 8, p.holdDuty,
+                                 sensedMa, elapsed);
+        if (held != command) outputQ8 = held * DUTY_Q8_ONE;
+        outputQ8 = scaleOutput(outputQ8, compensation);
+
+        // 電流超過預算時依比例降低 duty (未安裝感測時縮放為 1.0)
+        if (desc.sense >= 0) outputQ8 = scaleOutput(outputQ8, currentSenseScale((MotorId)desc.sense));
+
+        outputQ8 = clampInt(outputQ8, -cap[desc.role], cap[desc.role]);
+        ch.output = outputQ8 / DUTY_Q8_ONE;
+        writeChannel(i, outputQ8, p);
+    }
+
+    // 若緊急停止在本次計算途中觸發，本次寫入可能覆蓋了停止輸出，這裡重新歸零
+    if (estopLatched) {
+        stopAllChannels();
+    }
+}
@@ -0,0 +1,101 @@
+// --- 駕駛紀錄的編碼格式 ---
+#include <string.h>
+#include "session_codec.h"
+
+static size_t putVarint(uint8_t *buf, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        buf[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    buf[n++] = (uint8_t)value;
+    return n;
+}
+
+// 回傳使用的位元組數，資料不足或超過 32-bit 時回傳 0
+static size_t getVarint(const uint8_t *buf, size_t len, uint32_t &value) {
+    value = 0;
+    for (size_t i = 0; i < len && i < 5; i++) {
+        value |= (uint32_t)(buf[i] & 0x7F) << (7 * i);
+        if ((buf[i] & 0x80) == 0) return i + 1;
+    }
+    return 0;
+}
+
+static uint32_t zigzag(int value) {
+    return value >= 0 ? (uint32_t)value << 1 : (((uint32_t)(-(value + 1))) << 1) | 1;
+}
+
+static int unzigzag(uint32_t value) {
+    return (value & 1) ? -(int)(value >> 1) - 1 : (int)(value >> 1);
+}
+
+size_t sessionWriteHeader(uint8_t *buf, int channelCount) {
+    buf[0] = 'R';
+    buf[1] = 'S';
+    buf[2] = SESSION_FORMAT_VERSION;
+    buf[3] = (uint8_t)channelCount;
+    return SESSION_HEADER_LEN;
+}
+
+bool sessionReadHeader(const uint8_t *buf, size_t len, int &channelCount) {
+    if (len < SESSION_HEADER_LEN || buf[0] != 'R' || buf[1] != 'S' || buf[2] != SESSION_FORMAT_VERSION) {
+        return false;
+    }
+    if (buf[3] == 0 || buf[3] > SESSION_MAX_CHANNELS) return false;
+    channelCount = buf[3];
+    return true;
+}
+
+void sessionEncoderInit(SessionEncoder &encoder, int channels, unsigned long startMs) {
+    encoder.channels = channels;
+    memset(encoder.last, 0, sizeof(encoder.last));
+    encoder.stampMs = startMs;
+}
+
+bool sessionChanged(const SessionEncoder &encoder, const int *targets) {
+    for (int i = 0; i < encoder.channels; i++) {
+        if (targets[i] != encoder.last[i]) return true;
+    }
+    return false;
+}
+
+size_t sessionEncode(SessionEncoder &encoder, unsigned long nowMs, const int *targets, uint8_t *buf) {
+    uint32_t dt = (uint32_t)(nowMs - encoder.stampMs);
+    // 第一個位元組為 0xFF (低 7 bits 全為 1 且後面還有) 時會被當成結尾
+    if ((dt & 0x7F) == 0x7F && dt >= 0x80) dt--;
+    encoder.stampMs += dt;
+
+    size_t n = putVarint(buf, dt);
+    for (int i = 0; i < encoder.channels; i++) {
+        n += putVarint(buf + n, zigzag(targets[i] - encoder.last[i]));
+        encoder.last[i] = targets[i];
+    }
+    return n;
+}
+
+void sessionDecoderInit(SessionDecoder &decoder, int channels) {
+    decoder.channels = channels;
+    memset(decoder.targets, 0, sizeof(decoder.targets));
+    decoder.stampMs = 0;
+}
+
+size_t sessionDecode(SessionDecoder &decoder, const uint8_t *buf, size_t len) {
+    if (len == 0 || buf[0] == SESSION_END) return 0;
+
+    uint32_t value;
+    size_t used = getVarint(buf, len, value);
+    if (used == 0) return 0;
+    unsigned long stamp = decoder.stampMs + value;
+
+    int targets[SESSION_MAX_CHANNELS];
+    for (int i = 0; i < decoder.channels; i++) {
+        size_t n = getVarint(buf + used, len - used, value);
+        if (n == 0) return 0;
+        used += n;
+        targets[i] = decoder.targets[i] + unzigzag(value);
+    }
+    decoder.stampMs = stamp;
+    memcpy(decoder.targets, targets, sizeof(int) * decoder.channels);
+    return used;
+}
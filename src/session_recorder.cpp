@@ -0,0 +1,270 @@
+// --- 駕駛紀錄的錄製與重播 (flash "rec" 分區) ---
+#include <string.h>
+#include "hal.h"
+#include "session_codec.h"
+#include "session_recorder.h"
+
+static const char *SESSION_PARTITION = "rec";
+const size_t SESSION_RING_SIZE = 1024;      // 約 300 筆 (每筆通常 3 位元組以上)
+const size_t SESSION_FLASH_CHUNK = 256;     // 每次寫入/預讀的大小 (一個 flash page)
+
+static HalFlashRegion region;
+static bool regionPresent = false;
+
+static volatile SessionState state = SESSION_IDLE;
+static volatile SessionAction pendingAction = SESSION_ACTION_NONE;
+static volatile bool replayEnding = false;
+static SessionStats stats = {};
+
+// --- 環形緩衝區 (錄製時 Ramping 任務寫入、service 讀出；重播時相反，兩者都在 loop() 中) ---
+static uint8_t ring[SESSION_RING_SIZE];
+static size_t ringHead = 0;     // 下一個寫入位置 (累計值)
+static size_t ringTail = 0;     // 下一個讀出位置 (累計值)
+
+static size_t flashOffset = 0;  // 錄製: 下一個寫入位置；重播: 下一個讀取位置
+static bool flashExhausted = false;
+
+// --- 錄製狀態 ---
+static SessionEncoder encoder;
+static bool encoderStarted = false;
+static bool stopRequested = false;
+
+// --- 重播狀態 ---
+static SessionDecoder decoder;
+static bool replayStarted = false;
+static bool replayPending = false;      // decoder 中有一筆尚未套用
+static unsigned long replayStartMs = 0;
+
+static size_t ringUsed() {
+    return ringHead - ringTail;
+}
+
+static void ringReset() {
+    ringHead = 0;
+    ringTail = 0;
+}
+
+static void ringPush(const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) ring[(ringHead + i) % SESSION_RING_SIZE] = data[i];
+    ringHead += len;
+}
+
+// 不移動讀取位置，複製最多 len 位元組
+static size_t ringPeek(uint8_t *out, size_t len) {
+    size_t used = ringUsed();
+    if (len > used) len = used;
+    for (size_t i = 0; i < len; i++) out[i] = ring[(ringTail + i) % SESSION_RING_SIZE];
+    return len;
+}
+
+void sessionRecorderInit() {
+    regionPresent = halFlashRegionOpen(SESSION_PARTITION, region);
+    if (regionPresent) {
+        halLog("駕駛紀錄分區: %lu bytes\n", (unsigned long)region.size);
+    } else {
+        halLog("找不到 \"%s\" 分區，錄製/重播停用\n", SESSION_PARTITION);
+    }
+}
+
+bool sessionRequest(SessionAction action) {
+    if (!regionPresent) return false;
+    if (action == SESSION_ACTION_STOP) {
+        if (state == SESSION_IDLE) return false;
+    } else if (state != SESSION_IDLE) {
+        return false;
+    }
+    pendingAction = action;
+    return true;
+}
+
+void sessionAbortReplay() {
+    if (state != SESSION_REPLAYING) return;
+    state = SESSION_IDLE;
+    replayEnding = true;
+}
+
+static void startRecording(bool motorsIdle) {
+    if (!motorsIdle) {
+        halLog("行駛中不能開始錄製 (擦除 flash 期間控制迴圈會暫停)\n");
+        return;
+    }
+    halLog("擦除駕駛紀錄分區...\n");
+    if (!halFlashRegionErase(region)) {
+        halLog("擦除失敗，取消錄製\n");
+        return;
+    }
+    ringReset();
+    flashOffset = 0;
+    stats = SessionStats();
+    encoderStarted = false;
+    stopRequested = false;
+    state = SESSION_RECORDING;
+    halLog("開始錄製\n");
+}
+
+static void startReplay() {
+    uint8_t header[SESSION_HEADER_LEN];
+    int channels;
+    if (!halFlashRegionRead(region, 0, header, sizeof(header)) || !sessionReadHeader(header, sizeof(header), channels)) {
+        halLog("沒有可重播的紀錄\n");
+        return;
+    }
+    ringReset();
+    sessionDecoderInit(decoder, channels);
+    flashOffset = SESSION_HEADER_LEN;
+    flashExhausted = false;
+    stats = SessionStats();
+    replayStarted = false;
+    replayPending = false;
+    replayEnding = false;
+    state = SESSION_REPLAYING;
+    halLog("開始重播 (%d 個通道)\n", channels);
+}
+
+// 寫出環形緩衝區中的資料；final 為 true 時全部寫出 (不足一個 chunk 也寫)
+static void flushRecording(bool final) {
+    while (ringUsed() >= SESSION_FLASH_CHUNK || (final && ringUsed() > 0)) {
+        uint8_t chunk[SESSION_FLASH_CHUNK];
+        size_t len = ringPeek(chunk, SESSION_FLASH_CHUNK);
+        // 保留最後一個位元組給結尾標記 (擦除後的 0xFF)
+        if (flashOffset + len >= region.size) {
+            halLog("駕駛紀錄分區已滿，停止錄製\n");
+            state = SESSION_IDLE;
+            return;
+        }
+        if (!halFlashRegionWrite(region, flashOffset, chunk, len)) {
+            halLog("寫入駕駛紀錄失敗，停止錄製\n");
+            state = SESSION_IDLE;
+            return;
+        }
+        flashOffset += len;
+        ringTail += len;
+        stats.bytes = (uint32_t)flashOffset;
+        if (!final) return;     // 一次 service 只寫一個 chunk，避免連續關閉 cache
+    }
+}
+
+// 預讀 flash 到環形緩衝區
+static void fillReplay() {
+    if (flashExhausted || SESSION_RING_SIZE - ringUsed() < SESSION_FLASH_CHUNK) return;
+    size_t len = SESSION_FLASH_CHUNK;
+    if (flashOffset + len > region.size) len = region.size - flashOffset;
+    uint8_t chunk[SESSION_FLASH_CHUNK];
+    if (len == 0 || !halFlashRegionRead(region, flashOffset, chunk, len)) {
+        flashExhausted = true;
+        return;
+    }
+    ringPush(chunk, len);
+    flashOffset += len;
+    stats.bytes = (uint32_t)flashOffset;
+}
+
+void sessionService(bool motorsIdle) {
+    SessionAction action = pendingAction;
+    pendingAction = SESSION_ACTION_NONE;
+
+    if (action == SESSION_ACTION_RECORD && state == SESSION_IDLE) startRecording(motorsIdle);
+    if (action == SESSION_ACTION_REPLAY && state == SESSION_IDLE) startReplay();
+    if (action == SESSION_ACTION_STOP) {
+        if (state == SESSION_RECORDING) stopRequested = true;
+        if (state == SESSION_REPLAYING) sessionAbortReplay();
+    }
+
+    if (state == SESSION_RECORDING) {
+        flushRecording(stopRequested);
+        if (stopRequested && state == SESSION_RECORDING) {
+            state = SESSION_IDLE;
+            halLog("錄製結束: %lu 筆，%lu bytes，捨棄 %lu 筆\n", (unsigned long)stats.records,
+                   (unsigned long)stats.bytes, (unsigned long)stats.overruns);
+        }
+    } else if (state == SESSION_REPLAYING) {
+        fillReplay();
+    }
+}
+
+void sessionRecordTick(unsigned long nowMs, const int *targets, int count) {
+    if (state != SESSION_RECORDING || stopRequested) return;
+    if (!encoderStarted) {
+        // 標頭在第一個 tick 才寫入 (通道數由 Ramping 任務提供)
+        encoderStarted = true;
+        sessionEncoderInit(encoder, count, nowMs);
+        uint8_t header[SESSION_HEADER_LEN];
+        ringPush(header, sessionWriteHeader(header, count));
+    }
+    if (!sessionChanged(encoder, targets)) return;
+
+    // 先在副本上編碼，放得下才更新編碼狀態
+    SessionEncoder next = encoder;
+    uint8_t record[SESSION_RECORD_MAX];
+    size_t len = sessionEncode(next, nowMs, targets, record);
+    if (SESSION_RING_SIZE - ringUsed() < len) {
+        stats.overruns++;
+        return;
+    }
+    ringPush(record, len);
+    encoder = next;
+    stats.records++;
+}
+
+// 取出下一筆到 decoder，回傳 false 表示沒有資料 (結尾或尚未預讀)
+static bool decodeNext(bool &ended) {
+    uint8_t record[SESSION_RECORD_MAX] = {};
+    size_t available = ringPeek(record, sizeof(record));
+    size_t used = sessionDecode(decoder, record, available);
+    if (used > 0) {
+        ringTail += used;
+        return true;
+    }
+    // 結尾標記，或已讀到分區結尾仍無法解出完整的一筆
+    ended = (available > 0 && record[0] == SESSION_END) || (flashExhausted && available < sizeof(record));
+    return false;
+}
+
+bool sessionReplayTick(unsigned long nowMs, int *targets, int count) {
+    if (replayEnding) {
+        replayEnding = false;
+        for (int i = 0; i < count; i++) targets[i] = 0;
+        return true;
+    }
+    if (state != SESSION_REPLAYING) return false;
+    if (decoder.channels != count) {
+        halLog("紀錄的通道數 (%d) 與目前的配置 (%d) 不同，停止重播\n", decoder.channels, count);
+        sessionAbortReplay();
+        return false;
+    }
+    if (!replayStarted) {
+        replayStarted = true;
+        replayStartMs = nowMs;
+    }
+
+    bool applied = false;
+    bool ended = false;
+    if (!replayPending) replayPending = decodeNext(ended);
+    while (replayPending && nowMs - replayStartMs >= decoder.stampMs) {
+        memcpy(targets, decoder.targets, sizeof(int) * count);
+        applied = true;
+        stats.records++;
+        replayPending = decodeNext(ended);
+    }
+    if (ended && !replayPending) {
+        halLog("重播結束: %lu 筆\n", (unsigned long)stats.records);
+        sessionAbortReplay();
+    }
+    return applied;
+}
+
+SessionState sessionState() {
+    return state;
+}
+
+const char *sessionStateName(SessionState current) {
+    switch (current) {
+    case SESSION_RECORDING: return "recording";
+    case SESSION_REPLAYING: return "replaying";
+    default: return "idle";
+    }
+}
+
+const SessionStats &sessionStats() {
+    return stats;
+}
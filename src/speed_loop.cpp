@@ -0,0 +1,68 @@
+// --- T 馬達閉迴路速度控制 (定點 PID) ---
+#include <stdlib.h>
+#include "speed_loop.h"
+
+void speedLoopReset(SpeedLoopState &state) {
+    state.integral = 0;
+    state.primed = false;
+    state.lastMeasured = 0;
+    state.direction = 0;
+    state.output = 0;
+}
+
+// 輪速換算成 duty 尺度: 0 → 0，轉動時線性對應到 minDuty..limit (與搖桿的對應方式相同)
+static int speedToDuty(uint32_t measured, const SpeedLoopConfig &config, int minDuty, int limit) {
+    if (measured == 0 || config.fullSpeed == 0) return 0;
+    // 量測值異常偏高時限制在兩倍滿速，避免換算溢位
+    uint32_t capped = measured < 2 * config.fullSpeed ? measured : 2 * config.fullSpeed;
+    return minDuty + (int)((uint64_t)capped * (uint32_t)(limit - minDuty) / config.fullSpeed);
+}
+
+int speedLoopStep(SpeedLoopState &state, const SpeedLoopConfig &config, int command,
+                  uint32_t measured, int minDuty, int limit) {
+    if (command == 0) {
+        speedLoopReset(state);
+        return 0;
+    }
+    int dir = command > 0 ? 1 : -1;
+    if (dir != state.direction) {
+        // 方向反轉時先前的積分沒有意義
+        speedLoopReset(state);
+        state.direction = dir;
+    }
+
+    int setpoint = command * dir;
+    int measuredDuty = speedToDuty(measured, config, minDuty, limit);
+    int error = setpoint - measuredDuty;
+    int derivative = state.primed ? state.lastMeasured - measuredDuty : 0;
+    state.primed = true;
+    state.lastMeasured = measuredDuty;
+
+    // 積分只修正穩態的小誤差: 誤差超過 trimLimit 的一半 (起步、堵轉、被卡住) 時不累加，
+    // 否則卡住期間累積的修正量會在放開後造成超速。修正量限制在 ±trimLimit
+    int32_t integral = state.integral;
+    if (abs(error) <= config.trimLimit / 2) integral += error;
+    if (config.ki > 0) {
+        int32_t integralMax = (int32_t)config.trimLimit * SPEED_GAIN_ONE / config.ki;
+        if (integral > integralMax) integral = integralMax;
+        if (integral < -integralMax) integral = -integralMax;
+    } else {
+        integral = 0;
+    }
+
+    int32_t correction = ((int32_t)config.kp * error + (int32_t)config.ki * integral
+                          + (int32_t)config.kd * derivative) / SPEED_GAIN_ONE;
+    int32_t output = setpoint + correction;
+
+    // Anti-windup: 輸出已飽和且誤差會讓飽和更嚴重時，不累加這次的誤差
+    if (output > limit) {
+        output = limit;
+        if (error > 0) integral = state.integral;
+    } else if (output < 0) {
+        output = 0;
+        if (error < 0) integral = state.integral;
+    }
+    state.integral = integral;
+    state.output = dir * (int)output;
+    return state.output;
+}
@@ -0,0 +1,108 @@
+// --- 依速度調整轉向權限 (Steering Feedforward) ---
+#include "steering_schedule.h"
+
+#include <stdio.h>
+#include "control_query.h"
+
+// 預設表格: 靜止到低速時轉向反應加快 1.5 倍，接近 PWM_EFFECTIVE_LIMIT_T 時權限降到約 60%
+const SteeringSchedulePoint STEERING_SCHEDULE_DEFAULT[] = {
+    {   0, 256, 384 },
+    {  80, 256, 256 },
+    { 150, 200, 224 },
+    { 200, 150, 192 },
+};
+const int STEERING_SCHEDULE_DEFAULT_COUNT = sizeof(STEERING_SCHEDULE_DEFAULT) / sizeof(STEERING_SCHEDULE_DEFAULT[0]);
+
+static SteeringSchedulePoint schedule[STEERING_SCHEDULE_MAX_POINTS] = {
+    STEERING_SCHEDULE_DEFAULT[0], STEERING_SCHEDULE_DEFAULT[1], STEERING_SCHEDULE_DEFAULT[2], STEERING_SCHEDULE_DEFAULT[3],
+};
+static int scheduleCount = STEERING_SCHEDULE_DEFAULT_COUNT;
+
+static bool scaleValid(int scale) {
+    return scale >= 0 && scale <= STEERING_SCALE_MAX;
+}
+
+bool steeringScheduleValid(const SteeringSchedulePoint *points, int count) {
+    if (count < 1 || count > STEERING_SCHEDULE_MAX_POINTS) return false;
+    for (int i = 0; i < count; i++) {
+        const SteeringSchedulePoint &p = points[i];
+        if (p.throttle < 0 || p.throttle > 255 || !scaleValid(p.targetScale) || !scaleValid(p.stepScale)) {
+            return false;
+        }
+        if (i > 0 && p.throttle <= points[i - 1].throttle) return false;
+    }
+    return true;
+}
+
+bool steeringScheduleConfigure(const SteeringSchedulePoint *points, int count) {
+    if (!steeringScheduleValid(points, count)) return false;
+    for (int i = 0; i < count; i++) schedule[i] = points[i];
+    scheduleCount = count;
+    return true;
+}
+
+// 解析 "a:b:c" 中的一個整數，停在下一個 ':' / ',' 或字串結尾
+static bool parseNumber(const char *text, size_t len, size_t &i, int *out) {
+    size_t start = i;
+    while (i < len && text[i] != ',' && text[i] != ':') i++;
+    return parseSaturatedInt(text + start, i - start, out);
+}
+
+bool steeringScheduleParse(const char *text, size_t len, SteeringSchedulePoint *points, int *count) {
+    int n = 0;
+    size_t i = 0;
+    while (i < len) {
+        if (n == STEERING_SCHEDULE_MAX_POINTS) return false;
+        SteeringSchedulePoint &p = points[n];
+        if (!parseNumber(text, len, i, &p.throttle) || i >= len || text[i++] != ':') return false;
+        if (!parseNumber(text, len, i, &p.targetScale) || i >= len || text[i++] != ':') return false;
+        if (!parseNumber(text, len, i, &p.stepScale)) return false;
+        n++;
+        if (i < len && text[i++] != ',') return false;
+        if (i == len && text[len - 1] == ',') return false;
+    }
+    *count = n;
+    return steeringScheduleValid(points, n);
+}
+
+size_t steeringScheduleFormat(const SteeringSchedulePoint *points, int count, char *buf, size_t len) {
+    size_t used = 0;
+    if (len > 0) buf[0] = '\0';
+    for (int i = 0; i < count; i++) {
+        int n = snprintf(buf + used, len - used, "%s%d:%d:%d", i > 0 ? "," : "",
+                         points[i].throttle, points[i].targetScale, points[i].stepScale);
+        if (n < 0 || (size_t)n >= len - used) {
+            buf[used] = '\0';  // 放不下的點整個省略
+            return used;
+        }
+        used += (size_t)n;
+    }
+    return used;
+}
+
+SteeringScale steeringScheduleLookup(int throttle) {
+    SteeringScale scale = { STEERING_SCALE_ONE, STEERING_SCALE_ONE };
+    int count = scheduleCount;
+    if (count == 0) return scale;
+
+    if (throttle < 0) throttle = -throttle;
+    if (throttle <= schedule[0].throttle) {
+        scale.target = schedule[0].targetScale;
+        scale.step = schedule[0].stepScale;
+        return scale;
+    }
+    for (int i = 1; i < count; i++) {
+        const SteeringSchedulePoint &a = schedule[i - 1];
+        const SteeringSchedulePoint &b = schedule[i];
+        if (throttle <= b.throttle) {
+            int span = b.throttle - a.throttle;
+            int pos = throttle - a.throttle;
+            scale.target = a.targetScale + (b.targetScale - a.targetScale) * pos / span;
+            scale.step = a.stepScale + (b.stepScale - a.stepScale) * pos / span;
+            return scale;
+        }
+    }
+    scale.target = schedule[count - 1].targetScale;
+    scale.step = schedule[count - 1].stepScale;
+    return scale;
+}
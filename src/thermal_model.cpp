@@ -0,0 +1,107 @@
+// --- 馬達與驅動器的集總熱模型 (預測式降額) ---
+#include "hal.h"
+#include "thermal_model.h"
+
+// 單一 tick 的積分時間上限 (任務延遲時避免一次跳太多)
+static const unsigned long THERMAL_MAX_STEP_MS = 100;
+
+void thermalNodeReset(ThermalNode &node) {
+    node.riseQ16 = 0;
+    node.steadyQ16 = 0;
+    node.derate = THERMAL_SCALE_ONE;
+}
+
+// 溫度在 derateStart..cutoff 之間線性降額
+static int derateFor(int32_t riseQ16, const ThermalParams &params) {
+    int32_t startQ16 = (int32_t)(params.derateStartC - THERMAL_AMBIENT_C) << 16;
+    int32_t cutoffQ16 = (int32_t)(params.cutoffC - THERMAL_AMBIENT_C) << 16;
+    if (riseQ16 <= startQ16) return THERMAL_SCALE_ONE;
+    if (riseQ16 >= cutoffQ16) return 0;
+    return (int)((int64_t)(cutoffQ16 - riseQ16) * THERMAL_SCALE_ONE / (cutoffQ16 - startQ16));
+}
+
+int32_t thermalPowerMw(int currentMa, int resistanceMohm) {
+    // P (mW) = I² (mA²) × R (mΩ) / 10^6
+    return (int32_t)((int64_t)currentMa * currentMa * resistanceMohm / 1000000);
+}
+
+int thermalNodeUpdate(ThermalNode &node, const ThermalParams &params, int32_t powerMw,
+                      unsigned long elapsedMs) {
+    if (elapsedMs > THERMAL_MAX_STEP_MS) elapsedMs = THERMAL_MAX_STEP_MS;
+    if (powerMw < 0) powerMw = 0;
+
+    // 穩態溫升 = P × Rth
+    int64_t steadyQ16 = ((int64_t)powerMw * params.rthCPerW << 16) / 1000;
+    const int64_t steadyMaxQ16 = (int64_t)THERMAL_RISE_MAX_C << 16;
+    node.steadyQ16 = (int32_t)(steadyQ16 < steadyMaxQ16 ? steadyQ16 : steadyMaxQ16);
+
+    // 一階趨近: rise += (steady - rise) × dt / tau
+    uint32_t tauMs = params.tauMs > 0 ? params.tauMs : 1;
+    node.riseQ16 += (int32_t)((int64_t)(node.steadyQ16 - node.riseQ16) * (int64_t)elapsedMs / tauMs);
+
+    // 預測: 以目前功率持續 THERMAL_PREDICT_MS 後的溫升 (線性近似，不超過穩態值)
+    unsigned long horizon = THERMAL_PREDICT_MS < tauMs ? THERMAL_PREDICT_MS : tauMs;
+    int32_t predictedQ16 = node.riseQ16
+        + (int32_t)((int64_t)(node.steadyQ16 - node.riseQ16) * (int64_t)horizon / tauMs);
+    int32_t worstQ16 = predictedQ16 > node.riseQ16 ? predictedQ16 : node.riseQ16;
+
+    // 收緊立即生效；放寬時以高 THERMAL_RELEASE_HYSTERESIS_C 的溫度計算，不低於目前的縮放
+    int tightened = derateFor(worstQ16, params);
+    if (tightened < node.derate) {
+        node.derate = tightened;
+    } else {
+        int released = derateFor(worstQ16 + ((int32_t)THERMAL_RELEASE_HYSTERESIS_C << 16), params);
+        if (released > node.derate) node.derate = released;
+    }
+    return node.derate;
+}
+
+// --- 韌體端狀態 ---
+static ThermalNode nodes[THERMAL_NODE_COUNT] = {
+    { 0, 0, THERMAL_SCALE_ONE },
+    { 0, 0, THERMAL_SCALE_ONE },
+    { 0, 0, THERMAL_SCALE_ONE },
+};
+static const char *const NODE_NAMES[THERMAL_NODE_COUNT] = { "T 馬達", "S 馬達", "驅動器" };
+static bool derating[THERMAL_NODE_COUNT] = {};
+
+static void updateNode(ThermalNodeId id, const ThermalParams &params, int32_t powerMw,
+                       unsigned long elapsedMs) {
+    ThermalNode &node = nodes[id];
+    bool limited = thermalNodeUpdate(node, params, powerMw, elapsedMs) < THERMAL_SCALE_ONE;
+    if (limited != derating[id]) {
+        derating[id] = limited;
+        if (limited) {
+            halLog("🌡️ %s 估計溫度 %d°C，開始降低輸出上限\n", NODE_NAMES[id], thermalNodeTempC(node));
+        } else {
+            halLog("🌡️ %s 溫度已回落 (%d°C)，解除降額\n", NODE_NAMES[id], thermalNodeTempC(node));
+        }
+    }
+}
+
+void thermalModelReset() {
+    for (int i = 0; i < THERMAL_NODE_COUNT; i++) {
+        thermalNodeReset(nodes[i]);
+        derating[i] = false;
+    }
+}
+
+void thermalModelTick(int currentT, int currentS, unsigned long elapsedMs) {
+    updateNode(THERMAL_MOTOR_T, THERMAL_MOTOR_DEFAULT,
+               thermalPowerMw(currentT, THERMAL_MOTOR_DEFAULT.resistanceMohm), elapsedMs);
+    updateNode(THERMAL_MOTOR_S, THERMAL_MOTOR_DEFAULT,
+               thermalPowerMw(currentS, THERMAL_MOTOR_DEFAULT.resistanceMohm), elapsedMs);
+    int32_t driverMw = thermalPowerMw(currentT, THERMAL_DRIVER_DEFAULT.resistanceMohm)
+                     + thermalPowerMw(currentS, THERMAL_DRIVER_DEFAULT.resistanceMohm);
+    updateNode(THERMAL_DRIVER, THERMAL_DRIVER_DEFAULT, driverMw, elapsedMs);
+}
+
+int thermalDerate(int motorNode) {
+    int motor = nodes[motorNode].derate;
+    int driver = nodes[THERMAL_DRIVER].derate;
+    return motor < driver ? motor : driver;
+}
+
+const ThermalNode &thermalModelNode(ThermalNodeId id) {
+    return nodes[id];
+}
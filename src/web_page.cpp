@@ -0,0 +1,328 @@
+#include "web_page.h"
+
+// --- HTML 網頁內容 (內嵌虛擬搖桿) ---
+const char HTML_CONTENT[] = R"rawliteral(
+<!DOCTYPE html>
+<html>
+<head>
+    <meta charset="UTF-8">
+    <meta name="viewport" content="width=device-width, initial-scale=1.0">
+    <title>ESP32 馬達搖桿控制</title>
+    <script src="https://cdn.tailwindcss.com"></script>
+    <style>
+        /* 確保全螢幕高度和柔軟的背景色 */
+        body { 
+            background-color: #1f2937; 
+            color: #f9fafb; 
+            font-family: ui-sans-serif, system-ui, -apple-system, BlinkMacSystemFont, "Segoe UI", Roboto, "Helvetica Neue", Arial, "Noto Sans", sans-serif;
+            display: flex; 
+            justify-content: center; 
+            align-items: center; 
+            min-height: 100vh; 
+            margin: 0; 
+            padding: 1rem;
+        }
+        .container { 
+            max-width: 400px; 
+            width: 100%; 
+            padding: 20px; 
+        }
+        /* 搖桿圓盤樣式 */
+        #joystick { 
+            position: relative; 
+            width: 100%;
+            padding-top: 100%; /* 1:1 比例 */
+            margin: 0 auto; 
+            border-radius: 50%; 
+            background: linear-gradient(145deg, #2d3748, #1a202c); 
+            box-shadow: 10px 10px 20px #171d26, -10px -10px 20px #273142, inset 0 0 10px rgba(0,0,0,0.5);
+            touch-action: none; /* 禁用瀏覽器預設的觸摸行為 */
+        }
+        /* 實際可拖曳區域 (內縮 5% 讓邊緣有陰影效果) */
+        #joystick-inner {
+            position: absolute;
+            top: 5%; left: 5%; right: 5%; bottom: 5%;
+            width: 90%;
+            height: 90%;
+        }
+        /* 搖桿中心點 (Thumb) */
+        #joystick-thumb {
+            position: absolute;
+            width: 70px; 
+            height: 70px;
+            top: 50%;
+            left: 50%;
+            transform: translate(-50%, -50%);
+            border-radius: 50%;
+            background: #4f46e5;
+            box-shadow: 0 0 15px #4f46e5, inset 0 0 10px #7c3aed;
+            cursor: grab;
+            transition: box-shadow 0.1s;
+        }
+        #joystick-thumb.active { cursor: grabbing; box-shadow: 0 0 25px #7c3aed, inset 0 0 15px #4f46e5; }
+        /* 狀態文字 */
+        #status { font-weight: 700; text-shadow: 0 0 5px rgba(79, 70, 229, 0.5); }
+    </style>
+</head>
+<body class="p-4">
+    <div class="container bg-gray-800 rounded-xl shadow-2xl">
+        <h1 class="text-3xl font-extrabold text-center text-indigo-400 mb-2">Vibe Racer</h1>
+        <p class="text-center text-sm mb-6 text-gray-400">
+            裝置名稱: <span id="hostname">%HOSTNAME%</span><br>
+            IP: <span id="ipaddress">%IPADDRESS%</span>
+        </p>
+
+        <!-- 搖桿區域 -->
+        <div id="joystick" class="mb-6">
+            <div id="joystick-inner">
+                 <div id="joystick-thumb"></div>
+            </div>
+        </div>
+
+        <!-- 狀態顯示區 -->
+        <div class="text-center space-y-2">
+            <p class="text-xl">狀態: <span id="status" class="text-green-400">靜止</span></p>
+            <p class="text-xs text-gray-500">
+                X (轉向): <span id="val_x">0</span> | Y (速度): <span id="val_y">0</span>
+            </p>
+            <div class="flex justify-center gap-4 pt-4">
+                <button id="estop" class="px-6 py-3 rounded-lg bg-red-600 font-bold">緊急停止</button>
+                <button id="arm" class="px-6 py-3 rounded-lg bg-gray-600 font-bold">解除鎖定</button>
+            </div>
+        </div>
+    </div>
+
+    <script>
+        const joystickContainer = document.getElementById('joystick'); 
+        const joystick = document.getElementById('joystick-inner'); 
+        const thumb = document.getElementById('joystick-thumb');
+        const statusEl = document.getElementById('status');
+        const valXEl = document.getElementById('val_x');
+        const valYEl = document.getElementById('val_y');
+        
+        // Deadzone 設定 (PWM 值，範圍 0-255)
+        const DEADZONE_PWM = 20; 
+
+        // maxRadius 是實際拖曳區域 (joystick-inner) 的半徑
+        const maxRadius = joystick.clientWidth / 2;
+        let isDragging = false;
+        let lastMotorT = 0; // 最新的 T 馬達速度 (待送出)
+        let lastMotorS = 0; // 最新的 S 馬達速度 (待送出)
+        let lastMotorTime = 0; // 最新值的取樣時間 (供 ESP32 端 playout 緩衝使用)
+
+        // --- 傳送排程器設定 ---
+        const KEEPALIVE_MS = 100;       // 拖曳中數值不變時，仍每 100ms 重送一次以維持命令持續性
+        const MIN_INTERVAL_MS = 16;     // 兩次送出的最短間隔 (約一個畫面更新週期)
+        const REQUEST_TIMEOUT_MS = 500; // 請求逾時，避免卡住唯一的在途名額
+        let controlDirty = false;       // 最新值是否尚未送出
+        let requestInFlight = false;    // 是否有請求尚未完成 (最多只允許一個)
+        let lastSendTime = 0;           // 上次送出的時間
+        let rttAvg = MIN_INTERVAL_MS;   // 往返時間 (RTT) 的平滑估計
+
+        // 檢查當前 IP，用於 AP 模式下的絕對路徑
+        const currentIP = document.getElementById('ipaddress').textContent;
+        const baseIp = currentIP.startsWith('192.168.4.1') ? 'http://192.168.4.1' : '';
+
+        // 每次載入頁面產生一個 session 識別碼，命令序號在 session 內遞增，
+        // 讓 ESP32 端可以丟棄延遲抵達 (亂序) 的舊命令
+        const sessionId = Math.floor(Math.random() * 0x7fffffff);
+        let controlSeq = 0;
+        
+        /**
+         * @brief 根據搖桿位置 (Cartesian 座標) 計算並發送馬達速度。
+         * @param rawX X 軸位移 (Cartesian: 右為正)
+         * @param rawY Y 軸位移 (Cartesian: 上為正)
+         */
+        function updateMotorValues(rawX, rawY) {
+            
+            // 1. 計算幅度和角度
+            const distance = Math.sqrt(rawX*rawX + rawY*rawY);
+            const magnitude = Math.min(1.0, distance / maxRadius);
+            const angle = Math.atan2(rawY, rawX);
+            
+            // 2. 計算歸一化後的 X, Y (範圍 -1.0 到 1.0)
+            const normX = magnitude * Math.cos(angle); // 轉向 (Steering)
+            const normY = magnitude * Math.sin(angle); // 速度 (Throttle)
+
+            // 3. 轉換為 -255 到 255 的整數 (注意：ESP32 端會將 255 限制為 230)
+            let speedT = Math.round(normY * 255);
+            let speedS = Math.round(normX * 255);
+
+            // --- 4. 關鍵：在 Web 端實作 Deadzone 邏輯 ---
+            if (Math.abs(speedT) < DEADZONE_PWM) {
+                speedT = 0;
+            }
+            if (Math.abs(speedS) < DEADZONE_PWM) {
+                speedS = 0;
+            }
+            // ----------------------------------------------------
+
+            // 更新顯示
+            valYEl.textContent = speedT; // 顯示 T 馬達 (速度)
+            valXEl.textContent = speedS; // 顯示 S 馬達 (轉向)
+            
+            // 更新狀態文字和顏色
+            let currentStatus = "靜止";
+            let statusColor = "text-green-400";
+            if (Math.abs(speedT) > 0 || Math.abs(speedS) > 0) {
+                 statusColor = "text-yellow-400";
+                 if (speedT > 50 && Math.abs(speedS) < 50) currentStatus = "前進加速中";
+                 else if (speedT < -50 && Math.abs(speedS) < 50) currentStatus = "後退減速中";
+                 else if (speedS > 50) currentStatus = "右轉中";
+                 else if (speedS < -50) currentStatus = "左轉中";
+                 else currentStatus = "移動中";
+            } else {
+                 statusColor = "text-green-400";
+            }
+            statusEl.textContent = currentStatus;
+            statusEl.className = statusColor;
+
+            // 如果數值有變化，交給排程器在下一個可用時機送出最新值
+            if (speedT !== lastMotorT || speedS !== lastMotorS) {
+                lastMotorT = speedT;
+                lastMotorS = speedS;
+                lastMotorTime = performance.now();
+                controlDirty = true;
+            }
+        }
+
+        /**
+         * @brief 傳送排程器 (每個畫面呼叫一次)。
+         * 最多只有一個請求在途，送出的永遠是最新值；送出間隔跟隨量測到的 RTT，
+         * 連線變慢時自動降低頻率，而不是讓請求堆積後延遲抵達。
+         */
+        function schedulerTick(now) {
+            requestAnimationFrame(schedulerTick);
+            if (requestInFlight) return;
+
+            const interval = Math.min(Math.max(rttAvg, MIN_INTERVAL_MS), KEEPALIVE_MS);
+            const elapsed = now - lastSendTime;
+            const keepAlive = isDragging && elapsed >= KEEPALIVE_MS;
+            if (controlDirty && elapsed >= interval) {
+                sendControl(lastMotorT, lastMotorS, lastMotorTime, now);
+            } else if (keepAlive) {
+                // 重送不變的值時以目前時間為取樣時間
+                sendControl(lastMotorT, lastMotorS, now, now);
+            }
+        }
+
+        function sendControl(T, S, sampleTime, now) {
+            controlDirty = false;
+            requestInFlight = true;
+            lastSendTime = now;
+
+            const controller = new AbortController();
+            const timer = setTimeout(() => controller.abort(), REQUEST_TIMEOUT_MS);
+            const start = performance.now();
+
+            controlSeq++;
+            // 使用非同步請求發送馬達速度
+            fetch(`${baseIp}/control?t=${T}&s=${S}&c=${sessionId}&q=${controlSeq}&ts=${Math.round(sampleTime)}`, { method: 'GET', signal: controller.signal })
+                .then(response => {
+                    // RTT 指數平滑 (新樣本權重 1/4)
+                    rttAvg += (performance.now() - start - rttAvg) / 4;
+                    if (!response.ok) {
+                        console.error('Server responded with an error:', response.status);
+                    }
+                })
+                .catch(error => {
+                    // 失敗或逾時：視為連線變慢，並在下一輪重送最新值
+                    rttAvg = Math.min(rttAvg * 2, KEEPALIVE_MS);
+                    controlDirty = true;
+                })
+                .finally(() => {
+                    clearTimeout(timer);
+                    requestInFlight = false;
+                });
+        }
+
+        function resetThumbPosition() {
+            thumb.style.left = '50%';
+            thumb.style.top = '50%';
+            thumb.style.transform = 'translate(-50%, -50%)';
+            thumb.classList.remove('active');
+        }
+
+        function stopMotors() {
+            isDragging = false;
+            resetThumbPosition();
+            // 發送 T=0, S=0，觸發 ESP32 端的即時停止
+            updateMotorValues(0, 0); 
+        }
+
+        function handleMove(e) {
+            e.preventDefault();
+            if (!isDragging) return;
+
+            // 取得觸摸或滑鼠位置
+            const clientX = e.touches ? e.touches[0].clientX : e.clientX;
+            const clientY = e.touches ? e.touches[0].clientY : e.clientY;
+
+            // 取得搖桿容器 (joystick-inner) 的位置
+            const rect = joystick.getBoundingClientRect();
+            const centerX = rect.left + maxRadius;
+            const centerY = rect.top + maxRadius;
+
+            // 1. 原始位移 (CSS 座標: X 向右為正, Y 向下為正)
+            let offsetX = clientX - centerX;
+            let offsetY = clientY - centerY; 
+            
+            // 2. 限制位移在搖桿圓盤內
+            const distance = Math.sqrt(offsetX * offsetX + offsetY * offsetY);
+            if (distance > maxRadius) {
+                const angle = Math.atan2(offsetY, offsetX);
+                offsetX = maxRadius * Math.cos(angle);
+                offsetY = maxRadius * Math.sin(angle);
+            }
+            
+            // 3. 更新搖桿中心點位置 (使用 CSS 座標)
+            const thumbX = maxRadius + offsetX;
+            const thumbY = maxRadius + offsetY; 
+
+            thumb.style.left = `${thumbX}px`;
+            thumb.style.top = `${thumbY}px`;
+            thumb.style.transform = 'translate(-50%, -50%)';
+
+            // 4. 更新馬達值 (使用 Cartesian 座標: Y 軸向上為正)
+            // 將 CSS Y 軸反轉: -offsetY
+            updateMotorValues(offsetX, -offsetY);
+        }
+
+        function handleStart(e) {
+            isDragging = true;
+            thumb.classList.add('active');
+            handleMove(e); // 立即更新一次位置和值
+            // 拖曳期間由排程器定時重送，確保命令持續性
+        }
+
+        function handleEnd() {
+            stopMotors();
+        }
+
+        // --- 緊急停止: 不經過排程器，立即送出 ---
+        document.getElementById('estop').addEventListener('click', () => {
+            stopMotors();
+            fetch(`${baseIp}/estop`, { method: 'GET' }).catch(() => {});
+        });
+        document.getElementById('arm').addEventListener('click', () => {
+            fetch(`${baseIp}/arm`, { method: 'GET' }).catch(() => {});
+        });
+
+        // --- 事件監聽 ---
+        joystick.addEventListener('mousedown', handleStart);
+        document.addEventListener('mousemove', handleMove);
+        document.addEventListener('mouseup', handleEnd);
+
+        joystick.addEventListener('touchstart', handleStart);
+        document.addEventListener('touchmove', handleMove);
+        // 觸摸結束可能在搖桿外，監聽大容器確保停止命令發出
+        joystickContainer.addEventListener('touchend', handleEnd); 
+
+        // 初始化時發送一次停止命令，並啟動傳送排程器
+        stopMotors(); 
+        controlDirty = true;
+        requestAnimationFrame(schedulerTick);
+    </script>
+</body>
+</html>
+)rawliteral";
@@ -0,0 +1,84 @@
+// --- 輪速編碼器 (GPIO 中斷計數) ---
+#include "hal.h"
+#include "wheel_encoder.h"
+
+// --- 中斷端狀態 ---
+static bool present = false;
+static unsigned long glitchFilterUs = ENCODER_GLITCH_US_DEFAULT;
+static volatile uint32_t edgeCount = 0;
+static volatile unsigned long lastEdgeUs = 0;
+static volatile uint32_t glitchCount = 0;
+
+// --- 讀取端狀態 (Ramping 任務) ---
+static bool haveSample = false;
+static uint32_t sampleCount = 0;
+static unsigned long sampleEdgeUs = 0;
+static uint32_t lastSpeed = 0;
+
+void wheelEncoderInit(int pin, unsigned long glitchUs) {
+    edgeCount = 0;
+    lastEdgeUs = 0;
+    glitchCount = 0;
+    haveSample = false;
+    sampleCount = 0;
+    sampleEdgeUs = 0;
+    lastSpeed = 0;
+    present = pin >= 0;
+    if (!present) return;
+    glitchFilterUs = glitchUs;
+    halEdgeInterruptAttach(pin, wheelEncoderEdge);
+    halLog("輪速編碼器已啟用於 GPIO%d (毛刺過濾 %lu us)\n", pin, glitchUs);
+}
+
+bool wheelEncoderPresent() {
+    return present;
+}
+
+void HAL_ISR_ATTR wheelEncoderEdge(unsigned long nowUs) {
+    if (edgeCount != 0 && nowUs - lastEdgeUs < glitchFilterUs) {
+        glitchCount = glitchCount + 1;
+        return;
+    }
+    lastEdgeUs = nowUs;
+    edgeCount = edgeCount + 1;
+}
+
+uint32_t wheelEncoderSpeed(unsigned long nowUs) {
+    // 計數與時間由中斷分別寫入，讀到一致的一組為止
+    uint32_t count;
+    unsigned long edgeUs;
+    do {
+        count = edgeCount;
+        edgeUs = lastEdgeUs;
+    } while (count != edgeCount);
+
+    if (!haveSample) {
+        haveSample = true;
+        sampleCount = count;
+        sampleEdgeUs = edgeUs;
+        return 0;
+    }
+
+    uint32_t edges = count - sampleCount;
+    if (edges > 0 && sampleCount != 0) {
+        // 兩次取樣之間的脈衝數 / 第一個到最後一個脈衝的時間
+        unsigned long span = edgeUs - sampleEdgeUs;
+        lastSpeed = span > 0 ? (uint32_t)((uint64_t)edges * 1000000 / span) : lastSpeed;
+    } else if (edges == 0 && sampleCount != 0) {
+        // 沒有新脈衝: 速度不可能高於「現在才來下一個脈衝」，依經過時間往下修正
+        unsigned long since = nowUs - edgeUs;
+        if (since >= ENCODER_STALL_US) {
+            lastSpeed = 0;
+        } else if (since > 0) {
+            uint32_t bound = (uint32_t)(1000000 / since);
+            if (bound < lastSpeed) lastSpeed = bound;
+        }
+    }
+    sampleCount = count;
+    sampleEdgeUs = edgeUs;
+    return lastSpeed;
+}
+
+uint32_t wheelEncoderGlitchCount() {
+    return glitchCount;
+}
@@ -0,0 +1,122 @@
+// --- 控制核心的 micro-benchmark (Google Benchmark) ---
+// 在主機上比較改動前後的相對成本；絕對數字與 ESP32-C3 (160 MHz RV32) 不同。
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "control_query.h"
+#include "drive_mixer.h"
+#include "duty_ramp.h"
+#include "fake_hal.h"
+#include "motor_control.h"
+#include "session_codec.h"
+
+// 一個完整的 Ramping tick (所有通道、限制與輸出)，目標每 16 個 tick 改變一次
+static void BM_MotorRampTick(benchmark::State &state) {
+    fakeHalReset();
+    motorInit();
+    int tick = 0;
+    for (auto _ : state) {
+        if ((tick & 15) == 0) motorSetTarget((tick * 37) % 511 - 255, (tick * 91) % 511 - 255);
+        fakeHalAdvanceMs(10);
+        motorRampTask();
+        tick++;
+    }
+}
+BENCHMARK(BM_MotorRampTick);
+
+static void BM_ControlQueryFields(benchmark::State &state) {
+    static const char *const names[] = { "t", "s", "c", "q", "ts" };
+    static const char *const values[] = { "-187", "42", "3735928559", "18234", "1699999999" };
+    for (auto _ : state) {
+        ControlQuery query = {};
+        for (int i = 0; i < 5; i++) {
+            controlQueryField(query, names[i], strlen(names[i]), values[i], strlen(values[i]));
+        }
+        benchmark::DoNotOptimize(query);
+    }
+}
+BENCHMARK(BM_ControlQueryFields);
+
+// 對照: 改寫前的路徑以名稱查詢參數 (hasParam/arg 各自建立暫存 String 並線性比對) 再 toInt()。
+// AsyncWebServer 解析出的參數清單兩種路徑相同，以 std::string (同樣有 SSO) 模擬 String
+struct ArgParam {
+    std::string name;
+    std::string value;
+};
+
+static const ArgParam *findArg(const std::vector<ArgParam> &params, const std::string &name) {
+    for (size_t i = 0; i < params.size(); i++) {
+        if (params[i].name == name) return &params[i];
+    }
+    return nullptr;
+}
+
+static void BM_ControlQueryArgLookup(benchmark::State &state) {
+    static const char *const names[] = { "t", "s", "c", "q", "ts" };
+    const std::vector<ArgParam> params = {
+        { "t", "-187" }, { "s", "42" }, { "c", "3735928559" }, { "q", "18234" }, { "ts", "1699999999" },
+    };
+    for (auto _ : state) {
+        long values[5] = {};
+        for (int i = 0; i < 5; i++) {
+            if (!findArg(params, std::string(names[i]))) continue;          // hasParam("t")
+            std::string value = findArg(params, std::string(names[i]))->value;  // arg("t")
+            values[i] = atol(value.c_str());                                // toInt()
+        }
+        benchmark::DoNotOptimize(values);
+    }
+}
+BENCHMARK(BM_ControlQueryArgLookup);
+
+static void BM_RampStepQ8(benchmark::State &state) {
+    RampParams params = { 5 * DUTY_Q8_ONE, 128, 40, 50 };
+    KickState kick = {};
+    int q8 = 0;
+    unsigned long now = 0;
+    for (auto _ : state) {
+        now += 10;
+        q8 = rampStepQ8(q8, (now & 1024) ? 200 : -200, params, kick, now);
+        benchmark::DoNotOptimize(q8);
+    }
+}
+BENCHMARK(BM_RampStepQ8);
+
+static void BM_PwmDitherStep(benchmark::State &state) {
+    PwmDither dither = {};
+    int dutyQ8 = 0;
+    for (auto _ : state) {
+        dutyQ8 = (dutyQ8 + 97) & 0xFFFF;
+        benchmark::DoNotOptimize(pwmDitherStep(dither, dutyQ8, 255, 2047));
+    }
+}
+BENCHMARK(BM_PwmDitherStep);
+
+static void BM_MixerArcade(benchmark::State &state) {
+    MixResult out;
+    int t = -255;
+    for (auto _ : state) {
+        t = t >= 255 ? -255 : t + 3;
+        mixerApply(MIX_ARCADE, t, 255 - t / 2, MOTOR_INPUT_MAX, out);
+        benchmark::DoNotOptimize(out);
+    }
+}
+BENCHMARK(BM_MixerArcade);
+
+static void BM_SessionEncode(benchmark::State &state) {
+    SessionEncoder encoder;
+    sessionEncoderInit(encoder, 2, 0);
+    uint8_t buf[SESSION_RECORD_MAX];
+    unsigned long now = 0;
+    int targets[2] = { 0, 0 };
+    for (auto _ : state) {
+        now += 10;
+        targets[0] = (targets[0] + 7) % 255;
+        targets[1] = -targets[0];
+        benchmark::DoNotOptimize(sessionEncode(encoder, now, targets, buf));
+    }
+}
+BENCHMARK(BM_SessionEncode);
+
+BENCHMARK_MAIN();
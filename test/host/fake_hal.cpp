@@ -0,0 +1,309 @@
+// --- 主機端的假 HAL ---
+#include <malloc.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include "fake_hal.h"
+
+const int FAKE_PWM_CHANNELS = 8;
+const int FAKE_GPIO_PINS = 32;
+
+struct FakePwm {
+    int duty;
+    int resolution;
+    int frequency;
+    uint32_t writes;
+};
+
+static unsigned long simMicros = 0;
+static bool useWallClock = false;
+static FakePwm pwm[FAKE_PWM_CHANNELS];
+static bool gpio[FAKE_GPIO_PINS];
+static std::string logText;
+static bool logEcho = false;
+static std::map<std::string, std::vector<uint8_t> > store;
+static bool storeFailWrites = false;
+static std::map<std::string, std::vector<uint8_t> > flash;
+static FakeI2cDevice i2c = { nullptr, nullptr };
+static bool i2cStarted = false;
+static bool acceptTasks = false;
+
+static int adcMillivolts[FAKE_GPIO_PINS];
+static std::vector<HalAdcInput> adcInputs;
+static uint32_t adcSampleHz = 0;
+static unsigned long adcLastUs = 0;
+static uint32_t adcNextInput = 0;
+
+static size_t heapMinFree = FAKE_HAL_HEAP_SIZE;
+
+void fakeHalReset() {
+    simMicros = 0;
+    memset(pwm, 0, sizeof(pwm));
+    memset(gpio, 0, sizeof(gpio));
+    logText.clear();
+    store.clear();
+    storeFailWrites = false;
+    flash.clear();
+    i2c = FakeI2cDevice{ nullptr, nullptr };
+    i2cStarted = false;
+    acceptTasks = false;
+    memset(adcMillivolts, 0, sizeof(adcMillivolts));
+    adcInputs.clear();
+    adcSampleHz = 0;
+    adcLastUs = 0;
+    adcNextInput = 0;
+}
+
+// --- 時鐘 ---
+void fakeHalAdvanceUs(unsigned long us) {
+    simMicros += us;
+}
+
+void fakeHalAdvanceMs(unsigned long ms) {
+    simMicros += ms * 1000;
+}
+
+void fakeHalUseWallClock(bool wallClock) {
+    useWallClock = wallClock;
+}
+
+unsigned long halMicros() {
+    if (!useWallClock) return simMicros;
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long halMillis() {
+    return halMicros() / 1000;
+}
+
+// --- PWM / GPIO ---
+void halGpioOutput(int pin, bool high) {
+    if (pin >= 0 && pin < FAKE_GPIO_PINS) gpio[pin] = high;
+}
+
+bool halPwmSetup(int channel, int pin, int freq, int resolution) {
+    (void)pin;
+    if (channel < 0 || channel >= FAKE_PWM_CHANNELS || resolution < 1 || resolution > 14) return false;
+    pwm[channel].resolution = resolution;
+    pwm[channel].frequency = freq;
+    return true;
+}
+
+void halPwmWrite(int channel, int duty) {
+    if (channel < 0 || channel >= FAKE_PWM_CHANNELS) return;
+    pwm[channel].duty = duty;
+    pwm[channel].writes++;
+}
+
+int fakeHalPwmDuty(int channel) {
+    return pwm[channel].duty;
+}
+
+int fakeHalPwmResolution(int channel) {
+    return pwm[channel].resolution;
+}
+
+int fakeHalPwmFrequency(int channel) {
+    return pwm[channel].frequency;
+}
+
+uint32_t fakeHalPwmWrites(int channel) {
+    return pwm[channel].writes;
+}
+
+bool fakeHalGpioLevel(int pin) {
+    return gpio[pin];
+}
+
+void halEdgeInterruptAttach(int pin, HalEdgeHandler handler) {
+    // 測試直接呼叫模組的中斷處理函式 (例如 wheelEncoderEdge) 來模擬脈衝
+    (void)pin;
+    (void)handler;
+}
+
+// --- I2C ---
+bool halI2cBegin(int sda, int scl, uint32_t hz) {
+    (void)sda;
+    (void)scl;
+    (void)hz;
+    i2cStarted = i2c.readRegs != nullptr;
+    return i2cStarted;
+}
+
+bool halI2cWriteReg(uint8_t addr, uint8_t reg, uint8_t value) {
+    return i2cStarted && i2c.writeReg != nullptr && i2c.writeReg(addr, reg, value);
+}
+
+bool halI2cReadRegs(uint8_t addr, uint8_t reg, uint8_t *buf, size_t len) {
+    if (len > HAL_I2C_READ_MAX) return false;
+    return i2cStarted && i2c.readRegs(addr, reg, buf, len);
+}
+
+void fakeHalI2cAttach(const FakeI2cDevice &device) {
+    i2c = device;
+}
+
+// --- 背景任務: 主機端不建立執行緒，需要背景任務的模組視同未安裝 ---
+// (fakeHalAcceptTasks(true) 時回報成功，由呼叫端在模擬時鐘上執行任務的單次工作)
+bool halTaskStart(const char *name, HalTaskFn fn, void *arg, uint32_t stackBytes, int priority) {
+    (void)fn;
+    (void)arg;
+    (void)stackBytes;
+    (void)priority;
+    halLog("(host) 不啟動背景任務 %s\n", name);
+    return acceptTasks;
+}
+
+void fakeHalAcceptTasks(bool accept) {
+    acceptTasks = accept;
+}
+
+void halTaskDelayUntil(uint32_t &lastWake, unsigned long periodMs) {
+    lastWake += (uint32_t)periodMs;
+}
+
+// --- ADC ---
+bool halAdcStreamStart(const HalAdcInput *inputs, int count, uint32_t sampleHz) {
+    adcInputs.assign(inputs, inputs + count);
+    adcSampleHz = sampleHz;
+    adcLastUs = halMicros();
+    adcNextInput = 0;
+    return count > 0 && sampleHz > 0;
+}
+
+int halAdcStreamRead(HalAdcSample *out, int max) {
+    if (adcInputs.empty()) return 0;
+    unsigned long now = halMicros();
+    uint64_t due = (uint64_t)(now - adcLastUs) * adcSampleHz / 1000000;
+    int n = due < (uint64_t)max ? (int)due : max;
+    // 只把已產生的樣本所佔的時間扣掉，剩餘的留到下次
+    adcLastUs += (unsigned long)((uint64_t)n * 1000000 / adcSampleHz);
+    for (int i = 0; i < n; i++) {
+        const HalAdcInput &input = adcInputs[adcNextInput];
+        int fullScaleMv = input.atten == HAL_ADC_ATTEN_11DB ? 2500 : 750;
+        int mv = input.pin >= 0 && input.pin < FAKE_GPIO_PINS ? adcMillivolts[input.pin] : 0;
+        int raw = mv * HAL_ADC_RAW_MAX / fullScaleMv;
+        out[i].input = (uint8_t)adcNextInput;
+        out[i].raw = (uint16_t)(raw < 0 ? 0 : raw > HAL_ADC_RAW_MAX ? HAL_ADC_RAW_MAX : raw);
+        adcNextInput = (adcNextInput + 1) % adcInputs.size();
+    }
+    return n;
+}
+
+int halAdcToMillivolts(int raw, HalAdcAtten atten) {
+    int fullScaleMv = atten == HAL_ADC_ATTEN_11DB ? 2500 : 750;
+    return raw * fullScaleMv / HAL_ADC_RAW_MAX;
+}
+
+void fakeHalAdcSetMillivolts(int pin, int mv) {
+    if (pin >= 0 && pin < FAKE_GPIO_PINS) adcMillivolts[pin] = mv;
+}
+
+// --- Log ---
+void halLog(const char *fmt, ...) {
+    char buf[160];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    logText += buf;
+    if (logEcho) fputs(buf, stderr);
+}
+
+const std::string &fakeHalLogText() {
+    return logText;
+}
+
+void fakeHalLogClear() {
+    logText.clear();
+}
+
+void fakeHalLogEcho(bool echo) {
+    logEcho = echo;
+}
+
+// --- 系統狀態 ---
+size_t halHeapFree() {
+    struct mallinfo2 info = mallinfo2();
+    size_t used = info.uordblks < FAKE_HAL_HEAP_SIZE ? info.uordblks : FAKE_HAL_HEAP_SIZE;
+    size_t free = FAKE_HAL_HEAP_SIZE - used;
+    if (free < heapMinFree) heapMinFree = free;
+    return free;
+}
+
+size_t halHeapMinFree() {
+    halHeapFree();
+    return heapMinFree;
+}
+
+size_t halHeapMaxBlock() {
+    return halHeapFree();
+}
+
+// --- NVS ---
+bool halStoreLoad(const char *key, void *data, size_t len) {
+    std::map<std::string, std::vector<uint8_t> >::const_iterator it = store.find(key);
+    if (it == store.end() || it->second.size() != len) return false;
+    memcpy(data, it->second.data(), len);
+    return true;
+}
+
+bool halStoreSave(const char *key, const void *data, size_t len) {
+    if (storeFailWrites) return false;
+    const uint8_t *bytes = (const uint8_t *)data;
+    store[key].assign(bytes, bytes + len);
+    return true;
+}
+
+void fakeHalStoreFailWrites(bool fail) {
+    storeFailWrites = fail;
+}
+
+bool fakeHalStoreHas(const char *key) {
+    return store.count(key) != 0;
+}
+
+// --- flash 分區 ---
+void fakeHalFlashCreate(const char *label, size_t size) {
+    flash[label].assign(size, 0xFF);
+}
+
+bool halFlashRegionOpen(const char *label, HalFlashRegion &region) {
+    std::map<std::string, std::vector<uint8_t> >::iterator it = flash.find(label);
+    if (it == flash.end()) return false;
+    region.handle = &it->second;
+    region.size = it->second.size();
+    return true;
+}
+
+static std::vector<uint8_t> *regionBytes(const HalFlashRegion &region) {
+    return (std::vector<uint8_t> *)region.handle;
+}
+
+bool halFlashRegionErase(const HalFlashRegion &region) {
+    std::vector<uint8_t> *bytes = regionBytes(region);
+    std::fill(bytes->begin(), bytes->end(), 0xFF);
+    return true;
+}
+
+bool halFlashRegionWrite(const HalFlashRegion &region, size_t offset, const void *data, size_t len) {
+    std::vector<uint8_t> *bytes = regionBytes(region);
+    if (offset + len > bytes->size()) return false;
+    const uint8_t *src = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++) (*bytes)[offset + i] &= src[i];
+    return true;
+}
+
+bool halFlashRegionRead(const HalFlashRegion &region, size_t offset, void *data, size_t len) {
+    const std::vector<uint8_t> *bytes = regionBytes(region);
+    if (offset + len > bytes->size()) return false;
+    memcpy(data, bytes->data() + offset, len);
+    return true;
+}
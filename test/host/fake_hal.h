@@ -0,0 +1,53 @@
+#pragma once
+// --- 主機端的假 HAL (test/host 的測試、模擬器與工具共用) ---
+// 實作 include/hal.h 的所有函式：時鐘由呼叫端推進 (或改用真實時鐘)，PWM、GPIO、Log、
+// NVS 與 flash 分區都保存在記憶體中，ADC 與 I2C 的讀值由測試提供。
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include "hal.h"
+
+// 清除所有狀態 (時鐘歸零、PWM/GPIO/Log/NVS/flash/ADC/I2C 全部重設)
+void fakeHalReset();
+
+// --- 時鐘 ---
+void fakeHalAdvanceUs(unsigned long us);
+void fakeHalAdvanceMs(unsigned long ms);
+// true 時 halMillis/halMicros 改用行程啟動後的真實時間 (供本機替身伺服器使用)
+void fakeHalUseWallClock(bool wallClock);
+
+// --- PWM / GPIO ---
+int fakeHalPwmDuty(int channel);            // 最近一次寫入的 duty
+int fakeHalPwmResolution(int channel);      // halPwmSetup 設定的解析度 (bits，未設定為 0)
+int fakeHalPwmFrequency(int channel);
+uint32_t fakeHalPwmWrites(int channel);     // 寫入次數
+bool fakeHalGpioLevel(int pin);
+
+// --- Log ---
+const std::string &fakeHalLogText();        // 自上次 fakeHalLogClear 以來的所有輸出
+void fakeHalLogClear();
+void fakeHalLogEcho(bool echo);             // 同時輸出到 stderr
+
+// --- NVS ---
+void fakeHalStoreFailWrites(bool fail);     // 模擬 NVS 寫入失敗
+bool fakeHalStoreHas(const char *key);
+
+// --- ADC: 每個腳位目前的電壓，halAdcStreamRead 依經過的時間產生對應數量的樣本 ---
+void fakeHalAdcSetMillivolts(int pin, int mv);
+
+// --- flash 分區: 建立一個已擦除的分區 (NOR 語意: 寫入只能把 1 變成 0) ---
+void fakeHalFlashCreate(const char *label, size_t size);
+
+// --- I2C: 以函式模擬匯流排上的裝置 (未設定時所有傳輸都失敗) ---
+struct FakeI2cDevice {
+    bool (*writeReg)(uint8_t addr, uint8_t reg, uint8_t value);
+    bool (*readRegs)(uint8_t addr, uint8_t reg, uint8_t *buf, size_t len);
+};
+void fakeHalI2cAttach(const FakeI2cDevice &device);
+
+// --- 背景任務: true 時 halTaskStart 回報成功但不執行任務函式 (模組的單次工作由呼叫端直接呼叫) ---
+void fakeHalAcceptTasks(bool accept);
+
+// --- heap: 以固定大小的名義 heap 扣除行程目前配置的記憶體 ---
+const size_t FAKE_HAL_HEAP_SIZE = 320 * 1024;
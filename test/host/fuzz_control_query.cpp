@@ -0,0 +1,71 @@
+// --- fuzz target: /control 參數解析 (controlQueryField / parseSaturated*) ---
+// 輸入視為已解碼的查詢字串，依 AsyncWebServer 的方式以 '&' 與第一個 '=' 切割後逐欄解析。
+// 每個名稱與值都複製到剛好大小的 heap 緩衝區 (沒有結尾 '\0')，越界讀取由 AddressSanitizer 抓出；
+// 數值再與以 strtoll 寫成的參考實作比對，結果不同時 abort。
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "control_query.h"
+
+// 參考實作: 格式檢查後以 strtoll 解析並飽和
+static bool referenceInt(const std::string &text, long long low, long long high, bool allowSign, long long *out) {
+    size_t i = 0;
+    if (allowSign && i < text.size() && (text[i] == '-' || text[i] == '+')) i++;
+    if (i == text.size()) return false;
+    for (; i < text.size(); i++) {
+        if (text[i] < '0' || text[i] > '9') return false;
+    }
+    errno = 0;
+    long long value = strtoll(text.c_str(), NULL, 10);
+    *out = value < low ? low : (value > high ? high : value);
+    return true;
+}
+
+static void check(bool condition, const char *what, const std::string &value) {
+    if (condition) return;
+    fprintf(stderr, "fuzz_control_query: %s (value \"%s\")\n", what, value.c_str());
+    abort();
+}
+
+static void checkField(const std::string &name, const std::string &value) {
+    char *nameBuf = (char *)malloc(name.size() + 1);     // +1: 長度為 0 時仍是有效的配置
+    char *valueBuf = (char *)malloc(value.size() + 1);
+    memcpy(nameBuf, name.data(), name.size());
+    memcpy(valueBuf, value.data(), value.size());
+
+    ControlQuery query = {};
+    bool ok = controlQueryField(query, nameBuf, name.size(), valueBuf, value.size());
+    long long expected = 0;
+    if (name == "t" || name == "s") {
+        bool valid = referenceInt(value, CONTROL_VALUE_MIN, CONTROL_VALUE_MAX, true, &expected);
+        check(ok == valid, "t/s 的格式判斷與參考實作不同", value);
+        if (valid) check((name == "t" ? query.t : query.s) == expected, "t/s 的數值與參考實作不同", value);
+    } else if (name == "c" || name == "q" || name == "ts") {
+        bool valid = referenceInt(value, 0, UINT32_MAX, false, &expected);
+        uint32_t got = name == "c" ? query.session : (name == "q" ? query.seq : query.ts);
+        check(ok == valid, "c/q/ts 的格式判斷與參考實作不同", value);
+        if (valid) check(got == (uint32_t)expected, "c/q/ts 的數值與參考實作不同", value);
+    } else {
+        check(ok, "未知欄位應被忽略", name);
+    }
+    free(nameBuf);
+    free(valueBuf);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    std::string text((const char *)data, size);
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find('&', start);
+        if (end == std::string::npos) end = text.size();
+        std::string pair = text.substr(start, end - start);
+        size_t eq = pair.find('=');
+        checkField(pair.substr(0, eq), eq == std::string::npos ? std::string() : pair.substr(eq + 1));
+        start = end + 1;
+    }
+    return 0;
+}
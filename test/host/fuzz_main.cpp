@@ -0,0 +1,89 @@
+// --- 沒有 libFuzzer (例如只有 g++) 時的 fuzz driver ---
+//   fuzz_xxx [-runs=N] [-seed=S] corpus_dir_or_file...
+// 先執行每個語料檔，再以隨機的位元組變異 (覆寫、插入、刪除、接合另一個語料) 產生 N 個輸入。
+// 參數格式與 libFuzzer 相同，CMake 在兩種建置下使用同一組命令。
+
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static bool readFile(const std::string &path, std::string &out) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    char buf[4096];
+    size_t n;
+    out.clear();
+    while ((n = fread(buf, 1, sizeof(buf), file)) > 0) out.append(buf, n);
+    fclose(file);
+    return true;
+}
+
+static void loadCorpus(const char *path, std::vector<std::string> &corpus) {
+    DIR *dir = opendir(path);
+    std::string data;
+    if (!dir) {
+        if (readFile(path, data)) corpus.push_back(data);
+        return;
+    }
+    while (dirent *entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        if (readFile(std::string(path) + "/" + entry->d_name, data)) corpus.push_back(data);
+    }
+    closedir(dir);
+}
+
+// 偏重查詢字串中常見的字元，較容易產生有意義的輸入
+static char randomByte() {
+    static const char common[] = "0123456789+-=&tsqc";
+    return rand() % 4 ? common[rand() % (sizeof(common) - 1)] : (char)(rand() & 0xFF);
+}
+
+static std::string mutate(const std::vector<std::string> &corpus) {
+    std::string data = corpus.empty() ? std::string() : corpus[rand() % corpus.size()];
+    int edits = 1 + rand() % 4;
+    for (int i = 0; i < edits; i++) {
+        size_t at = data.empty() ? 0 : rand() % (data.size() + 1);
+        switch (rand() % 4) {
+            case 0:
+                if (at < data.size()) data[at] = randomByte();
+                break;
+            case 1:
+                data.insert(at, rand() % 8 ? 1 : 20, randomByte());
+                break;
+            case 2:
+                if (at < data.size()) data.erase(at, 1 + rand() % 4);
+                break;
+            default:
+                if (!corpus.empty()) data.insert(at, corpus[rand() % corpus.size()]);
+                break;
+        }
+    }
+    return data;
+}
+
+int main(int argc, char **argv) {
+    long runs = 100000;
+    unsigned seed = 1;
+    std::vector<std::string> corpus;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "-runs=", 6) == 0) runs = atol(argv[i] + 6);
+        else if (strncmp(argv[i], "-seed=", 6) == 0) seed = (unsigned)atol(argv[i] + 6);
+        else if (argv[i][0] != '-') loadCorpus(argv[i], corpus);
+    }
+    srand(seed);
+    for (size_t i = 0; i < corpus.size(); i++) {
+        LLVMFuzzerTestOneInput((const uint8_t *)corpus[i].data(), corpus[i].size());
+    }
+    for (long i = 0; i < runs; i++) {
+        std::string data = mutate(corpus);
+        LLVMFuzzerTestOneInput((const uint8_t *)data.data(), data.size());
+    }
+    printf("%zu 個語料 + %ld 個變異輸入，沒有發現錯誤\n", corpus.size(), runs);
+    return 0;
+}
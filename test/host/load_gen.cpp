@@ -0,0 +1,331 @@
+// --- load_gen: 多個客戶端同時以搖桿的節奏送出 /control，並載入 "/" 與輪詢 /metrics ---
+//   load_gen [--host 127.0.0.1] [--port 80] [--clients 4] [--seconds 10] [--rate 30]
+//            [--page-every 0] [--keep-alive] [--max-error-rate 1.0]
+// 每個客戶端模擬一支手機: 先載入網頁，之後以 --rate Hz 送出帶 c/q/ts 的命令 (與網頁相同的查詢格式)，
+// 搖桿數值隨時間緩慢擺動。結束時輸出吞吐量、延遲分位數、錯誤率、每個命令在線上的位元組數，
+// 以及 /metrics 回報的裝置 heap。可對實車 (裝置 IP) 或本機替身伺服器 (standin_server) 執行。
+// --rate 0 時每個客戶端收到回應後立即送出下一個命令，用於量測最高命令速率。
+// 錯誤率超過 --max-error-rate (%) 時以 1 結束，供 CI 使用。
+
+#include <arpa/inet.h>
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int RESPONSE_TIMEOUT_MS = 2000;
+
+struct Options {
+    std::string host;
+    int port;
+    int clients;
+    double seconds;
+    double rateHz;
+    double pageEvery;       // 每隔幾秒重新載入網頁 (0 = 只在開始時載入一次)
+    bool keepAlive;
+    double maxErrorRate;
+};
+
+struct HttpResult {
+    bool ok;                // 收到完整回應
+    int status;
+    bool serverClose;       // 回應帶 Connection: close (或伺服器已關閉連線)
+    size_t sent;            // 請求的位元組數
+    size_t received;        // 回應的位元組數 (標頭 + 本文)
+    bool connected;         // 這次請求是否新建了連線
+    std::string body;
+};
+
+// 一個客戶端的 HTTP/1.1 連線 (keep-alive 時重用)
+class HttpClient {
+  public:
+    HttpClient(const sockaddr_in &addr, bool keepAlive) : addr_(addr), keepAlive_(keepAlive), fd_(-1) {}
+    ~HttpClient() { disconnect(); }
+
+    HttpResult get(const std::string &target, const std::string &host) {
+        HttpResult result = { false, 0, true, 0, 0, false, std::string() };
+        std::string request = "GET " + target + " HTTP/1.1\r\nHost: " + host +
+                              "\r\nUser-Agent: load_gen\r\nAccept: */*\r\nConnection: " +
+                              (keepAlive_ ? "keep-alive" : "close") + "\r\n\r\n";
+        for (int attempt = 0; attempt < 2; attempt++) {
+            bool reused = fd_ >= 0;
+            if (!reused) {
+                if (!connectNow()) return result;
+                result.connected = true;
+            }
+            bool nothingReceived = true;
+            if (sendAll(request) && readResponse(result, &nothingReceived)) {
+                result.sent = request.size();
+                if (!keepAlive_ || result.serverClose) disconnect();
+                result.ok = true;
+                return result;
+            }
+            disconnect();
+            // 重用的連線可能剛被伺服器以閒置逾時關閉: 完全沒有收到回應時重新連線再試一次
+            if (!reused || !nothingReceived) return result;
+        }
+        return result;
+    }
+
+  private:
+    bool connectNow() {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        timeval tv = { RESPONSE_TIMEOUT_MS / 1000, (RESPONSE_TIMEOUT_MS % 1000) * 1000 };
+        setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        int one = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (connect(fd_, (const sockaddr *)&addr_, sizeof(addr_)) != 0) {
+            disconnect();
+            return false;
+        }
+        return true;
+    }
+
+    void disconnect() {
+        if (fd_ >= 0) close(fd_);
+        fd_ = -1;
+    }
+
+    bool sendAll(const std::string &data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            ssize_t n = send(fd_, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            done += n;
+        }
+        return true;
+    }
+
+    bool readResponse(HttpResult &result, bool *nothingReceived) {
+        std::string data;
+        char buf[4096];
+        size_t headEnd = std::string::npos;
+        long contentLength = -1;
+        while (true) {
+            if (headEnd == std::string::npos) {
+                headEnd = data.find("\r\n\r\n");
+                if (headEnd != std::string::npos) {
+                    std::string head = data.substr(0, headEnd);
+                    for (size_t i = 0; i < head.size(); i++) head[i] = tolower(head[i]);
+                    if (sscanf(head.c_str(), "http/1.%*d %d", &result.status) != 1) return false;
+                    size_t at = head.find("\r\ncontent-length:");
+                    if (at != std::string::npos) contentLength = atol(head.c_str() + at + 17);
+                    result.serverClose = head.find("\r\nconnection: close") != std::string::npos;
+                    // 204 與沒有本文長度且不關閉的回應在標頭後結束
+                    if (result.status == 204 || (contentLength < 0 && !result.serverClose)) contentLength = 0;
+                }
+            }
+            if (headEnd != std::string::npos && contentLength >= 0 &&
+                data.size() >= headEnd + 4 + (size_t)contentLength) {
+                result.received = headEnd + 4 + contentLength;
+                result.body = data.substr(headEnd + 4, contentLength);
+                return true;
+            }
+            ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+            if (n == 0 && headEnd != std::string::npos && contentLength < 0) {
+                // 沒有 Content-Length: 以關閉連線結束本文
+                result.received = data.size();
+                result.body = data.substr(headEnd + 4);
+                result.serverClose = true;
+                return true;
+            }
+            if (n <= 0) return false;
+            *nothingReceived = false;
+            data.append(buf, n);
+        }
+    }
+
+    sockaddr_in addr_;
+    bool keepAlive_;
+    int fd_;
+};
+
+struct ClientStats {
+    std::vector<double> latencyMs;
+    std::vector<double> pageLatencyMs;
+    unsigned long sent = 0;
+    unsigned long errors = 0;
+    unsigned long pageErrors = 0;
+    unsigned long connections = 0;
+    uint64_t bytesSent = 0;
+    uint64_t bytesReceived = 0;
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void runClient(const Options &options, const sockaddr_in &addr, int index,
+                      std::chrono::steady_clock::time_point start, ClientStats &stats) {
+    HttpClient client(addr, options.keepAlive);
+    uint32_t session = (uint32_t)(rand() ^ (index * 2654435761u));
+    uint32_t seq = 0;
+    double nextPage = 0;
+    double phase = index * 0.7;
+    double period = options.rateHz > 0 ? 1.0 / options.rateHz : 0;
+    double next = index * period / options.clients;     // 各客戶端錯開送出時間
+    while (true) {
+        double now = secondsSince(start);
+        if (now >= options.seconds) break;
+        if (now >= nextPage) {
+            HttpResult page = client.get("/", options.host);
+            if (!page.ok || page.status != 200) stats.pageErrors++;
+            else stats.pageLatencyMs.push_back((secondsSince(start) - now) * 1000);
+            nextPage = options.pageEvery > 0 ? now + options.pageEvery : options.seconds;
+            continue;
+        }
+        if (now < next) {
+            usleep((useconds_t)((next - now) * 1e6));
+            continue;
+        }
+        next += period;
+
+        // 搖桿: 油門與轉向以不同週期擺動 (與手指拖曳的速度相近)
+        int t = (int)lround(200 * sin(2 * M_PI * 0.4 * now + phase));
+        int s = (int)lround(255 * sin(2 * M_PI * 0.7 * now + phase * 2));
+        char target[160];
+        snprintf(target, sizeof(target), "/control?t=%d&s=%d&c=%lu&q=%lu&ts=%lu", t, s, (unsigned long)session,
+                 (unsigned long)++seq, (unsigned long)(now * 1000));
+        double sentAt = secondsSince(start);
+        HttpResult result = client.get(target, options.host);
+        stats.sent++;
+        if (result.connected) stats.connections++;
+        if (!result.ok || result.status != 204) {
+            stats.errors++;
+            continue;
+        }
+        stats.latencyMs.push_back((secondsSince(start) - sentAt) * 1000);
+        stats.bytesSent += result.sent;
+        stats.bytesReceived += result.received;
+    }
+}
+
+// /metrics 的 "heap":{"free":N,"min_free":N,...}
+static bool parseHeap(const std::string &json, long *freeBytes, long *minFree) {
+    const char *heap = strstr(json.c_str(), "\"heap\":{\"free\":");
+    return heap && sscanf(heap, "\"heap\":{\"free\":%ld,\"min_free\":%ld", freeBytes, minFree) == 2;
+}
+
+static double percentile(std::vector<double> &values, double p) {
+    if (values.empty()) return 0;
+    size_t index = (size_t)(p / 100 * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+static int usage() {
+    fprintf(stderr, "usage: load_gen [--host H] [--port N] [--clients N] [--seconds S] [--rate HZ] "
+                    "[--page-every S] [--keep-alive] [--max-error-rate PCT]\n");
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    Options options = { "127.0.0.1", 80, 4, 10, 30, 0, false, 1.0 };
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--host") == 0 && hasValue) options.host = argv[++i];
+        else if (strcmp(argv[i], "--port") == 0 && hasValue) options.port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--clients") == 0 && hasValue) options.clients = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seconds") == 0 && hasValue) options.seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--rate") == 0 && hasValue) options.rateHz = atof(argv[++i]);
+        else if (strcmp(argv[i], "--page-every") == 0 && hasValue) options.pageEvery = atof(argv[++i]);
+        else if (strcmp(argv[i], "--keep-alive") == 0) options.keepAlive = true;
+        else if (strcmp(argv[i], "--max-error-rate") == 0 && hasValue) options.maxErrorRate = atof(argv[++i]);
+        else return usage();
+    }
+    if (options.clients < 1 || options.rateHz < 0 || options.seconds <= 0) return usage();
+
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *resolved = NULL;
+    if (getaddrinfo(options.host.c_str(), NULL, &hints, &resolved) != 0 || !resolved) {
+        fprintf(stderr, "無法解析 %s\n", options.host.c_str());
+        return 1;
+    }
+    sockaddr_in addr = *(sockaddr_in *)resolved->ai_addr;
+    addr.sin_port = htons(options.port);
+    freeaddrinfo(resolved);
+
+    // /metrics 每秒輪詢一次 (獨立的連線，不計入命令的統計)
+    long heapStart = -1, heapEnd = -1, heapMin = -1;
+    std::atomic<bool> done(false);
+    std::thread poller([&]() {
+        HttpClient client(addr, false);
+        while (true) {
+            HttpResult result = client.get("/metrics", options.host);
+            long freeBytes, minFree;
+            if (result.ok && result.status == 200 && parseHeap(result.body, &freeBytes, &minFree)) {
+                if (heapStart < 0) heapStart = freeBytes;
+                heapEnd = freeBytes;
+                heapMin = minFree;
+            }
+            if (done) break;
+            for (int i = 0; i < 10 && !done; i++) usleep(100000);
+        }
+    });
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<ClientStats> stats(options.clients);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.clients; i++) {
+        threads.push_back(std::thread(runClient, std::cref(options), std::cref(addr), i, start,
+                                      std::ref(stats[i])));
+    }
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+    double elapsed = secondsSince(start);
+    done = true;
+    poller.join();
+
+    ClientStats total;
+    for (size_t i = 0; i < stats.size(); i++) {
+        total.latencyMs.insert(total.latencyMs.end(), stats[i].latencyMs.begin(), stats[i].latencyMs.end());
+        total.pageLatencyMs.insert(total.pageLatencyMs.end(), stats[i].pageLatencyMs.begin(),
+                                   stats[i].pageLatencyMs.end());
+        total.sent += stats[i].sent;
+        total.errors += stats[i].errors;
+        total.pageErrors += stats[i].pageErrors;
+        total.connections += stats[i].connections;
+        total.bytesSent += stats[i].bytesSent;
+        total.bytesReceived += stats[i].bytesReceived;
+    }
+    unsigned long ok = total.sent - total.errors;
+    double errorRate = total.sent > 0 ? 100.0 * total.errors / total.sent : 100.0;
+
+    char rate[32];
+    if (options.rateHz > 0) snprintf(rate, sizeof(rate), "%.0f Hz", options.rateHz);
+    else snprintf(rate, sizeof(rate), "不限速");
+    printf("%s:%d, %d 個客戶端 × %s, %.1f s, 請求 %s\n", options.host.c_str(), options.port, options.clients, rate,
+           elapsed, options.keepAlive ? "keep-alive" : "Connection: close");
+    printf("/control: 送出 %lu, 成功 %lu, 錯誤 %lu (%.2f %%), 吞吐量 %.1f 命令/s\n", total.sent, ok,
+           total.errors, errorRate, ok / elapsed);
+    printf("延遲 (ms): p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n", percentile(total.latencyMs, 50),
+           percentile(total.latencyMs, 90), percentile(total.latencyMs, 99), percentile(total.latencyMs, 100));
+    if (ok > 0) {
+        printf("每個命令: 送出 %.0f + 接收 %.0f bytes (HTTP)，新建連線 %.2f 次\n", (double)total.bytesSent / ok,
+               (double)total.bytesReceived / ok, (double)total.connections / ok);
+    }
+    printf("/: 載入 %zu 次, 錯誤 %lu, 延遲 p50 %.2f ms\n", total.pageLatencyMs.size(), total.pageErrors,
+           percentile(total.pageLatencyMs, 50));
+    if (heapStart >= 0) {
+        printf("裝置 heap: 開始 %ld, 結束 %ld, 最低 %ld bytes\n", heapStart, heapEnd, heapMin);
+    } else {
+        printf("裝置 heap: 無法讀取 /metrics\n");
+    }
+    return errorRate > options.maxErrorRate || total.pageErrors > 0 ? 1 : 0;
+}
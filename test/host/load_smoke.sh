@@ -0,0 +1,28 @@
+#!/bin/sh
+# 在隨機埠啟動替身伺服器，對它執行 load_gen (其餘參數原樣傳給 load_gen)，回傳 load_gen 的結果
+# 用法: load_smoke.sh <standin_server> <load_gen> [load_gen 參數...]
+server=$1
+loadgen=$2
+shift 2
+
+portfile=$(mktemp)
+"$server" --port 0 --port-file "$portfile" --seconds 60 &
+pid=$!
+i=0
+while [ ! -s "$portfile" ] && [ $i -lt 50 ]; do
+    sleep 0.1
+    i=$((i + 1))
+done
+if [ ! -s "$portfile" ]; then
+    echo "standin_server 沒有啟動" >&2
+    kill $pid 2>/dev/null
+    rm -f "$portfile"
+    exit 1
+fi
+
+"$loadgen" --port "$(cat "$portfile")" "$@"
+rc=$?
+kill $pid 2>/dev/null
+wait $pid 2>/dev/null
+rm -f "$portfile"
+exit $rc
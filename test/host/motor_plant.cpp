@@ -0,0 +1,92 @@
+#include "motor_plant.h"
+#include <math.h>
+
+// 130 型馬達、2S 電池: 無載約 15000 rpm、堵轉約 3A，機械時間常數約 75 ms (0.5 kg 車重、1:30 齒輪)
+const MotorPlantParams PLANT_DRIVE_130 = {
+    2.5, 0.35e-3, 0.0045, 6.0e-7, 2.0e-7, 3.0e-4, 0.8e-3, 0.0, 0.0,
+};
+
+// 轉向: 小型減速馬達推動齒條，馬達軸約 ±25 rad 打到端點；回正彈簧在端點約為堵轉轉矩的 1/8，
+// 剛好讓預設的 holding duty (快衰減) 加上靜摩擦可以停在端點
+const MotorPlantParams PLANT_STEERING_SERVO = {
+    4.0, 0.5e-3, 0.003, 1.0e-7, 1.0e-7, 3.0e-4, 5.0e-4, 3.0e-5, 25.0,
+};
+
+const SupplyParams SUPPLY_2S_LIION = { 8.0, 0.2 };
+
+void motorPlantReset(MotorPlantState &state) {
+    state.currentA = 0;
+    state.omegaRadS = 0;
+    state.angleRad = 0;
+    state.supplyA = 0;
+}
+
+static double sign(double value) {
+    return value > 0 ? 1.0 : (value < 0 ? -1.0 : 0.0);
+}
+
+// 端電壓為 v 時經過 t 秒後的繞組電流 (這段時間內轉速視為不變，以解析解避免數值發散)
+static double currentAfter(double i0, double v, double emf, const MotorPlantParams &params, double t) {
+    double iInf = (v - emf) / params.resistanceOhm;
+    return iInf + (i0 - iInf) * exp(-t * params.resistanceOhm / params.inductanceH);
+}
+
+void motorPlantStep(MotorPlantState &state, const MotorPlantParams &params, double highFwd,
+                    double highRev, double supplyV, double dtS) {
+    double emf = params.keVsPerRad * state.omegaRadS;
+    double lo = highFwd < highRev ? highFwd : highRev;
+    double hi = highFwd < highRev ? highRev : highFwd;
+    double i = state.currentA;
+    double charge = 0;          // ∫ i dt (轉矩使用這一步的平均電流)
+    double supplyCharge = 0;    // ∫ 電源電流 dt
+
+    // 1) 兩腳都 HIGH: 短路
+    if (lo > 0) {
+        double next = currentAfter(i, 0, emf, params, lo * dtS);
+        charge += (i + next) / 2 * lo * dtS;
+        i = next;
+    }
+    // 2) 只有一腳 HIGH: 接上電源 (IN1 HIGH 為正向)
+    if (hi > lo) {
+        double polarity = highFwd > highRev ? 1.0 : -1.0;
+        double next = currentAfter(i, polarity * supplyV, emf, params, (hi - lo) * dtS);
+        charge += (i + next) / 2 * (hi - lo) * dtS;
+        supplyCharge += polarity * (i + next) / 2 * (hi - lo) * dtS;
+        i = next;
+    }
+    // 3) 兩腳都 LOW: 開路，電流經本體二極體回灌電源，歸零後停止
+    if (hi < 1 && i != 0) {
+        double next = currentAfter(i, -sign(i) * supplyV, emf, params, (1 - hi) * dtS);
+        if (sign(next) != sign(i)) next = 0;
+        charge += (i + next) / 2 * (1 - hi) * dtS;
+        supplyCharge -= fabs(i + next) / 2 * (1 - hi) * dtS;
+        i = next;
+    }
+    state.currentA = i;
+    state.supplyA = supplyCharge / dtS;
+
+    // 機械: 靜止時驅動轉矩需超過靜摩擦才開始轉動；轉動中摩擦不會讓轉向反轉
+    double drive = params.keVsPerRad * charge / dtS - params.springNmPerRad * state.angleRad;
+    double omega = state.omegaRadS;
+    if (omega == 0 && fabs(drive) <= params.staticNm) return;
+    double direction = omega != 0 ? sign(omega) : sign(drive);
+    double friction = params.coulombNm * direction + params.viscousNmsPerRad * omega;
+    double next = omega + (drive - friction) / params.inertiaKgM2 * dtS;
+    if (omega != 0 && sign(next) != sign(omega)) next = 0;
+    state.omegaRadS = next;
+    state.angleRad += next * dtS;
+
+    // 行程限制: 打到端點後角度固定，朝外的速度歸零 (堵轉)
+    if (params.travelRad > 0 && fabs(state.angleRad) >= params.travelRad) {
+        state.angleRad = sign(state.angleRad) * params.travelRad;
+        if (sign(state.omegaRadS) == sign(state.angleRad)) state.omegaRadS = 0;
+    }
+}
+
+double supplyVoltage(const SupplyParams &supply, double totalSupplyA) {
+    return supply.openCircuitV - supply.internalOhm * totalSupplyA;
+}
+
+double motorPlantRpm(const MotorPlantState &state) {
+    return state.omegaRadS * 60.0 / (2.0 * M_PI);
+}
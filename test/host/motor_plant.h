@@ -0,0 +1,48 @@
+#pragma once
+// --- 有刷直流馬達 + H 橋的主機端模型 (供 Ramping 模擬器使用) ---
+// 電氣: L di/dt = v - R i - Ke ω；機械: J dω/dt = Kt i - b ω - 摩擦 - 回正彈簧。
+// H 橋以一個 PWM 週期內兩個輸入腳的 HIGH 比例描述 (LEDC 各通道的週期起點對齊)：
+//   兩腳都 HIGH → 短路 (煞車)；只有一腳 HIGH → 接上電源；兩腳都 LOW → 開路，
+//   電流經本體二極體回灌電源直到歸零 (快衰減)。
+// 電源以「開路電壓 - 內阻 × 電流」模擬壓降，所有馬達共用。
+
+struct MotorPlantParams {
+    double resistanceOhm;       // 繞組電阻
+    double inductanceH;         // 繞組電感 (電氣時間常數 = L / R)
+    double keVsPerRad;          // 反電動勢常數 (= 轉矩常數 Kt，SI 單位)
+    double inertiaKgM2;         // 換算到馬達軸的總慣量 (含齒輪與車體)
+    double viscousNmsPerRad;    // 黏滯摩擦
+    double coulombNm;           // 動摩擦
+    double staticNm;            // 靜摩擦 (啟動需要克服的轉矩)
+    double springNmPerRad;      // 回正彈簧 (轉向機構，0 = 無)
+    double travelRad;           // 行程限制 (馬達軸角度，0 = 無限制)
+};
+
+struct SupplyParams {
+    double openCircuitV;        // 電池開路電壓
+    double internalOhm;         // 電池內阻 + 配線
+};
+
+struct MotorPlantState {
+    double currentA;            // 繞組電流 (正值 = 正轉方向)
+    double omegaRadS;           // 馬達軸角速度
+    double angleRad;            // 馬達軸角度 (只有設定行程限制時有意義)
+    double supplyA;             // 上一步從電源取用的平均電流 (回灌為負值)
+};
+
+// 2S 鋰電池上的 130 型速度馬達 (已換算齒輪與車重) 與小型轉向馬達 (附回正彈簧與端點)
+extern const MotorPlantParams PLANT_DRIVE_130;
+extern const MotorPlantParams PLANT_STEERING_SERVO;
+extern const SupplyParams SUPPLY_2S_LIION;
+
+void motorPlantReset(MotorPlantState &state);
+
+// 推進一個 PWM 週期 (dtS 秒)。highFwd/highRev 為兩個輸入腳在週期中 HIGH 的比例 (0..1)，
+// supplyV 為此步的電源電壓 (由呼叫端依所有馬達的電流計算)
+void motorPlantStep(MotorPlantState &state, const MotorPlantParams &params, double highFwd,
+                    double highRev, double supplyV, double dtS);
+
+// 所有馬達共用的電源電壓
+double supplyVoltage(const SupplyParams &supply, double totalSupplyA);
+
+double motorPlantRpm(const MotorPlantState &state);
@@ -0,0 +1,380 @@
+#include "ramp_sim.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fake_hal.h"
+#include "imu_gyro.h"
+#include "link_supervisor.h"
+#include "motor_config.h"
+#include "motor_control.h"
+#include "motor_plant.h"
+#include "wheel_encoder.h"
+
+const unsigned long RESEND_MS = 100;            // 網頁在搖桿沒有移動時重送命令的間隔
+const unsigned long SEGMENT_MIN_MS = 250;       // 短於此值的段落來不及穩定，不列入統計
+const unsigned long SEGMENT_FINAL_MS = 50;      // 段落結束前取平均作為最終值的時間
+
+bool rampSimLoadTrace(const char *path, std::vector<JoystickSample> &trace, std::string &error) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        error = std::string("無法開啟 ") + path;
+        return false;
+    }
+    trace.clear();
+    char line[128];
+    int lineNo = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), file)) {
+        lineNo++;
+        if (line[0] == '#' || line[0] == '\n' || strncmp(line, "ms,", 3) == 0) continue;
+        JoystickSample sample;
+        if (sscanf(line, "%lu,%d,%d", &sample.ms, &sample.t, &sample.s) != 3 ||
+            (!trace.empty() && sample.ms < trace.back().ms)) {
+            error = std::string(path) + ": 第 " + std::to_string(lineNo) + " 行格式錯誤";
+            ok = false;
+            break;
+        }
+        trace.push_back(sample);
+    }
+    fclose(file);
+    if (ok && trace.empty()) {
+        error = std::string(path) + ": 沒有任何命令";
+        ok = false;
+    }
+    return ok;
+}
+
+// --- 車輛偏航與模擬的 MPU-6050 (只實作 imu_gyro 使用的暫存器) ---
+const double YAW_DPS_PER_KRPM = 30;         // 轉向打到底時每 1000 rpm 的偏航率 (°/s)
+const int GYRO_SIM_BIAS_RAW = 25;           // 感測器的零點偏移 (原始值)
+const size_t GYRO_SIM_FIFO_BYTES = 1024;
+const unsigned long GYRO_SIM_POLL_MS = 10;  // 與韌體的陀螺儀任務相同的週期
+
+static std::vector<uint8_t> gyroFifo;
+static bool gyroOverflow = false;
+
+static bool gyroSimWrite(uint8_t addr, uint8_t reg, uint8_t value) {
+    if (addr != 0x68) return false;
+    if (reg == 0x6A && (value & 0x04)) gyroFifo.clear();    // USER_CTRL: FIFO_RESET
+    return true;
+}
+
+static bool gyroSimRead(uint8_t addr, uint8_t reg, uint8_t *buf, size_t len) {
+    if (addr != 0x68) return false;
+    if (reg == 0x75) {              // WHO_AM_I
+        buf[0] = 0x68;
+    } else if (reg == 0x3A) {       // INT_STATUS: 讀取後清除
+        buf[0] = gyroOverflow ? 0x10 : 0;
+        gyroOverflow = false;
+    } else if (reg == 0x72 && len == 2) {   // FIFO_COUNT_H/L
+        buf[0] = (uint8_t)(gyroFifo.size() >> 8);
+        buf[1] = (uint8_t)gyroFifo.size();
+    } else if (reg == 0x74 && len <= gyroFifo.size()) {     // FIFO_R_W
+        memcpy(buf, gyroFifo.data(), len);
+        gyroFifo.erase(gyroFifo.begin(), gyroFifo.begin() + len);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// 感測器內部的 1 kHz 取樣 (FIFO 滿了之後的樣本遺失並設定溢位旗標)
+static void gyroSimSample(double yawDps) {
+    long raw = lround(yawDps * GYRO_LSB_PER_DPS_X10 / 10) + GYRO_SIM_BIAS_RAW;
+    int16_t value = (int16_t)(raw > 32767 ? 32767 : raw < -32768 ? -32768 : raw);
+    if (gyroFifo.size() + 2 > GYRO_SIM_FIFO_BYTES) {
+        gyroOverflow = true;
+        return;
+    }
+    gyroFifo.push_back((uint8_t)((uint16_t)value >> 8));
+    gyroFifo.push_back((uint8_t)value);
+}
+
+static void sendCommand(int t, int s) {
+    linkSupervisorOnCommand(halMillis(), t != 0 || s != 0);
+    motorSetTarget(t, s);
+}
+
+bool rampSimRun(const std::vector<JoystickSample> &trace, const char *configJson, RampSimSeries &series) {
+    RampSimOptions options = {};
+    options.configJson = configJson;
+    return rampSimRun(trace, options, series);
+}
+
+bool rampSimRun(const std::vector<JoystickSample> &trace, const RampSimOptions &options, RampSimSeries &series) {
+    fakeHalReset();
+    motorInit();
+    // 編碼器: motorInit 依 ENCODER_PIN (主機上未安裝) 停用，這裡再以任意腳位啟用
+    if (options.encoderPulsesPerRev > 0) wheelEncoderInit(0, ENCODER_GLITCH_US_DEFAULT);
+    // 陀螺儀: 同樣以任意腳位啟用，任務的工作 (gyroPoll) 由模擬迴圈依週期呼叫
+    gyroFifo.clear();
+    gyroOverflow = false;
+    if (options.gyro) {
+        fakeHalI2cAttach(FakeI2cDevice{ gyroSimWrite, gyroSimRead });
+        fakeHalAcceptTasks(true);
+        gyroInit(0, 1, 1);
+    }
+    const char *configJson = options.configJson;
+    if (configJson && configJson[0]) {
+        MotorConfig config;
+        uint32_t version;
+        motorConfigSnapshot(config, version);
+        if (!motorConfigParseJson(config, configJson, strlen(configJson)) ||
+            motorConfigPublish(config, false) != MOTOR_CONFIG_APPLIED) {
+            return false;
+        }
+    }
+    sendCommand(0, 0);
+
+    int channels = motorChannelCount();
+    if (channels > RAMP_SIM_MAX_CHANNELS) channels = RAMP_SIM_MAX_CHANNELS;
+    series.channels = channels;
+    series.samples.clear();
+    MotorPlantState plants[RAMP_SIM_MAX_CHANNELS];
+    const MotorPlantParams *params[RAMP_SIM_MAX_CHANNELS];
+    double peakMa[RAMP_SIM_MAX_CHANNELS] = {};
+    for (int i = 0; i < channels; i++) {
+        const MotorChannelDesc &desc = motorChannelDesc(i);
+        params[i] = desc.role == MOTOR_S ? &PLANT_STEERING_SERVO : &PLANT_DRIVE_130;
+        series.names[i] = std::string(params[i]->travelRad > 0 ? "pos_" : "rpm_") + desc.name;
+        motorPlantReset(plants[i]);
+    }
+
+    unsigned long endMs = (trace.empty() ? 0 : trace.back().ms) + RAMP_SIM_TAIL_MS;
+    size_t next = 0;
+    int lastT = 0, lastS = 0;
+    unsigned long lastSendMs = 0;
+    double supplyA = 0;
+    double supplyV = SUPPLY_2S_LIION.openCircuitV;
+    double encoderTurn = 0;     // 編碼器上次產生脈衝後轉過的角度 (不分方向)
+    double headingDeg = 0;
+    const double encoderPitch = options.encoderPulsesPerRev > 0 ? 2 * M_PI / options.encoderPulsesPerRev : 0;
+    for (unsigned long ms = 0; ms <= endMs; ms++) {
+        bool send = ms - lastSendMs >= RESEND_MS;
+        while (next < trace.size() && trace[next].ms <= ms) {
+            lastT = trace[next].t;
+            lastS = trace[next].s;
+            send = true;
+            next++;
+        }
+        if (send) {
+            sendCommand(lastT, lastS);
+            lastSendMs = ms;
+        }
+        motorRampTask();
+        if (options.gyro && ms % GYRO_SIM_POLL_MS == 0) gyroPoll();
+
+        if (ms % RAMP_SIM_SAMPLE_MS == 0) {
+            RampSimSample sample;
+            sample.ms = ms;
+            sample.supplyV = supplyV;
+            sample.headingDeg = headingDeg;
+            for (int i = 0; i < channels; i++) {
+                const MotorPlantState &plant = plants[i];
+                sample.output[i] = motorChannelState(i).output;
+                sample.value[i] = params[i]->travelRad > 0 ? plant.angleRad / params[i]->travelRad * 100
+                                                           : motorPlantRpm(plant);
+                sample.currentMa[i] = peakMa[i];
+                peakMa[i] = fabs(plant.currentA) * 1000;
+            }
+            series.samples.push_back(sample);
+        }
+
+        // 下一個 1 ms: 每一步為一個 PWM 週期 (LEDC 的 duty 只在 Ramping tick 改變)；
+        // 電源電壓以上一個 1 ms 的平均電流計算
+        supplyV = supplyVoltage(SUPPLY_2S_LIION, supplyA);
+        supplyA = 0;
+        for (int i = 0; i < channels; i++) {
+            const MotorChannelDesc &desc = motorChannelDesc(i);
+            double full = motorChannelState(i).pwmMax;
+            double highFwd = fakeHalPwmDuty(desc.ledcFwd) / full;
+            double highRev = fakeHalPwmDuty(desc.ledcRev) / full;
+            int periods = (int)(fakeHalPwmFrequency(desc.ledcFwd) / 1000);
+            if (periods < 1) periods = 1;
+            bool stalled = i == 0 && ms >= options.stallFromMs && ms < options.stallToMs;
+            for (int k = 0; k < periods; k++) {
+                double angle = plants[i].angleRad;
+                motorPlantStep(plants[i], *params[i], highFwd, highRev, supplyV, 1e-3 / periods);
+                if (stalled) {
+                    plants[i].omegaRadS = 0;
+                    plants[i].angleRad = angle;
+                }
+                supplyA += plants[i].supplyA / periods;
+                double ma = fabs(plants[i].currentA) * 1000;
+                if (ma > peakMa[i]) peakMa[i] = ma;
+
+                // 每轉過一個脈衝間距產生一個上升緣，時間為這個 PWM 週期結束時
+                if (i == 0 && encoderPitch > 0) {
+                    encoderTurn += fabs(plants[i].angleRad - angle);
+                    while (encoderTurn >= encoderPitch) {
+                        encoderTurn -= encoderPitch;
+                        wheelEncoderEdge(halMicros() + (unsigned long)((k + 1) * 1000 / periods));
+                    }
+                }
+            }
+        }
+
+        // 偏航: 第一個通道的轉速 × 轉向行程 (沒有轉向通道時只有干擾)
+        double krpm = motorPlantRpm(plants[0]) / 1000;
+        double steer = 0;
+        for (int i = 0; i < channels; i++) {
+            if (params[i]->travelRad > 0) steer = plants[i].angleRad / params[i]->travelRad;
+        }
+        double yawDps = YAW_DPS_PER_KRPM * krpm * steer + options.yawDisturbanceDps * krpm / 10;
+        headingDeg += yawDps / 1000;
+        if (options.gyro) gyroSimSample(yawDps);
+        fakeHalAdvanceMs(1);
+    }
+    return true;
+}
+
+// 段落的變化量低於此值時視為沒有響應 (例如只改變另一個軸)
+static double significantChange(const std::string &name) {
+    return name.compare(0, 4, "rpm_") == 0 ? 500.0 : 5.0;
+}
+
+void rampSimMetrics(const std::vector<JoystickSample> &trace, const RampSimSeries &series,
+                    RampSimMetrics &metrics) {
+    metrics.segments.clear();
+    metrics.minSupplyV = 1e9;
+    for (int c = 0; c < series.channels; c++) {
+        metrics.timeToSpeedMs[c] = 0;
+        metrics.overshootPct[c] = 0;
+        metrics.peakCurrentMa[c] = 0;
+    }
+    const std::vector<RampSimSample> &samples = series.samples;
+    for (size_t i = 0; i < samples.size(); i++) {
+        for (int c = 0; c < series.channels; c++) {
+            if (samples[i].currentMa[c] > metrics.peakCurrentMa[c]) metrics.peakCurrentMa[c] = samples[i].currentMa[c];
+        }
+        if (samples[i].supplyV < metrics.minSupplyV) metrics.minSupplyV = samples[i].supplyV;
+    }
+    if (samples.empty()) return;
+
+    // 段落: 命令改變的時間點到下一次改變 (最後一段到模擬結束)
+    std::vector<unsigned long> changes;
+    int lastT = 0, lastS = 0;
+    for (size_t i = 0; i < trace.size(); i++) {
+        if (trace[i].t == lastT && trace[i].s == lastS) continue;
+        lastT = trace[i].t;
+        lastS = trace[i].s;
+        changes.push_back(trace[i].ms);
+    }
+    unsigned long endMs = samples.back().ms + 1;
+    for (size_t k = 0; k < changes.size(); k++) {
+        unsigned long startMs = changes[k];
+        unsigned long stopMs = k + 1 < changes.size() ? changes[k + 1] : endMs;
+        if (stopMs - startMs < SEGMENT_MIN_MS) continue;
+        size_t first = 0;
+        while (first < samples.size() && samples[first].ms < startMs) first++;
+        size_t last = first;
+        while (last + 1 < samples.size() && samples[last + 1].ms < stopMs) last++;
+
+        for (int c = 0; c < series.channels; c++) {
+            double sum = 0;
+            int count = 0;
+            for (size_t i = first; i <= last; i++) {
+                if (samples[i].ms + SEGMENT_FINAL_MS > stopMs) {
+                    sum += samples[i].value[c];
+                    count++;
+                }
+            }
+            RampSimSegment segment;
+            segment.channel = c;
+            segment.startMs = startMs;
+            segment.from = samples[first].value[c];
+            segment.to = count > 0 ? sum / count : segment.from;
+            double change = segment.to - segment.from;
+            if (fabs(change) < significantChange(series.names[c])) continue;
+
+            segment.timeToSpeedMs = stopMs - startMs;
+            segment.overshootPct = 0;
+            bool reached = false;
+            for (size_t i = first; i <= last; i++) {
+                double progress = (samples[i].value[c] - segment.from) / change;
+                if (!reached && progress >= 0.9) {
+                    segment.timeToSpeedMs = samples[i].ms - startMs;
+                    reached = true;
+                }
+                double over = (progress - 1) * 100;
+                if (over > segment.overshootPct) segment.overshootPct = over;
+            }
+            metrics.segments.push_back(segment);
+            if (segment.timeToSpeedMs > metrics.timeToSpeedMs[c]) metrics.timeToSpeedMs[c] = segment.timeToSpeedMs;
+            if (segment.overshootPct > metrics.overshootPct[c]) metrics.overshootPct[c] = segment.overshootPct;
+        }
+    }
+}
+
+bool rampSimWriteSeries(const char *path, const RampSimSeries &series) {
+    FILE *file = fopen(path, "w");
+    if (!file) return false;
+    fprintf(file, "# ramp_sim 產生的 golden trace (以 ramp_sim --golden 重新產生)\n");
+    fprintf(file, "ms");
+    for (int c = 0; c < series.channels; c++) {
+        const char *name = series.names[c].c_str() + 4;
+        fprintf(file, ",out_%s,%s,ma_%s", name, series.names[c].c_str(), name);
+    }
+    fprintf(file, ",supply_v\n");
+    for (size_t i = 0; i < series.samples.size(); i++) {
+        const RampSimSample &sample = series.samples[i];
+        fprintf(file, "%lu", sample.ms);
+        for (int c = 0; c < series.channels; c++) {
+            fprintf(file, ",%d,%.1f,%.0f", sample.output[c], sample.value[c], sample.currentMa[c]);
+        }
+        fprintf(file, ",%.3f\n", sample.supplyV);
+    }
+    return fclose(file) == 0;
+}
+
+bool rampSimReadSeries(const char *path, RampSimSeries &series, std::string &error) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        error = std::string("無法開啟 ") + path;
+        return false;
+    }
+    series.channels = 0;
+    series.samples.clear();
+    char line[512];
+    bool header = false;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        if (line[0] == '#') continue;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (!header) {
+            // ms,out_X,<rpm|pos>_X,ma_X,...,supply_v
+            header = true;
+            int column = 0;
+            for (char *field = strtok(line, ","); field; field = strtok(NULL, ","), column++) {
+                if (column % 3 == 2 && series.channels < RAMP_SIM_MAX_CHANNELS &&
+                    strncmp(field, "supply", 6) != 0) {
+                    series.names[series.channels++] = field;
+                }
+            }
+            continue;
+        }
+        RampSimSample sample;
+        char *cursor = line;
+        sample.ms = strtoul(cursor, &cursor, 10);
+        for (int c = 0; c < series.channels && ok; c++) {
+            ok = *cursor++ == ',';
+            sample.output[c] = (int)strtol(cursor, &cursor, 10);
+            ok = ok && *cursor++ == ',';
+            sample.value[c] = strtod(cursor, &cursor);
+            ok = ok && *cursor++ == ',';
+            sample.currentMa[c] = strtod(cursor, &cursor);
+        }
+        ok = ok && *cursor++ == ',';
+        sample.supplyV = strtod(cursor, &cursor);
+        sample.headingDeg = 0;
+        if (!ok) error = std::string(path) + ": 格式錯誤 (ms " + std::to_string(sample.ms) + ")";
+        else series.samples.push_back(sample);
+    }
+    fclose(file);
+    if (ok && series.channels == 0) {
+        error = std::string(path) + ": 沒有標題列";
+        ok = false;
+    }
+    return ok;
+}
@@ -0,0 +1,79 @@
+#pragma once
+// --- Ramping 模擬器: 真正的 motor_control (假 HAL 的模擬時鐘) 驅動 motor_plant 的馬達模型 ---
+// 依搖桿紀錄 (trace) 的時間點呼叫 motorSetTarget，並與網頁一樣每 100 ms 重送最後的命令；
+// 每個 PWM 週期依各通道 LEDC 的 duty 推進馬達模型，每 10 ms 取樣一次輸出、速度與電流。
+// T 馬達以轉速 (rpm) 評估，S 馬達以轉向行程 (% ，±100 為端點) 評估。
+// 車輛的偏航率與 T 轉速 × S 行程成正比 (加上選用的干擾)，安裝陀螺儀時以模擬的 MPU-6050 FIFO 回饋。
+//
+// trace 檔: "ms,t,s" 的 CSV (t/s 為 -255..255 的原始搖桿值)，'#' 開頭為註解。
+// golden 檔: rampSimWriteSeries 的輸出，測試以它比對每次修改後的結果。
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+struct JoystickSample {
+    unsigned long ms;
+    int t;
+    int s;
+};
+
+const int RAMP_SIM_MAX_CHANNELS = 3;
+const unsigned long RAMP_SIM_SAMPLE_MS = 10;
+const unsigned long RAMP_SIM_TAIL_MS = 500;     // 最後一筆命令之後繼續模擬的時間
+
+struct RampSimSample {
+    unsigned long ms;
+    int output[RAMP_SIM_MAX_CHANNELS];          // 通道的輸出 duty (0-255，含方向)
+    double value[RAMP_SIM_MAX_CHANNELS];        // 轉速 (rpm) 或轉向行程 (%)
+    double currentMa[RAMP_SIM_MAX_CHANNELS];    // 繞組電流
+    double supplyV;
+    double headingDeg;                          // 車輛航向 (右轉為正，由 T 轉速與 S 行程估計)
+};
+
+struct RampSimSeries {
+    int channels;
+    std::string names[RAMP_SIM_MAX_CHANNELS];
+    std::vector<RampSimSample> samples;
+};
+
+// 命令保持不變的一段時間內的響應 (只統計夠長、變化夠大的段落)
+struct RampSimSegment {
+    int channel;
+    unsigned long startMs;
+    double from;                // 段落開始時的值
+    double to;                  // 段落結束前 50 ms 的平均值
+    unsigned long timeToSpeedMs;    // 到達變化量 90% 的時間
+    double overshootPct;            // 超過最終值的部分 (佔變化量的百分比)
+};
+
+struct RampSimMetrics {
+    unsigned long timeToSpeedMs[RAMP_SIM_MAX_CHANNELS];    // 各段落中最長的
+    double overshootPct[RAMP_SIM_MAX_CHANNELS];            // 各段落中最大的
+    double peakCurrentMa[RAMP_SIM_MAX_CHANNELS];
+    double minSupplyV;
+    std::vector<RampSimSegment> segments;
+};
+
+// rampSimRun 的選用項目 (全部為 0 時與預設接線的實車相同: 開迴路、沒有額外負載)
+struct RampSimOptions {
+    const char *configJson;         // 先以 /config 的格式修改設定 (例如 {"step_t":12})，NULL = 預設值
+    int encoderPulsesPerRev;        // > 0: 第一個通道的馬達軸裝有編碼器，依模型的轉動產生脈衝 (啟用速度迴路)
+    unsigned long stallFromMs;      // 第一個通道的馬達在 [stallFromMs, stallToMs) 被卡住 (輪子頂到障礙物)
+    unsigned long stallToMs;
+    bool gyro;                      // 安裝 MPU-6050: 依車輛的偏航產生 FIFO 樣本 (啟用航向保持)
+    double yawDisturbanceDps;       // 直行時的偏航 (左右輪阻力差，T 馬達 10000 rpm 時的 °/s，與車速成正比)
+};
+
+bool rampSimLoadTrace(const char *path, std::vector<JoystickSample> &trace, std::string &error);
+
+// 重設假 HAL 後初始化馬達控制並執行整段 trace。設定格式錯誤時回傳 false
+bool rampSimRun(const std::vector<JoystickSample> &trace, const RampSimOptions &options, RampSimSeries &series);
+// 只修改設定 (configJson 可為 NULL)
+bool rampSimRun(const std::vector<JoystickSample> &trace, const char *configJson, RampSimSeries &series);
+
+void rampSimMetrics(const std::vector<JoystickSample> &trace, const RampSimSeries &series,
+                    RampSimMetrics &metrics);
+
+bool rampSimWriteSeries(const char *path, const RampSimSeries &series);
+bool rampSimReadSeries(const char *path, RampSimSeries &series, std::string &error);
@@ -0,0 +1,85 @@
+// --- ramp_sim: 以搖桿紀錄驅動 Ramping 模擬器，輸出 time-to-speed、overshoot 與峰值電流 ---
+//   ramp_sim [--config '{"step_t":12}'] [--encoder PPR] [--stall FROM_MS:TO_MS] [--gyro DRIFT_DPS]
+//            [--segments] [--golden out.csv] trace.csv
+// --encoder 在 T 馬達軸加上編碼器 (啟用速度迴路)，--stall 在這段時間內卡住 T 馬達，
+// --gyro 安裝陀螺儀 (啟用航向保持) 並加上直行時的偏航干擾 (10000 rpm 時的 °/s)。
+// 調整 /config 的 Ramping 參數時，先在這裡比較數字再上車驗證；
+// 參數確定要改變預設值時，以 --golden 重新產生 test/host/golden/ 的檔案 (或建置 update_ramp_golden)。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fake_hal.h"
+#include "ramp_sim.h"
+
+static int usage() {
+    fprintf(stderr, "usage: ramp_sim [--config JSON] [--encoder PPR] [--stall FROM_MS:TO_MS] [--gyro DRIFT_DPS] "
+                    "[--segments] [--golden out.csv] trace.csv\n");
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    RampSimOptions options = {};
+    const char *golden = NULL;
+    const char *tracePath = NULL;
+    bool segments = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            options.configJson = argv[++i];
+        } else if (strcmp(argv[i], "--encoder") == 0 && i + 1 < argc) {
+            options.encoderPulsesPerRev = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stall") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%lu:%lu", &options.stallFromMs, &options.stallToMs) != 2) return usage();
+        } else if (strcmp(argv[i], "--gyro") == 0 && i + 1 < argc) {
+            options.gyro = true;
+            options.yawDisturbanceDps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+            golden = argv[++i];
+        } else if (strcmp(argv[i], "--segments") == 0) {
+            segments = true;
+        } else if (argv[i][0] != '-' && !tracePath) {
+            tracePath = argv[i];
+        } else {
+            return usage();
+        }
+    }
+    if (!tracePath) return usage();
+
+    std::vector<JoystickSample> trace;
+    std::string error;
+    if (!rampSimLoadTrace(tracePath, trace, error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    RampSimSeries series;
+    if (!rampSimRun(trace, options, series)) {
+        fprintf(stderr, "設定無效: %s\n%s", options.configJson, fakeHalLogText().c_str());
+        return 1;
+    }
+    RampSimMetrics metrics;
+    rampSimMetrics(trace, series, metrics);
+
+    printf("%s: %zu 筆命令，模擬 %lu ms\n", tracePath, trace.size(), series.samples.back().ms);
+    printf("%-8s %14s %10s %12s\n", "通道", "time-to-speed", "overshoot", "峰值電流");
+    for (int c = 0; c < series.channels; c++) {
+        printf("%-8s %11lu ms %8.1f %% %9.0f mA\n", series.names[c].c_str(), metrics.timeToSpeedMs[c],
+               metrics.overshootPct[c], metrics.peakCurrentMa[c]);
+    }
+    printf("最低電源電壓 %.2f V，最終航向 %.1f°\n", metrics.minSupplyV, series.samples.back().headingDeg);
+    if (segments) {
+        for (size_t i = 0; i < metrics.segments.size(); i++) {
+            const RampSimSegment &s = metrics.segments[i];
+            printf("  %6lu ms %-8s %8.1f -> %8.1f: %4lu ms, overshoot %.1f %%\n", s.startMs,
+                   series.names[s.channel].c_str(), s.from, s.to, s.timeToSpeedMs, s.overshootPct);
+        }
+    }
+
+    if (golden) {
+        if (!rampSimWriteSeries(golden, series)) {
+            fprintf(stderr, "無法寫入 %s\n", golden);
+            return 1;
+        }
+        printf("已寫入 %s\n", golden);
+    }
+    return 0;
+}
@@ -0,0 +1,262 @@
+// --- 本機替身伺服器: 以與韌體相同的控制核心回應 /control、/ 與 /metrics ---
+//   standin_server [--port 8080] [--port-file path] [--seconds N] [--verbose]
+// 與 AsyncWebServer 相同由單一執行緒處理所有連線 (對應 async_tcp 任務)，每次迴圈也執行 loop()
+// 的 playout 與 Ramping。/control 的參數依 AsyncWebServer 的方式切割與 URL 解碼後交給
+// controlQueryField / controlEndpointApply，回應的位元組與韌體相同，讓 load_gen 可以在 CI 中執行。
+// 時鐘使用真實時間，heap 為假 HAL 的名義 heap (行程實際配置的記憶體)。
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "control_endpoint.h"
+#include "control_query.h"
+#include "fake_hal.h"
+#include "jitter_buffer.h"
+#include "metrics.h"
+#include "motor_control.h"
+#include "web_page.h"
+
+const size_t REQUEST_HEAD_MAX = 2048;   // 與 AsyncWebServer 一樣只接受合理長度的請求標頭
+const unsigned long IDLE_TIMEOUT_MS = 3000; // 閒置連線的 RX timeout (與韌體相同)
+
+struct Connection {
+    int fd;
+    std::string in;
+    std::string out;
+    bool closeAfterWrite;
+    unsigned long lastRxMs;
+};
+
+static std::string urlDecode(const std::string &text) {
+    std::string out;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '%' && i + 2 < text.size()) {
+            out += (char)strtol(text.substr(i + 1, 2).c_str(), NULL, 16);
+            i += 2;
+        } else {
+            out += text[i] == '+' ? ' ' : text[i];
+        }
+    }
+    return out;
+}
+
+// AsyncWebServerRequest::_addGetParams 的切割方式: '&' 分隔，各自以第一個 '=' 分成名稱與值
+static bool parseControl(const std::string &query, ControlQuery &control) {
+    bool valid = true;
+    size_t start = 0;
+    while (start < query.size() && valid) {
+        size_t end = query.find('&', start);
+        if (end == std::string::npos) end = query.size();
+        std::string pair = query.substr(start, end - start);
+        size_t eq = pair.find('=');
+        std::string name = urlDecode(pair.substr(0, eq));
+        std::string value = eq == std::string::npos ? std::string() : urlDecode(pair.substr(eq + 1));
+        valid = controlQueryField(control, name.data(), name.size(), value.data(), value.size());
+        start = end + 1;
+    }
+    return valid;
+}
+
+// AsyncBasicResponse 的標頭格式
+static std::string basicResponse(int code, const char *status, const char *type, const std::string &body) {
+    char head[256];
+    snprintf(head, sizeof(head),
+             "HTTP/1.1 %d %s\r\nContent-Length: %zu\r\nContent-Type: %s\r\nConnection: close\r\n"
+             "Accept-Ranges: none\r\n\r\n",
+             code, status, body.size(), type);
+    return head + body;
+}
+
+static void replaceAll(std::string &text, const char *from, const std::string &to) {
+    for (size_t at = text.find(from); at != std::string::npos; at = text.find(from, at + to.size())) {
+        text.replace(at, strlen(from), to);
+    }
+}
+
+static void handleRequest(Connection &conn, const std::string &target) {
+    size_t mark = target.find('?');
+    std::string path = target.substr(0, mark);
+    std::string query = mark == std::string::npos ? std::string() : target.substr(mark + 1);
+
+    if (path == "/control") {
+        ControlQuery control = {};
+        bool valid = parseControl(query, control);
+        if (controlEndpointApply(control, valid, halMillis()) == CONTROL_REJECTED) {
+            conn.out += basicResponse(400, "Bad Request", "text/plain",
+                                      "Invalid arguments (Missing or malformed t/s)");
+        } else {
+            conn.out.append(CONTROL_ACK_HEAD, CONTROL_ACK_HEAD_LEN);
+#if CONTROL_KEEP_ALIVE
+            // 204 之後連線保持開啟，接收下一個命令 (韌體由 ControlAckResponse 交接連線)
+            return;
+#endif
+        }
+    } else if (path == "/") {
+        metrics.rootRequests++;
+        std::string html = HTML_CONTENT;
+        replaceAll(html, "%HOSTNAME%", "esp32c3-standin");
+        replaceAll(html, "%IPADDRESS%", "127.0.0.1");
+        conn.out += basicResponse(200, "OK", "text/html", html);
+    } else if (path == "/metrics") {
+        static char json[3072];
+        size_t len = metricsFormatJson(json, sizeof(json));
+        conn.out += basicResponse(200, "OK", "application/json", std::string(json, len));
+    } else {
+        metrics.notFound++;
+        conn.out += basicResponse(404, "Not Found", "text/plain", "Not Found");
+    }
+    // 其餘回應 (與未保持連線時的 204) 送完即關閉連線
+    conn.closeAfterWrite = true;
+}
+
+// 解析一個完整的請求標頭 (只支援 GET，本文忽略)；標頭尚未收齊時回傳 false
+static bool processInput(Connection &conn) {
+    size_t end = conn.in.find("\r\n\r\n");
+    if (end == std::string::npos) {
+        if (conn.in.size() > REQUEST_HEAD_MAX) conn.closeAfterWrite = true;
+        return false;
+    }
+    std::string line = conn.in.substr(0, conn.in.find("\r\n"));
+    conn.in.erase(0, end + 4);
+    char method[8], target[1024];
+    if (sscanf(line.c_str(), "%7s %1023s", method, target) != 2 || strcmp(method, "GET") != 0) {
+        conn.out += basicResponse(400, "Bad Request", "text/plain", "Bad Request");
+        conn.closeAfterWrite = true;
+        return true;
+    }
+    handleRequest(conn, target);
+    return true;
+}
+
+static int listenOn(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(fd, (sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        perror("standin_server");
+        exit(1);
+    }
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    return fd;
+}
+
+static int boundPort(int fd) {
+    sockaddr_in addr = {};
+    socklen_t len = sizeof(addr);
+    getsockname(fd, (sockaddr *)&addr, &len);
+    return ntohs(addr.sin_port);
+}
+
+int main(int argc, char **argv) {
+    int port = 8080;
+    const char *portFile = NULL;
+    long seconds = 0;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--port-file") == 0 && i + 1 < argc) {
+            portFile = argv[++i];
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else {
+            fprintf(stderr, "usage: standin_server [--port N] [--port-file path] [--seconds N] [--verbose]\n");
+            return 2;
+        }
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    fakeHalUseWallClock(true);
+    fakeHalLogEcho(verbose);
+    motorInit();
+
+    int listener = listenOn(port);
+    port = boundPort(listener);
+    fprintf(stderr, "standin_server: http://127.0.0.1:%d/\n", port);
+    if (portFile) {
+        FILE *file = fopen(portFile, "w");
+        if (file) {
+            fprintf(file, "%d\n", port);
+            fclose(file);
+        }
+    }
+
+    std::vector<Connection> conns;
+    unsigned long stopMs = seconds > 0 ? halMillis() + (unsigned long)seconds * 1000 : 0;
+    while (stopMs == 0 || (long)(halMillis() - stopMs) < 0) {
+        std::vector<pollfd> fds;
+        pollfd accepting = { listener, POLLIN, 0 };
+        fds.push_back(accepting);
+        for (size_t i = 0; i < conns.size(); i++) {
+            pollfd p = { conns[i].fd, (short)(conns[i].out.empty() ? POLLIN : POLLOUT), 0 };
+            fds.push_back(p);
+        }
+        poll(fds.data(), fds.size(), 1);
+
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept(listener, NULL, NULL)) >= 0) {
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                fcntl(fd, F_SETFL, O_NONBLOCK);
+                Connection conn = { fd, std::string(), std::string(), false, halMillis() };
+                conns.push_back(conn);
+            }
+        }
+        for (size_t i = 0; i < conns.size(); i++) {
+            if (i + 1 >= fds.size()) break;     // 這一輪新接受的連線下一輪再處理
+            Connection &conn = conns[i];
+            short events = fds[i + 1].revents;
+            bool drop = (events & (POLLERR | POLLNVAL)) != 0;
+            if (!drop && (events & (POLLIN | POLLHUP))) {
+                char buf[2048];
+                ssize_t n = read(conn.fd, buf, sizeof(buf));
+                if (n > 0) {
+                    conn.in.append(buf, n);
+                    conn.lastRxMs = halMillis();
+                    while (!conn.closeAfterWrite && processInput(conn)) {
+                    }
+                } else if (n == 0 || errno != EAGAIN) {
+                    drop = true;
+                }
+            }
+            if (!drop && !conn.out.empty()) {
+                ssize_t n = write(conn.fd, conn.out.data(), conn.out.size());
+                if (n > 0) conn.out.erase(0, n);
+                else if (n < 0 && errno != EAGAIN) drop = true;
+            }
+            if (conn.out.empty() && halMillis() - conn.lastRxMs > IDLE_TIMEOUT_MS) drop = true;
+            if (drop || (conn.out.empty() && conn.closeAfterWrite)) {
+                close(conn.fd);
+                conn.fd = -1;
+            }
+        }
+        for (size_t i = conns.size(); i-- > 0;) {
+            if (conns[i].fd < 0) conns.erase(conns.begin() + i);
+        }
+
+        // loop(): playout 緩衝與 Ramping
+        int playoutT, playoutS;
+        if (jitterBufferPlayout(halMillis(), &playoutT, &playoutS)) motorSetTarget(playoutT, playoutS);
+        motorRampTask();
+        fakeHalLogClear();
+    }
+    return 0;
+}
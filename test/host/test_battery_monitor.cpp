@@ -0,0 +1,138 @@
+// --- 電池電壓監控、壓降補償與剩餘電量 ---
+#include <catch2/catch.hpp>
+#include <stdlib.h>
+#include "battery_monitor.h"
+
+TEST_CASE("補償縮放: 標稱電壓為 1.0，低電壓放大、高電壓縮小並有上下限", "[battery]") {
+    const BatteryConfig &c = BATTERY_DEFAULT;
+    CHECK(batteryCompensationScale(c.nominalMv, c) == BATTERY_SCALE_ONE);
+    CHECK(batteryCompensationScale(8400, c) == c.nominalMv * BATTERY_SCALE_ONE / 8400);
+    CHECK(batteryCompensationScale(6400, c) == c.nominalMv * BATTERY_SCALE_ONE / 6400);
+    CHECK(batteryCompensationScale(3000, c) == c.maxBoost);
+    CHECK(batteryCompensationScale(20000, c) == BATTERY_SCALE_ONE / 2);
+    // 尚未量到電壓時不縮放
+    CHECK(batteryCompensationScale(0, c) == BATTERY_SCALE_ONE);
+}
+
+TEST_CASE("補償後的有效電壓不隨電量改變，只跟隨慢速濾波", "[battery]") {
+    const BatteryConfig &c = BATTERY_DEFAULT;
+    BatteryState state;
+    batteryReset(state);
+    batteryUpdate(state, c, 8200, 8200, 0, 10);
+    REQUIRE(batteryVoltageMv(state) == 8200);
+
+    // 電壓降到 6800 mV: 一個 tick 後補償幾乎不變 (不跟隨瞬間壓降)
+    int before = state.compScale;
+    batteryUpdate(state, c, 6800, 6800, 0, 10);
+    CHECK(abs(state.compScale - before) <= 1);
+
+    // 時間常數 64 個 tick (約 0.6 秒): 6 秒後收斂 (整數濾波最後留下 4 mV 以內的誤差)
+    for (int i = 0; i < 600; i++) batteryUpdate(state, c, 6800, 6800, 0, 10);
+    CHECK(batteryVoltageMv(state) == Approx(6800).margin(5));
+
+    // duty × 縮放 × 電池電壓 ≈ duty × 標稱電壓 (8200 與 6800 mV 時相同的有效電壓)
+    const int duty = 150;
+    double effective = (double)duty * state.compScale / BATTERY_SCALE_ONE * batteryVoltageMv(state);
+    CHECK(effective == Approx((double)duty * c.nominalMv).epsilon(0.01));
+    double effectiveFull = (double)duty * batteryCompensationScale(8200, c) / BATTERY_SCALE_ONE * 8200;
+    CHECK(effectiveFull == Approx(effective).epsilon(0.01));
+}
+
+// 內阻 0.6 Ω 的電池: 每個 tick 啟動推力的電流與推力縮放成正比 (滿推力 4 A)
+static int sagUnderKick(int openMv, int kickScale) {
+    int loadMa = 4000 * kickScale / BATTERY_SCALE_ONE;
+    return openMv - loadMa * 6 / 10;
+}
+
+TEST_CASE("壓降限制: 推力造成的壓降低於門檻時縮小推力，電壓回到門檻以上且不來回振盪", "[battery]") {
+    const BatteryConfig &c = BATTERY_DEFAULT;
+    BatteryState state;
+    batteryReset(state);
+    batteryUpdate(state, c, 8000, 8000, 0, 10);
+
+    // 滿推力: 8000 - 2400 = 5600 mV，低於 6000 mV
+    REQUIRE(sagUnderKick(8000, BATTERY_SCALE_ONE) < c.sagMv);
+    int worst = 8000;
+    for (int tick = 0; tick < 200; tick++) {
+        int minMv = sagUnderKick(8000, state.kickScale);
+        if (tick > 0 && minMv < worst) worst = minMv;
+        batteryUpdate(state, c, 7800, minMv, 0, 10);
+    }
+    // 第一次壓降後縮小為 3/4: 8000 - 1800 = 6200 mV，介於門檻與恢復電壓之間，維持不變
+    CHECK(state.sagEvents == 1);
+    CHECK(state.kickScale == BATTERY_SCALE_ONE * 3 / 4);
+    CHECK(worst >= c.sagMv);
+    CHECK(state.minMv == sagUnderKick(8000, BATTERY_SCALE_ONE));
+}
+
+TEST_CASE("壓降限制: 持續壓降時推力不低於 minKickScale，電壓恢復後逐步回復", "[battery]") {
+    const BatteryConfig &c = BATTERY_DEFAULT;
+    BatteryState state;
+    batteryReset(state);
+    batteryUpdate(state, c, 8000, 8000, 0, 10);
+    for (int i = 0; i < 50; i++) batteryUpdate(state, c, 6500, 5500, 0, 10);
+    CHECK(state.kickScale == c.minKickScale);
+    CHECK(state.sagEvents == 1);
+    CHECK(state.sagging);
+
+    // 遲滯: 回到門檻以上但低於恢復電壓時維持
+    batteryUpdate(state, c, 6500, 6200, 0, 10);
+    CHECK(state.kickScale == c.minKickScale);
+    CHECK(state.sagging);
+
+    int ticks = 0;
+    while (state.kickScale < BATTERY_SCALE_ONE && ticks < 1000) {
+        batteryUpdate(state, c, 7000, 7000, 0, 10);
+        ticks++;
+    }
+    CHECK_FALSE(state.sagging);
+    CHECK(ticks == (BATTERY_SCALE_ONE - c.minKickScale) / 4);
+
+    // 再次壓降是新的一次事件
+    batteryUpdate(state, c, 6500, 5500, 0, 10);
+    CHECK(state.sagEvents == 2);
+}
+
+TEST_CASE("能量積分: tick 間隔不固定時總量仍正確，過長的間隔只計上限", "[battery]") {
+    const BatteryConfig &c = BATTERY_DEFAULT;
+    BatteryState state;
+    batteryReset(state);
+    batteryUpdate(state, c, 8400, 8400, 0, 0);
+    REQUIRE(state.initialMwh == c.capacityMwh);
+    REQUIRE(batteryRemainingPercent(state, c) == 100);
+
+    // 7400 mV × 1000 mA 半小時 = 3700 mWh；tick 間隔在 7..13 ms 之間變動
+    unsigned long totalMs = 0;
+    uint32_t seed = 1;
+    while (totalMs < 1800000) {
+        seed = seed * 1103515245 + 12345;
+        unsigned long elapsed = 7 + (seed >> 16) % 7;
+        if (totalMs + elapsed > 1800000) elapsed = 1800000 - totalMs;
+        batteryUpdate(state, c, 7400, 7400, 1000, elapsed);
+        totalMs += elapsed;
+    }
+    CHECK(batteryUsedMwh(state) == 3700);
+    CHECK(batteryRemainingPercent(state, c) == 50);
+
+    // 任務延遲 500 ms 的一個 tick 只計 100 ms (7400 × 1000 × 100 ms = 740000000 nJ)
+    uint64_t before = state.usedNj;
+    batteryUpdate(state, c, 7400, 7400, 1000, 500);
+    CHECK(state.usedNj - before == 740000000ULL);
+
+    // 充電 (負電流) 不計入
+    before = state.usedNj;
+    batteryUpdate(state, c, 7400, 7400, -500, 10);
+    CHECK(state.usedNj == before);
+}
+
+TEST_CASE("開機電量依靜止電壓在 empty..full 之間線性估計", "[battery]") {
+    const BatteryConfig &c = BATTERY_DEFAULT;
+    BatteryState state;
+    batteryReset(state);
+    CHECK(batteryRemainingPercent(state, c) == 0);
+    batteryUpdate(state, c, (c.emptyMv + c.fullMv) / 2, 7500, 0, 0);
+    CHECK(batteryRemainingPercent(state, c) == 50);
+    batteryReset(state);
+    batteryUpdate(state, c, c.emptyMv - 300, c.emptyMv - 300, 0, 0);
+    CHECK(batteryRemainingPercent(state, c) == 0);
+}
@@ -0,0 +1,43 @@
+// --- 控制命令順序檢查 ---
+#include <catch2/catch.hpp>
+#include "command_order.h"
+
+// session 表是整個韌體共用的，每個案例使用不重複的 session 編號
+static uint32_t freshSession() {
+    static uint32_t next = 1000;
+    return next++;
+}
+
+TEST_CASE("新的 session 接受任何序號，之後只接受更大的序號", "[command_order]") {
+    uint32_t c = freshSession();
+    CHECK(commandOrderAccept(c, 50, 0));
+    CHECK(commandOrderAccept(c, 51, 10));
+    CHECK_FALSE(commandOrderAccept(c, 51, 20));
+    CHECK_FALSE(commandOrderAccept(c, 49, 30));
+    CHECK(commandOrderAccept(c, 60, 40));
+}
+
+TEST_CASE("序號溢位回繞時仍依先後判斷", "[command_order]") {
+    uint32_t c = freshSession();
+    CHECK(commandOrderAccept(c, 0xFFFFFFFE, 0));
+    CHECK(commandOrderAccept(c, 0xFFFFFFFF, 1));
+    CHECK(commandOrderAccept(c, 0, 2));
+    CHECK(commandOrderAccept(c, 1, 3));
+    CHECK_FALSE(commandOrderAccept(c, 0xFFFFFFFF, 4));
+}
+
+TEST_CASE("session 表已滿時取代最久未活動者", "[command_order]") {
+    uint32_t ids[COMMAND_ORDER_SESSIONS + 1];
+    for (int i = 0; i <= COMMAND_ORDER_SESSIONS; i++) ids[i] = freshSession();
+    unsigned long now = 100000;
+    for (int i = 0; i < COMMAND_ORDER_SESSIONS; i++) {
+        REQUIRE(commandOrderAccept(ids[i], 10, now + i));
+    }
+    // 讓第一個 session 保持活躍，第二個成為最久未活動者
+    REQUIRE(commandOrderAccept(ids[0], 11, now + 10));
+    REQUIRE(commandOrderAccept(ids[COMMAND_ORDER_SESSIONS], 1, now + 20));
+
+    // 仍在表中的 session 拒絕舊序號；被取代的 session 重新視為新的
+    CHECK_FALSE(commandOrderAccept(ids[0], 11, now + 30));
+    CHECK(commandOrderAccept(ids[1], 5, now + 40));
+}
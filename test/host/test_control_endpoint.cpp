@@ -0,0 +1,62 @@
+// --- /control 命令的套用 ---
+#include <catch2/catch.hpp>
+#include <string.h>
+#include "control_endpoint.h"
+#include "link_supervisor.h"
+#include "metrics.h"
+#include "motor_control.h"
+
+// 與 test_command_order 的 session 編號錯開
+static uint32_t freshSession() {
+    static uint32_t next = 5000;
+    return next++;
+}
+
+static ControlQuery command(int t, int s, uint32_t session, uint32_t seq) {
+    ControlQuery query = {};
+    query.hasT = query.hasS = true;
+    query.t = t;
+    query.s = s;
+    query.hasSession = query.hasSeq = true;
+    query.session = session;
+    query.seq = seq;
+    return query;
+}
+
+TEST_CASE("有效命令設定目標並計入統計與回應位元組", "[control_endpoint]") {
+    Metrics before = metrics;
+    uint32_t c = freshSession();
+    CHECK(controlEndpointApply(command(255, 0, c, 1), true, 0) == CONTROL_APPLIED);
+    CHECK(motorChannelState(MOTOR_T).target > 0);
+    CHECK(metrics.controlRequests == before.controlRequests + 1);
+    CHECK(metrics.controlAckBytes == before.controlAckBytes + CONTROL_ACK_HEAD_LEN);
+
+    CHECK(controlEndpointApply(command(0, 0, c, 2), true, 10) == CONTROL_APPLIED);
+    CHECK(motorChannelState(MOTOR_T).target == 0);
+}
+
+TEST_CASE("較舊的序號被丟棄且不改變目標", "[control_endpoint]") {
+    Metrics before = metrics;
+    uint32_t c = freshSession();
+    REQUIRE(controlEndpointApply(command(0, 0, c, 10), true, 0) == CONTROL_APPLIED);
+    CHECK(controlEndpointApply(command(255, 0, c, 9), true, 10) == CONTROL_STALE);
+    CHECK(motorChannelState(MOTOR_T).target == 0);
+    CHECK_FALSE(linkSupervisorArmed());
+    CHECK(metrics.controlStale == before.controlStale + 1);
+    CHECK(metrics.controlRequests == before.controlRequests + 1);
+}
+
+TEST_CASE("缺少 t/s 或格式錯誤時拒絕", "[control_endpoint]") {
+    Metrics before = metrics;
+    ControlQuery missing = {};
+    missing.hasT = true;
+    CHECK(controlEndpointApply(missing, true, 0) == CONTROL_REJECTED);
+    CHECK(controlEndpointApply(command(1, 1, freshSession(), 1), false, 0) == CONTROL_REJECTED);
+    CHECK(metrics.controlRejected == before.controlRejected + 2);
+    CHECK(metrics.controlRequests == before.controlRequests);
+}
+
+TEST_CASE("204 回應為完整的 HTTP 標頭", "[control_endpoint]") {
+    CHECK(strncmp(CONTROL_ACK_HEAD, "HTTP/1.1 204 No Content\r\n", 25) == 0);
+    CHECK(strcmp(CONTROL_ACK_HEAD + CONTROL_ACK_HEAD_LEN - 4, "\r\n\r\n") == 0);
+}
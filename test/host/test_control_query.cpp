@@ -0,0 +1,86 @@
+// --- /control 查詢參數解析 ---
+#include <string.h>
+#include <catch2/catch.hpp>
+#include "control_query.h"
+
+static bool parseInt(const char *text, int *out) {
+    return parseSaturatedInt(text, strlen(text), out);
+}
+
+static bool field(ControlQuery &query, const char *name, const char *value) {
+    return controlQueryField(query, name, strlen(name), value, strlen(value));
+}
+
+TEST_CASE("parseSaturatedInt 解析有號十進位整數", "[control_query]") {
+    int v = 0;
+    REQUIRE(parseInt("120", &v));
+    CHECK(v == 120);
+    REQUIRE(parseInt("-40", &v));
+    CHECK(v == -40);
+    REQUIRE(parseInt("+7", &v));
+    CHECK(v == 7);
+    REQUIRE(parseInt("-32768", &v));
+    CHECK(v == CONTROL_VALUE_MIN);
+}
+
+TEST_CASE("parseSaturatedInt 超出範圍時飽和", "[control_query]") {
+    int v = 0;
+    REQUIRE(parseInt("32768", &v));
+    CHECK(v == CONTROL_VALUE_MAX);
+    REQUIRE(parseInt("99999999999999999999", &v));
+    CHECK(v == CONTROL_VALUE_MAX);
+    REQUIRE(parseInt("-99999999999999999999", &v));
+    CHECK(v == CONTROL_VALUE_MIN);
+}
+
+TEST_CASE("parseSaturatedInt 拒絕格式錯誤的輸入", "[control_query]") {
+    int v = 123;
+    CHECK_FALSE(parseInt("", &v));
+    CHECK_FALSE(parseInt("-", &v));
+    CHECK_FALSE(parseInt("12a", &v));
+    CHECK_FALSE(parseInt(" 12", &v));
+    CHECK_FALSE(parseInt("1-2", &v));
+    // 飽和後的字元仍然要檢查
+    CHECK_FALSE(parseInt("9999999999x", &v));
+    CHECK(v == 123);
+    // 長度限制: 不讀取 len 之後的位元組
+    REQUIRE(parseSaturatedInt("42junk", 2, &v));
+    CHECK(v == 42);
+}
+
+TEST_CASE("parseSaturatedUint32 飽和到 UINT32_MAX", "[control_query]") {
+    uint32_t v = 0;
+    REQUIRE(parseSaturatedUint32("4294967295", 10, &v));
+    CHECK(v == UINT32_MAX);
+    REQUIRE(parseSaturatedUint32("4294967296", 10, &v));
+    CHECK(v == UINT32_MAX);
+    REQUIRE(parseSaturatedUint32("0", 1, &v));
+    CHECK(v == 0);
+    CHECK_FALSE(parseSaturatedUint32("", 0, &v));
+    CHECK_FALSE(parseSaturatedUint32("-1", 2, &v));
+}
+
+TEST_CASE("controlQueryField 套用已知欄位並忽略未知欄位", "[control_query]") {
+    ControlQuery query = {};
+    CHECK_FALSE(controlQueryComplete(query));
+    REQUIRE(field(query, "t", "120"));
+    REQUIRE(field(query, "s", "-255"));
+    REQUIRE(field(query, "c", "77"));
+    REQUIRE(field(query, "q", "5"));
+    REQUIRE(field(query, "ts", "123456"));
+    REQUIRE(field(query, "unknown", "whatever"));
+    CHECK(controlQueryComplete(query));
+    CHECK(query.t == 120);
+    CHECK(query.s == -255);
+    CHECK((query.hasSession && query.session == 77));
+    CHECK((query.hasSeq && query.seq == 5));
+    CHECK((query.hasTs && query.ts == 123456));
+}
+
+TEST_CASE("controlQueryField 已知欄位格式錯誤時失敗", "[control_query]") {
+    ControlQuery query = {};
+    CHECK_FALSE(field(query, "t", "fast"));
+    CHECK_FALSE(query.hasT);
+    CHECK_FALSE(field(query, "q", "-3"));
+    CHECK_FALSE(field(query, "s", ""));
+}
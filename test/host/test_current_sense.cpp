@@ -0,0 +1,91 @@
+// --- 馬達電流感測與限流 ---
+#include <catch2/catch.hpp>
+#include "current_sense.h"
+
+TEST_CASE("低於預算時不限流", "[current_sense]") {
+    CurrentChannel ch;
+    currentChannelReset(ch);
+    for (int i = 0; i < 50; i++) {
+        CHECK(currentChannelUpdate(ch, CURRENT_LIMIT_DEFAULT_T, 1200, 1400) == CURRENT_SCALE_ONE);
+    }
+    CHECK(ch.limitedTicks == 0);
+    CHECK(ch.peakMa == 1400);
+}
+
+TEST_CASE("超過預算時縮小 duty，但不低於 minScale", "[current_sense]") {
+    CurrentChannel ch;
+    currentChannelReset(ch);
+    int scale = CURRENT_SCALE_ONE;
+    for (int i = 0; i < 4; i++) scale = currentChannelUpdate(ch, CURRENT_LIMIT_DEFAULT_T, 3000, 3000);
+    CHECK(scale < CURRENT_SCALE_ONE);
+    CHECK(ch.limitedTicks > 0);
+
+    // 堵轉: 不論電流多大，縮放都停在 minScale
+    for (int i = 0; i < 50; i++) scale = currentChannelUpdate(ch, CURRENT_LIMIT_DEFAULT_T, 60000, 60000);
+    CHECK(scale == CURRENT_LIMIT_DEFAULT_T.minScale);
+}
+
+TEST_CASE("電流回到預算的 7/8 以下後逐步回復", "[current_sense]") {
+    CurrentChannel ch;
+    currentChannelReset(ch);
+    for (int i = 0; i < 10; i++) currentChannelUpdate(ch, CURRENT_LIMIT_DEFAULT_T, 4000, 4000);
+    int limited = ch.scale;
+    REQUIRE(limited < CURRENT_SCALE_ONE);
+
+    int scale = limited;
+    int ticks = 0;
+    while (scale < CURRENT_SCALE_ONE && ticks < 1000) {
+        scale = currentChannelUpdate(ch, CURRENT_LIMIT_DEFAULT_T, 200, 200);
+        ticks++;
+    }
+    CHECK(scale == CURRENT_SCALE_ONE);
+    // 快速濾波需要幾個 tick 才會低於遲滯門檻，之後每個 tick 回復 recoverStep
+    CHECK(ticks >= (CURRENT_SCALE_ONE - limited) / CURRENT_LIMIT_DEFAULT_T.recoverStep);
+}
+
+TEST_CASE("慢速濾波的平均電流", "[current_sense]") {
+    CurrentChannel ch;
+    currentChannelReset(ch);
+    for (int i = 0; i < 1000; i++) currentChannelUpdate(ch, CURRENT_LIMIT_DEFAULT_S, 800, 900);
+    CHECK(currentChannelAverageMa(ch) == Approx(800).margin(10));
+}
+
+// 電流與 duty 成正比的負載: 這個 tick 量到的電流由上一個 tick 決定的縮放產生
+static int plantMa(int demandMa, int scale) {
+    return demandMa * scale / CURRENT_SCALE_ONE;
+}
+
+TEST_CASE("步階負載限流到預算且不會低於預算", "[current_sense]") {
+    CurrentLimitConfig config = { 1500, 8, 32 };
+    CurrentChannel ch;
+    currentChannelReset(ch);
+    int scale = CURRENT_SCALE_ONE;
+    int minMa = 100000;
+    int limitedAt = -1;
+    int currentMa = 0;
+    for (int i = 0; i < 100; i++) {
+        currentMa = plantMa(3000, scale);
+        if (limitedAt >= 0) {
+            if (currentMa < minMa) minMa = currentMa;
+        }
+        scale = currentChannelUpdate(ch, config, currentMa, currentMa);
+        if (limitedAt < 0 && scale < CURRENT_SCALE_ONE) limitedAt = i;
+    }
+    REQUIRE(limitedAt == 0);
+    // 縮放不會因濾波延遲而重複疊加 (舊算法會先掉到約 1195 mA，之後停在約 1382 mA)
+    CHECK(minMa >= 1500 * 97 / 100);
+    CHECK(currentMa == Approx(1500).margin(15));
+    CHECK(ch.demandMa == Approx(3000).margin(30));
+
+    // 負載消失後回復到 1.0
+    for (int i = 0; i < 100; i++) {
+        currentMa = plantMa(1000, scale);
+        scale = currentChannelUpdate(ch, config, currentMa, currentMa);
+    }
+    CHECK(scale == CURRENT_SCALE_ONE);
+}
+
+TEST_CASE("未安裝的感測輸入", "[current_sense]") {
+    CHECK_FALSE(currentSensePresent(-1));
+    CHECK_FALSE(currentSensePresent(2));
+}
@@ -0,0 +1,77 @@
+// --- 驅動混控 ---
+#include <stdlib.h>
+#include <string.h>
+#include <catch2/catch.hpp>
+#include "drive_mixer.h"
+
+TEST_CASE("mixerApply passthrough 不改變輸入", "[drive_mixer]") {
+    MixResult out;
+    mixerApply(MIX_PASSTHROUGH, 120, -40, 255, out);
+    CHECK(out.v[MIX_THROTTLE] == 120);
+    CHECK(out.v[MIX_STEERING] == -40);
+    CHECK(out.v[MIX_LEFT] == 120);
+    CHECK(out.v[MIX_RIGHT] == -40);
+}
+
+TEST_CASE("mixerApply arcade 換算成左右差速", "[drive_mixer]") {
+    MixResult out;
+    mixerApply(MIX_ARCADE, 100, 50, 255, out);
+    CHECK(out.v[MIX_LEFT] == 150);
+    CHECK(out.v[MIX_RIGHT] == 50);
+    CHECK(out.v[MIX_THROTTLE] == 100);
+    CHECK(out.v[MIX_STEERING] == 50);
+
+    // 原地迴轉
+    mixerApply(MIX_ARCADE, 0, 200, 255, out);
+    CHECK(out.v[MIX_LEFT] == 200);
+    CHECK(out.v[MIX_RIGHT] == -200);
+}
+
+TEST_CASE("mixerDifferential 飽和時保留左右比例", "[drive_mixer]") {
+    int left;
+    int right;
+    mixerDifferential(200, 100, 255, left, right);
+    CHECK(left == 255);
+    CHECK(right == 85);
+
+    mixerDifferential(-255, 255, 255, left, right);
+    CHECK(left == 0);
+    CHECK(right == -255);
+
+    // 全範圍: 不超過滿刻度，且比例誤差不超過四捨五入
+    for (int t = -255; t <= 255; t += 15) {
+        for (int s = -255; s <= 255; s += 15) {
+            mixerDifferential(t, s, 255, left, right);
+            REQUIRE(abs(left) <= 255);
+            REQUIRE(abs(right) <= 255);
+            int rawLeft = t + s;
+            int rawRight = t - s;
+            int peak = abs(rawLeft) > abs(rawRight) ? abs(rawLeft) : abs(rawRight);
+            if (peak > 255) {
+                CHECK(left * peak == Approx(rawLeft * 255).margin(peak / 2 + 1));
+                CHECK(right * peak == Approx(rawRight * 255).margin(peak / 2 + 1));
+            }
+        }
+    }
+}
+
+TEST_CASE("mixerApply tank 以兩側平均與差值驅動 Ackermann 通道", "[drive_mixer]") {
+    MixResult out;
+    mixerApply(MIX_TANK, 100, -100, 255, out);
+    CHECK(out.v[MIX_LEFT] == 100);
+    CHECK(out.v[MIX_RIGHT] == -100);
+    CHECK(out.v[MIX_THROTTLE] == 0);
+    CHECK(out.v[MIX_STEERING] == 100);
+}
+
+TEST_CASE("mixerSelectByName 只接受已知的模式", "[drive_mixer]") {
+    MixMode original = mixerMode();
+    REQUIRE(mixerSelectByName("tank", 4));
+    CHECK(mixerMode() == MIX_TANK);
+    CHECK(strcmp(mixerModeName(mixerMode()), "tank") == 0);
+    CHECK_FALSE(mixerSelectByName("tan", 3));
+    CHECK_FALSE(mixerSelectByName("tanks", 5));
+    CHECK(mixerMode() == MIX_TANK);
+    CHECK_FALSE(mixerSelect(MIX_MODE_COUNT));
+    REQUIRE(mixerSelect(original));
+}
@@ -0,0 +1,100 @@
+// --- Duty Ramping 累加器與 PWM dithering ---
+#include <catch2/catch.hpp>
+#include "duty_ramp.h"
+
+static const RampParams KICKED = { 5 * DUTY_Q8_ONE, 128, 40, 50 };
+static const RampParams NO_KICK = { 5 * DUTY_Q8_ONE, 128, 0, 50 };
+
+TEST_CASE("rampStepQ8 目標為 0 時立即停止", "[duty_ramp]") {
+    KickState kick = { true, 100 };
+    CHECK(rampStepQ8(150 * DUTY_Q8_ONE, 0, KICKED, kick, 0) == 0);
+    CHECK_FALSE(kick.active);
+}
+
+TEST_CASE("rampStepQ8 由靜止啟動時維持推力 kickMs", "[duty_ramp]") {
+    KickState kick = {};
+    int q8 = rampStepQ8(0, 200, KICKED, kick, 1000);
+    CHECK(q8 == 128 * DUTY_Q8_ONE);
+    CHECK(kick.active);
+    q8 = rampStepQ8(q8, 200, KICKED, kick, 1039);
+    CHECK(q8 == 128 * DUTY_Q8_ONE);
+
+    // 推力結束後從推力值繼續加速
+    q8 = rampStepQ8(q8, 200, KICKED, kick, 1040);
+    CHECK_FALSE(kick.active);
+    CHECK(q8 == 133 * DUTY_Q8_ONE);
+}
+
+TEST_CASE("rampStepQ8 推力結束後不超過較小的目標", "[duty_ramp]") {
+    KickState kick = {};
+    int q8 = rampStepQ8(0, 60, KICKED, kick, 0);
+    CHECK(q8 == 128 * DUTY_Q8_ONE);
+    q8 = rampStepQ8(q8, 60, KICKED, kick, 40);
+    CHECK(q8 == 60 * DUTY_Q8_ONE);
+}
+
+TEST_CASE("rampStepQ8 推力期間反向時重新啟動", "[duty_ramp]") {
+    KickState kick = {};
+    int q8 = rampStepQ8(0, 200, KICKED, kick, 0);
+    q8 = rampStepQ8(q8, -200, KICKED, kick, 10);
+    CHECK(q8 == -128 * DUTY_Q8_ONE);
+    CHECK(kick.active);
+    CHECK(kick.untilMs == 50);
+}
+
+TEST_CASE("rampStepQ8 不使用推力時由最低有效 duty 開始", "[duty_ramp]") {
+    KickState kick = {};
+    int q8 = rampStepQ8(0, 200, NO_KICK, kick, 0);
+    CHECK(q8 == 55 * DUTY_Q8_ONE);
+    CHECK_FALSE(kick.active);
+    q8 = rampStepQ8(0, -30, NO_KICK, kick, 0);
+    CHECK(q8 == -30 * DUTY_Q8_ONE);
+}
+
+TEST_CASE("rampStepQ8 以 Q8 步長收斂且減速時直接降到目標", "[duty_ramp]") {
+    RampParams fine = { 300, 0, 0, 0 };     // 每個 tick 約 1.17 duty
+    KickState kick = {};
+    int q8 = 10 * DUTY_Q8_ONE;
+    int ticks = 0;
+    while (q8 != 100 * DUTY_Q8_ONE && ticks < 1000) {
+        q8 = rampStepQ8(q8, 100, fine, kick, 0);
+        ticks++;
+    }
+    CHECK(q8 == 100 * DUTY_Q8_ONE);
+    CHECK(ticks == (90 * DUTY_Q8_ONE + 299) / 300);
+
+    q8 = rampStepQ8(q8, 20, fine, kick, 0);
+    CHECK(q8 == 20 * DUTY_Q8_ONE);
+}
+
+TEST_CASE("pwmDitherStep 的平均值等於精確的 duty", "[duty_ramp]") {
+    const int hwMaxes[] = { 255, 2047, 16383 };
+    for (int hwMax : hwMaxes) {
+        PwmDither dither = {};
+        const int dutyQ8 = 100 * DUTY_Q8_ONE + 77;
+        const int ticks = 4096;
+        int64_t sum = 0;
+        for (int i = 0; i < ticks; i++) {
+            int counts = pwmDitherStep(dither, dutyQ8, 255, hwMax);
+            CHECK(counts >= 0);
+            CHECK(counts <= hwMax);
+            sum += counts;
+        }
+        double exact = (double)dutyQ8 / DUTY_Q8_ONE * hwMax / 255;
+        CHECK((double)sum / ticks == Approx(exact).margin(1.0 / 256));
+    }
+}
+
+TEST_CASE("pwmDitherStep 滿刻度與零", "[duty_ramp]") {
+    PwmDither dither = {};
+    CHECK(pwmDitherStep(dither, 0, 255, 2047) == 0);
+    CHECK(pwmDitherStep(dither, -100, 255, 2047) == 0);
+    CHECK(pwmDitherStep(dither, 255 * DUTY_Q8_ONE, 255, 2047) == 2047);
+}
+
+TEST_CASE("pwmResolutionBits 依頻率選擇最高解析度", "[duty_ramp]") {
+    CHECK(pwmResolutionBits(80000000, 20000, 14) == 11);
+    CHECK(pwmResolutionBits(80000000, 4000, 14) == 14);
+    CHECK(pwmResolutionBits(80000000, 1000, 14) == 14);
+    CHECK(pwmResolutionBits(80000000, 0, 14) == 1);
+}
@@ -0,0 +1,127 @@
+// --- 機械端點 (End-stop) 與堵轉偵測 ---
+#include <catch2/catch.hpp>
+#include "endstop_detector.h"
+
+// S 馬達的預設值: limit 250 → 接近上限 219，hold 90
+const int SATURATION = 219;
+const int HOLD = 90;
+const unsigned long TICK_MS = 10;
+
+// 以相同的命令與電流推進 durationMs，回傳最後一次的輸出
+static int run(EndstopDetector &detector, int command, int currentMa, unsigned long durationMs,
+               int holdDuty = HOLD) {
+    int output = command;
+    for (unsigned long t = 0; t < durationMs; t += TICK_MS) {
+        output = endstopUpdate(detector, ENDSTOP_DEFAULT, command, SATURATION, holdDuty, currentMa, TICK_MS);
+    }
+    return output;
+}
+
+TEST_CASE("無電流感測: 接近上限的 duty 持續 saturationMs 後進入 HOLDING", "[endstop]") {
+    EndstopDetector detector = {};
+    endstopReset(detector);
+
+    // 低於接近上限的 duty 不會被視為堵轉
+    CHECK(run(detector, 200, -1, 2000) == 200);
+    CHECK(detector.state == ENDSTOP_FREE);
+
+    CHECK(run(detector, 250, -1, ENDSTOP_DEFAULT.saturationMs - TICK_MS) == 250);
+    CHECK(detector.state == ENDSTOP_SUSPECT);
+    CHECK(run(detector, 250, -1, TICK_MS) == HOLD);
+    CHECK(detector.state == ENDSTOP_HOLDING);
+    CHECK(detector.detections == 1);
+
+    // 負方向相同
+    endstopReset(detector);
+    CHECK(run(detector, -250, -1, ENDSTOP_DEFAULT.saturationMs) == -HOLD);
+    CHECK(detector.state == ENDSTOP_HOLDING);
+}
+
+TEST_CASE("有電流感測: 電流持續超過門檻 currentConfirmMs 後進入 HOLDING，與 duty 無關", "[endstop]") {
+    EndstopDetector detector = {};
+    endstopReset(detector);
+    const int stall = ENDSTOP_DEFAULT.stallCurrentMa;
+
+    // 有電流感測時只看電流: 接近上限的 duty 但電流正常不算堵轉
+    CHECK(run(detector, 250, stall - 100, 2000) == 250);
+    CHECK(detector.state == ENDSTOP_FREE);
+
+    // 較低的 duty 也能以電流判斷
+    CHECK(run(detector, 150, stall + 100, ENDSTOP_DEFAULT.currentConfirmMs - TICK_MS) == 150);
+    CHECK(detector.state == ENDSTOP_SUSPECT);
+    CHECK(run(detector, 150, stall + 100, TICK_MS) == HOLD);
+    CHECK(detector.state == ENDSTOP_HOLDING);
+
+    // holding duty 高於命令時不放大輸出
+    endstopReset(detector);
+    CHECK(run(detector, 70, stall + 100, ENDSTOP_DEFAULT.currentConfirmMs) == 70);
+    CHECK(detector.state == ENDSTOP_HOLDING);
+}
+
+TEST_CASE("啟動推力的短暫高電流與高 duty 不會誤判", "[endstop]") {
+    EndstopDetector detector = {};
+    endstopReset(detector);
+    const int stall = ENDSTOP_DEFAULT.stallCurrentMa;
+
+    // 啟動推力 40 ms 的湧浪電流，之後馬達轉動電流下降
+    CHECK(run(detector, 150, stall * 2, 40) == 150);
+    CHECK(run(detector, 150, stall / 2, 1000) == 150);
+    CHECK(detector.state == ENDSTOP_FREE);
+    CHECK(detector.evidenceMs == 0);
+
+    // 無電流感測: 起步推力的 duty 短暫超過接近上限，接著回到一般 duty
+    endstopReset(detector);
+    CHECK(run(detector, 250, -1, 30) == 250);
+    CHECK(run(detector, 180, -1, 1000) == 180);
+    CHECK(detector.state == ENDSTOP_FREE);
+
+    // 跡象中斷後重新計時 (不會累積多次短暫的跡象)
+    for (int i = 0; i < 10; i++) {
+        run(detector, 250, -1, ENDSTOP_DEFAULT.saturationMs / 2);
+        run(detector, 180, -1, TICK_MS);
+    }
+    CHECK(detector.state == ENDSTOP_FREE);
+    CHECK(detector.detections == 0);
+}
+
+TEST_CASE("HOLDING 在命令歸零時解除，反向時離開並重新判斷", "[endstop]") {
+    EndstopDetector detector = {};
+    endstopReset(detector);
+    REQUIRE(run(detector, 250, -1, ENDSTOP_DEFAULT.saturationMs) == HOLD);
+
+    // 同方向的命令 (含較小的) 維持 holding
+    CHECK(run(detector, 250, -1, 1000) == HOLD);
+    CHECK(run(detector, 120, -1, 100) == HOLD);
+    CHECK(detector.state == ENDSTOP_HOLDING);
+
+    // 放開: 輸出 0 並解除
+    CHECK(endstopUpdate(detector, ENDSTOP_DEFAULT, 0, SATURATION, HOLD, -1, TICK_MS) == 0);
+    CHECK(detector.state == ENDSTOP_FREE);
+    CHECK(detector.direction == 0);
+    CHECK(run(detector, 250, -1, TICK_MS) == 250);
+
+    // 反向: 立即以完整的命令離開端點
+    endstopReset(detector);
+    REQUIRE(run(detector, 250, -1, ENDSTOP_DEFAULT.saturationMs) == HOLD);
+    CHECK(endstopUpdate(detector, ENDSTOP_DEFAULT, -250, SATURATION, HOLD, -1, TICK_MS) == -250);
+    CHECK(detector.state == ENDSTOP_SUSPECT);
+    CHECK(detector.direction == -1);
+    CHECK(run(detector, -250, -1, 200) == -250);
+    // 另一側的端點重新計時
+    CHECK(run(detector, -250, -1, ENDSTOP_DEFAULT.saturationMs) == -HOLD);
+    CHECK(detector.detections == 3);
+}
+
+TEST_CASE("holdDuty 為 0 時停用偵測", "[endstop]") {
+    EndstopDetector detector = {};
+    endstopReset(detector);
+    CHECK(run(detector, 250, -1, 5000, 0) == 250);
+    CHECK(run(detector, -250, ENDSTOP_DEFAULT.stallCurrentMa * 2, 5000, 0) == -250);
+    CHECK(detector.state == ENDSTOP_FREE);
+    CHECK(detector.detections == 0);
+
+    // 執行中停用 (例如 /config 改為 hold 0) 時立即恢復原本的命令
+    REQUIRE(run(detector, 250, -1, ENDSTOP_DEFAULT.saturationMs) == HOLD);
+    CHECK(endstopUpdate(detector, ENDSTOP_DEFAULT, 250, SATURATION, 0, -1, TICK_MS) == 250);
+    CHECK(detector.state == ENDSTOP_FREE);
+}
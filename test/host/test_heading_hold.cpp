@@ -0,0 +1,348 @@
+// --- I2C 陀螺儀 (FIFO 解析、積分) 與航向保持 ---
+#include <catch2/catch.hpp>
+#include <string.h>
+#include <vector>
+#include "fake_hal.h"
+#include "heading_hold.h"
+#include "imu_gyro.h"
+
+// 錄下的 FIFO 內容 (±500 °/s，靜止時零點約 -12，之後開始右轉)
+static const uint8_t RECORDED_FIFO[] = {
+    0xff, 0xf4, 0xff, 0xf2, 0xff, 0xf5, 0xff, 0xf3,     // -12 -14 -11 -13
+    0x00, 0x35, 0x01, 0x0c, 0x02, 0x8b, 0x03, 0xf7,     // 53 268 651 1015
+    0x7f, 0xff, 0x80, 0x00,                             // 32767 -32768 (量程兩端)
+};
+static const int16_t RECORDED_SAMPLES[] = { -12, -14, -11, -13, 53, 268, 651, 1015, 32767, -32768 };
+
+// 連續 count 個相同的原始值
+static void feed(GyroIntegrator &gyro, const GyroConfig &config, int16_t raw, int count, bool stationary) {
+    std::vector<int16_t> samples(count, raw);
+    gyroIntegrate(gyro, config, samples.data(), count, stationary);
+}
+
+// 以零點 bias 完成開機校正
+static void calibrate(GyroIntegrator &gyro, const GyroConfig &config, int16_t bias) {
+    gyroIntegratorReset(gyro);
+    feed(gyro, config, bias, (int)config.calibrationSamples, true);
+    REQUIRE(gyro.ready);
+}
+
+TEST_CASE("FIFO 解析: big-endian int16，不完整的樣本與超過上限的部分忽略", "[imu]") {
+    int16_t out[16];
+    const int total = sizeof(RECORDED_SAMPLES) / sizeof(RECORDED_SAMPLES[0]);
+    REQUIRE(gyroFifoParse(RECORDED_FIFO, sizeof(RECORDED_FIFO), out, 16) == total);
+    for (int i = 0; i < total; i++) CHECK(out[i] == RECORDED_SAMPLES[i]);
+
+    // 讀到一半的樣本 (奇數長度) 只取完整的部分
+    CHECK(gyroFifoParse(RECORDED_FIFO, 7, out, 16) == 3);
+    CHECK(out[2] == -11);
+    CHECK(gyroFifoParse(RECORDED_FIFO, 1, out, 16) == 0);
+    CHECK(gyroFifoParse(RECORDED_FIFO, 0, out, 16) == 0);
+
+    // 輸出緩衝區不足時停在上限
+    out[4] = 0x1234;
+    CHECK(gyroFifoParse(RECORDED_FIFO, sizeof(RECORDED_FIFO), out, 4) == 4);
+    CHECK(out[3] == -13);
+    CHECK(out[4] == 0x1234);
+}
+
+TEST_CASE("開機校正: 連續靜止的樣本平均為零點，期間移動則重新開始", "[imu]") {
+    const GyroConfig &c = GYRO_DEFAULT;
+    GyroIntegrator gyro;
+    gyroIntegratorReset(gyro);
+
+    feed(gyro, c, -12, (int)c.calibrationSamples - 1, true);
+    CHECK_FALSE(gyro.ready);
+    // 移動中的樣本讓校正從頭開始
+    feed(gyro, c, 400, 10, false);
+    CHECK(gyro.biasSamples == 0);
+    feed(gyro, c, -12, (int)c.calibrationSamples / 2, true);
+    feed(gyro, c, -14, (int)c.calibrationSamples / 2, true);
+    REQUIRE(gyro.ready);
+    CHECK(gyro.biasQ16 == -13 * 65536);
+    // 校正期間不積分
+    CHECK(gyro.headingUdeg == 0);
+}
+
+TEST_CASE("積分: 扣除零點後的角速度累積成航向，跨過 ±180° 時回繞", "[imu]") {
+    GyroConfig c = GYRO_DEFAULT;
+    GyroIntegrator gyro;
+    calibrate(gyro, c, -12);
+
+    // 10 °/s (655 LSB) 持續 1 秒 = 10°
+    feed(gyro, c, -12 + 655, 1000, false);
+    CHECK(gyro.rateMdps == 10000);
+    CHECK(gyro.headingUdeg == 10 * GYRO_DEG_UDEG);
+    // 零點本身不累積
+    feed(gyro, c, -12, 5000, false);
+    CHECK(gyro.rateMdps == 0);
+    CHECK(gyro.headingUdeg == 10 * GYRO_DEG_UDEG);
+
+    // 200 °/s 持續 1 秒: 10° + 200° = 210° → -150°
+    feed(gyro, c, -12 + 13100, 1000, false);
+    CHECK(gyro.headingUdeg == -150 * GYRO_DEG_UDEG);
+    feed(gyro, c, -12 - 13100, 1000, false);
+    CHECK(gyro.headingUdeg == 10 * GYRO_DEG_UDEG);
+
+    // 安裝方向相反時 (sign = -1) 同樣的讀值為左轉
+    c.sign = -1;
+    calibrate(gyro, c, -12);
+    feed(gyro, c, -12 + 655, 1000, false);
+    CHECK(gyro.headingUdeg == -10 * GYRO_DEG_UDEG);
+
+    // 錄下的資料: 前四個靜止樣本平均後接近 0，之後的轉動累積為正
+    c.sign = 1;
+    calibrate(gyro, c, -12);
+    const int total = sizeof(RECORDED_SAMPLES) / sizeof(RECORDED_SAMPLES[0]);
+    gyroIntegrate(gyro, c, RECORDED_SAMPLES, 4, false);
+    CHECK(abs(gyro.headingUdeg) < 100);
+    gyroIntegrate(gyro, c, RECORDED_SAMPLES + 4, total - 6, false);
+    CHECK(gyro.rateMdps > 0);
+    CHECK(gyro.headingUdeg > 0);
+}
+
+TEST_CASE("零點漂移: 靜止時追蹤，移動中或晃動太大時不追蹤", "[imu]") {
+    const GyroConfig &c = GYRO_DEFAULT;
+    GyroIntegrator gyro;
+    calibrate(gyro, c, -12);
+
+    // 零點漂移到 -2 (溫度變化): 靜止時 α = 1/4096，數秒後收斂，航向的誤差有限
+    feed(gyro, c, -2, 30000, true);
+    CHECK(gyro.biasQ16 / 65536.0 == Approx(-2).margin(0.1));
+    int32_t drifted = gyro.headingUdeg;
+    CHECK(abs(drifted) < GYRO_DEG_UDEG);
+    feed(gyro, c, -2, 10000, true);
+    CHECK(abs(gyro.headingUdeg - drifted) < GYRO_DEG_UDEG / 10);
+
+    // 移動中不追蹤 (轉彎的角速度不能被當成零點)
+    int64_t bias = gyro.biasQ16;
+    feed(gyro, c, 300, 1000, false);
+    CHECK(gyro.biasQ16 == bias);
+    // 靜止但被拿起晃動: 超過 stillRawLimit 的樣本不列入
+    feed(gyro, c, (int16_t)(-2 + c.stillRawLimit + 50), 1000, true);
+    CHECK(gyro.biasQ16 == bias);
+}
+
+TEST_CASE("航向差: 結果在 -180°..180°", "[imu]") {
+    CHECK(gyroHeadingDiffMdeg(10000, 4000) == 6000);
+    CHECK(gyroHeadingDiffMdeg(179000, -179000) == -2000);
+    CHECK(gyroHeadingDiffMdeg(-179000, 179000) == 2000);
+    CHECK(gyroHeadingDiffMdeg(0, 180000) == -180000);
+}
+
+// --- 航向保持 ---
+const HeadingHoldConfig &HOLD = HEADING_HOLD_DEFAULT;
+
+// 搖桿回中、直行並保持角速度 rate 經過 ms
+static int steady(HeadingHoldState &state, int throttle, int32_t heading, int32_t rate, unsigned long ms) {
+    int trim = 0;
+    for (unsigned long t = 0; t < ms; t += 10) trim = headingHoldUpdate(state, HOLD, true, throttle, heading, rate, 10);
+    return trim;
+}
+
+TEST_CASE("航向保持: 回中且角速度穩定 engageMs 後鎖定航向", "[heading_hold]") {
+    HeadingHoldState state = {};
+    headingHoldReset(state);
+
+    // 低速或轉向中不介入
+    CHECK(steady(state, HOLD.minThrottle - 1, 0, 0, 1000) == 0);
+    CHECK_FALSE(state.holding);
+    CHECK(headingHoldUpdate(state, HOLD, false, 200, 0, 0, 10) == 0);
+    CHECK_FALSE(state.holding);
+
+    // 轉彎的餘勁 (角速度仍高) 時不鎖定
+    CHECK(steady(state, 200, 30000, HOLD.settleRateMdps + 1000, 1000) == 0);
+    CHECK_FALSE(state.holding);
+
+    steady(state, 200, 30000, 0, HOLD.engageMs - 10);
+    CHECK_FALSE(state.holding);
+    steady(state, 200, 30000, 0, 10);
+    REQUIRE(state.holding);
+    CHECK(state.targetMdeg == 30000);
+    CHECK(state.engagements == 1);
+    CHECK(state.trim == 0);
+}
+
+TEST_CASE("航向保持: PD 修正量的方向、大小與上限", "[heading_hold]") {
+    HeadingHoldState state = {};
+    headingHoldReset(state);
+    steady(state, 200, 0, 0, HOLD.engageMs);
+    REQUIRE(state.holding);
+
+    // 偏右 5°: 向左修正 kp × 5
+    int trim = headingHoldUpdate(state, HOLD, true, 200, 5000, 0, 10);
+    CHECK(trim == -HOLD.kp * 5 / 256);
+    CHECK(trim < 0);
+    // 偏左 5° 且正在向右修正回來 (角速度項抑制過衝)
+    int damped = headingHoldUpdate(state, HOLD, true, 200, -5000, 20000, 10);
+    CHECK(damped == (HOLD.kp * 5 - HOLD.kd * 20) / 256);
+    CHECK(damped < -trim);
+    // 誤差很大時不超過上限
+    CHECK(headingHoldUpdate(state, HOLD, true, 200, 90000, 0, 10) == -HOLD.maxTrim);
+    CHECK(headingHoldUpdate(state, HOLD, true, 200, -90000, 0, 10) == HOLD.maxTrim);
+    // 倒車時轉向對航向的作用相反
+    CHECK(headingHoldUpdate(state, HOLD, true, -200, 5000, 0, 10) == HOLD.kp * 5 / 256);
+
+    // 鎖定在 179° 時，航向跨過 180° 到 -179° 是偏右 2°
+    headingHoldReset(state);
+    steady(state, 200, 179000, 0, HOLD.engageMs);
+    CHECK(headingHoldUpdate(state, HOLD, true, 200, -179000, 0, 10) == -HOLD.kp * 2 / 256);
+}
+
+TEST_CASE("航向保持: 搖桿離開中心立即放開，回中後鎖定新的航向", "[heading_hold]") {
+    HeadingHoldState state = {};
+    headingHoldReset(state);
+    steady(state, 200, 0, 0, HOLD.engageMs);
+    REQUIRE(state.holding);
+    CHECK(headingHoldUpdate(state, HOLD, true, 200, 3000, 0, 10) != 0);
+
+    CHECK(headingHoldUpdate(state, HOLD, false, 200, 3000, 0, 10) == 0);
+    CHECK_FALSE(state.holding);
+    CHECK(state.trim == 0);
+
+    // 轉到 45° 後回中: 等角速度穩定再鎖定新的航向，不會轉回原本的航向
+    CHECK(steady(state, 200, 45000, 0, HOLD.engageMs) == 0);
+    REQUIRE(state.holding);
+    CHECK(state.targetMdeg == 45000);
+    CHECK(state.engagements == 2);
+    // 停車 (低於 minThrottle) 同樣放開
+    CHECK(headingHoldUpdate(state, HOLD, true, 0, 50000, 0, 10) == 0);
+    CHECK_FALSE(state.holding);
+}
+
+// --- 韌體端: 以假的 MPU-6050 測試 FIFO 的讀取、溢位與 I2C 錯誤 ---
+static std::vector<uint8_t> mpuFifo;
+static bool mpuOverflow = false;
+static bool mpuFailReads = false;
+static int mpuFifoResets = 0;
+
+static bool mpuWrite(uint8_t addr, uint8_t reg, uint8_t value) {
+    if (addr != 0x68) return false;
+    if (reg == 0x6A && (value & 0x04)) {
+        mpuFifo.clear();
+        mpuFifoResets++;
+    }
+    return true;
+}
+
+static bool mpuRead(uint8_t addr, uint8_t reg, uint8_t *buf, size_t len) {
+    if (addr != 0x68 || mpuFailReads) return false;
+    if (reg == 0x75) {
+        buf[0] = 0x68;
+    } else if (reg == 0x3A) {
+        buf[0] = mpuOverflow ? 0x10 : 0;
+        mpuOverflow = false;
+    } else if (reg == 0x72) {
+        buf[0] = (uint8_t)(mpuFifo.size() >> 8);
+        buf[1] = (uint8_t)mpuFifo.size();
+    } else if (reg == 0x74 && len <= mpuFifo.size()) {
+        memcpy(buf, mpuFifo.data(), len);
+        mpuFifo.erase(mpuFifo.begin(), mpuFifo.begin() + len);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static void mpuPush(int16_t raw, int count) {
+    for (int i = 0; i < count; i++) {
+        mpuFifo.push_back((uint8_t)((uint16_t)raw >> 8));
+        mpuFifo.push_back((uint8_t)raw);
+    }
+}
+
+static void mpuAttach() {
+    mpuFifo.clear();
+    mpuOverflow = false;
+    mpuFailReads = false;
+    mpuFifoResets = 0;
+    fakeHalI2cAttach(FakeI2cDevice{ mpuWrite, mpuRead });
+    fakeHalAcceptTasks(true);
+}
+
+TEST_CASE("陀螺儀任務: 未安裝或找不到感測器時不啟用", "[imu]") {
+    gyroInit(-1, -1, 1);
+    CHECK_FALSE(gyroPresent());
+    // 匯流排上沒有裝置
+    fakeHalAcceptTasks(true);
+    gyroInit(0, 1, 1);
+    CHECK_FALSE(gyroPresent());
+    CHECK(fakeHalLogText().find("找不到陀螺儀") != std::string::npos);
+}
+
+TEST_CASE("陀螺儀任務: 分批讀出 FIFO，校正完成後公開航向", "[imu]") {
+    mpuAttach();
+    gyroInit(0, 1, 1);
+    CHECK(mpuFifoResets == 1);
+    CHECK_FALSE(gyroPresent());
+
+    // 開機校正: 1 秒的靜止樣本 (一次累積 2000 bytes，超過單次讀取上限，分批讀出)
+    gyroSetStationary(true);
+    mpuPush(-12, 1000);
+    gyroPoll();
+    CHECK(mpuFifo.empty());
+    CHECK(gyroStats().samples == 1000);
+    REQUIRE(gyroPresent());
+    CHECK(gyroHeadingMdeg() == 0);
+
+    // 10 °/s 持續 0.5 秒
+    gyroSetStationary(false);
+    for (int i = 0; i < 50; i++) {
+        mpuPush(-12 + 655, 10);
+        gyroPoll();
+    }
+    CHECK(gyroYawRateMdps() == 10000);
+    CHECK(gyroHeadingMdeg() == 5000);
+
+    // 任務讀取時感測器正好寫到一半: 不完整的樣本留到下一次
+    mpuPush(-12 + 655, 3);
+    mpuFifo.push_back(0x02);
+    gyroPoll();
+    CHECK(mpuFifo.size() == 1);
+    mpuFifo.push_back(0x75);        // 0x0275 = 629 = -12 + 641
+    gyroPoll();
+    CHECK(mpuFifo.empty());
+    CHECK(gyroStats().samples == 1000 + 500 + 4);
+    CHECK(gyroHeadingMdeg() == 5000 + 30 + 9);
+    CHECK(gyroStats().fifoOverflows == 0);
+    CHECK(gyroStats().i2cErrors == 0);
+}
+
+TEST_CASE("陀螺儀任務: FIFO 溢位時整個丟棄並重設，I2C 失敗時保留原本的數值", "[imu]") {
+    mpuAttach();
+    gyroInit(0, 1, 1);
+    mpuPush(0, 1000);
+    gyroPoll();
+    REQUIRE(gyroPresent());
+
+    // 任務來不及讀取: FIFO 已滿 (內容可能錯位)
+    gyroSetStationary(false);
+    mpuPush(655, 512);
+    mpuOverflow = true;
+    gyroPoll();
+    CHECK(gyroStats().fifoOverflows == 1);
+    CHECK(mpuFifoResets == 2);
+    CHECK(mpuFifo.empty());
+    CHECK(gyroHeadingMdeg() == 0);
+    CHECK(gyroPresent());
+
+    // 重設後恢復正常
+    mpuPush(655, 100);
+    gyroPoll();
+    CHECK(gyroHeadingMdeg() == 1000);
+
+    // I2C 失敗: 計數並保留最後的航向
+    mpuFailReads = true;
+    mpuPush(655, 100);
+    gyroPoll();
+    CHECK(gyroStats().i2cErrors == 1);
+    CHECK(gyroHeadingMdeg() == 1000);
+    mpuFailReads = false;
+    gyroPoll();
+    CHECK(gyroHeadingMdeg() == 2000);
+
+    // 重新初始化時清除統計
+    gyroInit(-1, -1, 1);
+    CHECK(gyroStats().fifoOverflows == 0);
+    CHECK_FALSE(gyroPresent());
+}
@@ -0,0 +1,126 @@
+// --- 設定值抖動緩衝 ---
+#include <catch2/catch.hpp>
+#include "jitter_buffer.h"
+
+// 緩衝的狀態是整個韌體共用的，每個案例使用自己的時間區段與 session
+static unsigned long freshBase() {
+    static unsigned long base = 1000000;
+    base += 1000000;
+    return base;
+}
+
+// 設定延遲後執行一次 loop 的 playout，讓讀取端套用新設定
+static void applyDelay(int delayMs) {
+    jitterBufferSetDelay(delayMs);
+    int t;
+    int s;
+    jitterBufferPlayout(0, &t, &s);
+}
+
+TEST_CASE("延遲為 0 時緩衝關閉", "[jitter_buffer]") {
+    jitterBufferSetDelay(0);
+    CHECK_FALSE(jitterBufferEnabled());
+    CHECK_FALSE(jitterBufferPush(1, 0, 100, 0, freshBase()));
+    int t;
+    int s;
+    CHECK_FALSE(jitterBufferPlayout(freshBase(), &t, &s));
+}
+
+TEST_CASE("延遲設定限制在 0..JITTER_DELAY_MAX_MS", "[jitter_buffer]") {
+    jitterBufferSetDelay(-5);
+    CHECK(jitterBufferStats().delayMs == 0);
+    jitterBufferSetDelay(10000);
+    CHECK(jitterBufferStats().delayMs == JITTER_DELAY_MAX_MS);
+    applyDelay(0);
+}
+
+TEST_CASE("依原始間隔延遲播放並在兩筆之間內插", "[jitter_buffer]") {
+    applyDelay(50);
+    unsigned long now = freshBase();
+    int t = 0;
+    int s = 0;
+
+    // 第一筆決定時鐘偏移: 播放時間 = 抵達時間 + 50
+    REQUIRE(jitterBufferPush(11, 1000, 0, 0, now));
+    REQUIRE(jitterBufferPush(11, 1020, 100, -40, now + 20));
+    CHECK_FALSE(jitterBufferPlayout(now + 49, &t, &s));
+    REQUIRE(jitterBufferPlayout(now + 50, &t, &s));
+    CHECK(t == 0);
+    REQUIRE(jitterBufferPlayout(now + 60, &t, &s));
+    CHECK(t == 50);
+    CHECK(s == -20);
+
+    // 緩衝播完: 維持最後一筆並記錄一次 underrun，閒置過久後交還給直接命令
+    uint32_t underruns = jitterBufferStats().underruns;
+    REQUIRE(jitterBufferPlayout(now + 70, &t, &s));
+    CHECK(t == 100);
+    REQUIRE(jitterBufferPlayout(now + 80, &t, &s));
+    REQUIRE(jitterBufferPlayout(now + 90, &t, &s));
+    CHECK(t == 100);
+    CHECK(jitterBufferStats().underruns == underruns + 1);
+    CHECK_FALSE(jitterBufferPlayout(now + 700, &t, &s));
+    applyDelay(0);
+}
+
+TEST_CASE("抖動抵達的命令以客戶端時間播放", "[jitter_buffer]") {
+    applyDelay(60);
+    unsigned long now = freshBase();
+    // 客戶端每 20ms 取樣，抵達時間有 0..40ms 的抖動
+    const int jitter[] = { 0, 35, 5, 40, 10, 0, 25 };
+    for (int i = 0; i < 7; i++) {
+        REQUIRE(jitterBufferPush(12, (uint32_t)(i * 20), i * 10, 0, now + i * 20 + jitter[i]));
+    }
+    int t = 0;
+    int s = 0;
+    for (int i = 0; i < 7; i++) {
+        REQUIRE(jitterBufferPlayout(now + 60 + i * 20, &t, &s));
+        CHECK(t == i * 10);
+    }
+    CHECK(jitterBufferStats().late == 0);
+    applyDelay(0);
+}
+
+TEST_CASE("時間戳沒有前進的命令被丟棄", "[jitter_buffer]") {
+    applyDelay(30);
+    unsigned long now = freshBase();
+    REQUIRE(jitterBufferPush(13, 500, 10, 0, now));
+    CHECK_FALSE(jitterBufferPush(13, 500, 20, 0, now + 1));
+    CHECK_FALSE(jitterBufferPush(13, 480, 20, 0, now + 2));
+    // 新的 session 使用自己的時鐘
+    CHECK(jitterBufferPush(14, 3, 20, 0, now + 3));
+    applyDelay(0);
+}
+
+TEST_CASE("緩衝已滿時丟棄並計數", "[jitter_buffer]") {
+    applyDelay(JITTER_DELAY_MAX_MS);
+    unsigned long now = freshBase();
+    uint32_t overflows = jitterBufferStats().overflows;
+    for (int i = 0; i < JITTER_BUFFER_SIZE; i++) {
+        REQUIRE(jitterBufferPush(15, (uint32_t)(i + 1), i, 0, now));
+    }
+    CHECK(jitterBufferStats().depth == JITTER_BUFFER_SIZE);
+    CHECK_FALSE(jitterBufferPush(15, 100, 0, 0, now));
+    CHECK(jitterBufferStats().overflows == overflows + 1);
+    applyDelay(0);
+}
+
+TEST_CASE("新的延遲由讀取端套用，只丟棄設定之前的資料", "[jitter_buffer]") {
+    applyDelay(40);
+    unsigned long now = freshBase();
+    REQUIRE(jitterBufferPush(16, 0, 10, 0, now));
+    REQUIRE(jitterBufferPush(16, 20, 20, 0, now + 20));
+
+    // 寫入端只公開設定，讀取端的緩衝要等下一次 playout 才清掉
+    jitterBufferSetDelay(80);
+    CHECK(jitterBufferStats().delayMs == 80);
+    CHECK(jitterBufferStats().depth == 2);
+    REQUIRE(jitterBufferPush(17, 1000, 30, 0, now + 25));
+
+    int t = 0;
+    int s = 0;
+    CHECK_FALSE(jitterBufferPlayout(now + 60, &t, &s));
+    CHECK(jitterBufferStats().depth == 1);
+    REQUIRE(jitterBufferPlayout(now + 105, &t, &s));
+    CHECK(t == 30);
+    applyDelay(0);
+}
@@ -0,0 +1,78 @@
+// --- 控制連線監督 ---
+#include <catch2/catch.hpp>
+#include "link_supervisor.h"
+
+// 監督的狀態是整個韌體共用的，每個案例使用自己的時間區段並以一筆命令開始
+static unsigned long freshBase() {
+    static unsigned long base = 1000000;
+    base += 1000000;
+    return base;
+}
+
+TEST_CASE("命令持續抵達時維持滿刻度", "[link_supervisor]") {
+    linkSupervisorConfigure(LINK_SUPERVISOR_DEFAULT);
+    unsigned long t0 = freshBase();
+    for (unsigned long t = t0; t < t0 + 2000; t += 100) {
+        linkSupervisorOnCommand(t, true);
+        CHECK(linkSupervisorScale(t + 50) == LINK_SCALE_ONE);
+    }
+    CHECK_FALSE(linkSupervisorDegraded());
+}
+
+TEST_CASE("超過 grace 後線性衰減到 0，命令恢復後立即回復", "[link_supervisor]") {
+    linkSupervisorConfigure(LINK_SUPERVISOR_DEFAULT);
+    unsigned long t0 = freshBase();
+    linkSupervisorOnCommand(t0, true);
+    uint32_t losses = linkSupervisorLossCount();
+
+    CHECK(linkSupervisorScale(t0 + 300) == LINK_SCALE_ONE);
+    CHECK(linkSupervisorScale(t0 + 550) == LINK_SCALE_ONE / 2);
+    CHECK(linkSupervisorDegraded());
+    CHECK(linkSupervisorScale(t0 + 800) == 0);
+    CHECK(linkSupervisorScale(t0 + 5000) == 0);
+    CHECK(linkSupervisorLossCount() == losses + 1);
+
+    linkSupervisorOnCommand(t0 + 5100, true);
+    CHECK(linkSupervisorScale(t0 + 5100) == LINK_SCALE_ONE);
+    CHECK_FALSE(linkSupervisorDegraded());
+}
+
+TEST_CASE("指數衰減每 decayMs/8 減半", "[link_supervisor]") {
+    LinkSupervisorConfig config = { 100, 800, LINK_DECAY_EXPONENTIAL };
+    linkSupervisorConfigure(config);
+    unsigned long t0 = freshBase();
+    linkSupervisorOnCommand(t0, true);
+    CHECK(linkSupervisorScale(t0 + 200) == LINK_SCALE_ONE / 2);
+    CHECK(linkSupervisorScale(t0 + 300) == LINK_SCALE_ONE / 4);
+    CHECK(linkSupervisorScale(t0 + 900) == 0);
+    linkSupervisorConfigure(LINK_SUPERVISOR_DEFAULT);
+}
+
+TEST_CASE("命令時間晚於 tick 的時間時視為剛收到", "[link_supervisor]") {
+    linkSupervisorConfigure(LINK_SUPERVISOR_DEFAULT);
+    unsigned long t0 = freshBase();
+    linkSupervisorOnCommand(t0 + 5, true);
+    CHECK(linkSupervisorScale(t0) == LINK_SCALE_ONE);
+}
+
+TEST_CASE("最後的目標為 0 時命令停止不算遺失", "[link_supervisor]") {
+    linkSupervisorConfigure(LINK_SUPERVISOR_DEFAULT);
+    unsigned long t0 = freshBase();
+    uint32_t losses = linkSupervisorLossCount();
+
+    // 放開搖桿: 最後一筆命令的目標為 0，之後不再送命令
+    linkSupervisorOnCommand(t0, true);
+    linkSupervisorOnCommand(t0 + 100, false);
+    CHECK_FALSE(linkSupervisorArmed());
+    CHECK(linkSupervisorScale(t0 + 5000) == LINK_SCALE_ONE);
+    CHECK_FALSE(linkSupervisorDegraded());
+    CHECK(linkSupervisorLossCount() == losses);
+
+    // 再次推動搖桿後恢復監督
+    linkSupervisorOnCommand(t0 + 6000, true);
+    CHECK(linkSupervisorScale(t0 + 6400) < LINK_SCALE_ONE);
+    CHECK(linkSupervisorLossCount() == losses + 1);
+    linkSupervisorOnCommand(t0 + 6500, false);
+    CHECK(linkSupervisorScale(t0 + 6500) == LINK_SCALE_ONE);
+    CHECK_FALSE(linkSupervisorDegraded());
+}
@@ -0,0 +1,15 @@
+// --- Catch2 主程式: 每個測試案例開始前重設假 HAL ---
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include "fake_hal.h"
+
+struct FakeHalListener : Catch::TestEventListenerBase {
+    using TestEventListenerBase::TestEventListenerBase;
+
+    void testCaseStarting(const Catch::TestCaseInfo &info) override {
+        (void)info;
+        fakeHalReset();
+    }
+};
+
+CATCH_REGISTER_LISTENER(FakeHalListener)
@@ -0,0 +1,233 @@
+// --- 執行期可調整的馬達參數 ---
+#include <string.h>
+#include <catch2/catch.hpp>
+#include "fake_hal.h"
+#include "hal.h"
+#include "link_supervisor.h"
+#include "motor_config.h"
+#include "motor_control.h"
+#include "steering_schedule.h"
+
+static MotorConfig current() {
+    MotorConfig config;
+    uint32_t version;
+    motorConfigSnapshot(config, version);
+    return config;
+}
+
+static MotorConfig defaults() {
+    MotorConfig config = current();
+    REQUIRE(motorConfigSelectProfile(config, "default", 7));
+    return config;
+}
+
+static bool field(MotorConfig &config, const char *name, const char *value) {
+    return motorConfigField(config, name, strlen(name), value, strlen(value));
+}
+
+static bool parse(MotorConfig &config, const char *json) {
+    return motorConfigParseJson(config, json, strlen(json));
+}
+
+TEST_CASE("profile 切換保留校正過的最低有效 duty", "[motor_config]") {
+    MotorConfig config = defaults();
+    config.t.minDuty = 37;
+    REQUIRE(motorConfigSelectProfile(config, "race", 4));
+    CHECK(strcmp(config.profile, "race") == 0);
+    CHECK(config.t.limit == 255);
+    CHECK(config.t.minDuty == 37);
+    CHECK(config.system.linkDecayMs == (int16_t)LINK_SUPERVISOR_DEFAULT.decayMs);
+    config.system.linkGraceMs = 900;
+    REQUIRE(motorConfigSelectProfile(config, "indoor", 6));
+    CHECK(config.system.linkGraceMs == 900);
+    CHECK_FALSE(motorConfigSelectProfile(config, "rac", 3));
+    CHECK_FALSE(motorConfigSelectProfile(config, "turbo", 5));
+}
+
+TEST_CASE("motorConfigField 依 _t/_s 後綴套用欄位", "[motor_config]") {
+    MotorConfig config = defaults();
+    REQUIRE(field(config, "step_t", "8"));
+    REQUIRE(field(config, "limit_s", "230"));
+    REQUIRE(field(config, "kick_ms_s", "0"));
+    REQUIRE(field(config, "drive_t", "1"));
+    REQUIRE(field(config, "ramp_interval_ms", "20"));
+    REQUIRE(field(config, "version", "123"));
+    CHECK(config.t.step == 8);
+    CHECK(config.s.limit == 230);
+    CHECK(config.s.kickMs == 0);
+    CHECK(config.t.drive == DECAY_SLOW);
+    CHECK(config.rampIntervalMs == 20);
+
+    REQUIRE(field(config, "link_grace_ms", "150"));
+    REQUIRE(field(config, "link_decay", "1"));
+    CHECK(config.system.linkGraceMs == 150);
+    CHECK(config.system.linkDecay == LINK_DECAY_EXPONENTIAL);
+
+    CHECK_FALSE(field(config, "link_decay", "2"));
+    CHECK_FALSE(field(config, "step_x", "8"));
+    CHECK_FALSE(field(config, "speed_t", "8"));
+    CHECK_FALSE(field(config, "drive_t", "2"));
+    CHECK_FALSE(field(config, "step_t", "fast"));
+    CHECK_FALSE(field(config, "t", "8"));
+}
+
+TEST_CASE("steering 欄位替換轉向權限表格", "[motor_config]") {
+    MotorConfig config = defaults();
+    REQUIRE(field(config, "steering", "0:256:320,120:180:200"));
+    CHECK(config.system.steeringPoints == 2);
+    CHECK(config.system.steering[1].throttle == 120);
+    CHECK(config.system.steering[1].targetScale == 180);
+    CHECK(config.system.steering[1].stepScale == 200);
+    CHECK(config.system.steering[2].throttle == 0);
+
+    CHECK_FALSE(field(config, "steering", ""));
+    CHECK_FALSE(field(config, "steering", "0:256"));
+    CHECK_FALSE(field(config, "steering", "0:256:256,"));
+    CHECK_FALSE(field(config, "steering", "80:256:256,80:200:200"));     // throttle 未遞增
+    CHECK_FALSE(field(config, "steering", "0:2000:256"));                // 縮放超出範圍
+    CHECK_FALSE(field(config, "steering", "0:1:1,1:1:1,2:1:1,3:1:1,4:1:1,5:1:1,6:1:1"));
+    CHECK(config.system.steeringPoints == 2);
+}
+
+TEST_CASE("speed_ 欄位設定閉迴路速度控制", "[motor_config]") {
+    MotorConfig config = defaults();
+    const MotorSystemConfig original = config.system;
+    CHECK(config.system.speedKp == SPEED_LOOP_DEFAULT.kp);
+    REQUIRE(parse(config, "{\"speed_kp\":200,\"speed_ki\":0,\"speed_period_ms\":10,\"speed_full\":3500}"));
+    CHECK(config.system.speedKp == 200);
+    CHECK(config.system.speedKi == 0);
+    CHECK(config.system.speedPeriodMs == 10);
+    CHECK(config.system.speedFull == 3500);
+    REQUIRE(motorConfigPublish(config, false) == MOTOR_CONFIG_APPLIED);
+
+    REQUIRE(field(config, "speed_period_ms", "0"));
+    CHECK(motorConfigPublish(config, false) == MOTOR_CONFIG_INVALID);
+    config = defaults();
+    REQUIRE(field(config, "speed_kp", "-1"));
+    CHECK(motorConfigPublish(config, false) == MOTOR_CONFIG_INVALID);
+
+    // 速度迴路的設定不隨 profile 改變，直接換回原本的值
+    config = defaults();
+    config.system = original;
+    REQUIRE(motorConfigPublish(config, false) == MOTOR_CONFIG_APPLIED);
+}
+
+TEST_CASE("motorConfigParseJson 只接受扁平物件", "[motor_config]") {
+    MotorConfig config = defaults();
+    REQUIRE(parse(config, " { \"step_t\" : 9, \"profile\":\"indoor\",\"hold_s\":80 } "));
+    CHECK(strcmp(config.profile, "indoor") == 0);
+    CHECK(config.s.holdDuty == 80);
+    REQUIRE(parse(config, "{}"));
+
+    CHECK_FALSE(parse(config, ""));
+    CHECK_FALSE(parse(config, "{\"step_t\" 9}"));
+    CHECK_FALSE(parse(config, "{\"step_t\":9,}"));
+    CHECK_FALSE(parse(config, "{\"step_t\":{\"a\":1}}"));
+    CHECK_FALSE(parse(config, "{\"step_t\":9} x"));
+    CHECK_FALSE(parse(config, "{\"st\\\"ep_t\":9}"));
+}
+
+TEST_CASE("motorConfigPublish 拒絕超出範圍的設定", "[motor_config]") {
+    uint32_t before = motorConfigVersion();
+    MotorConfig config = defaults();
+    config.t.limit = 0;
+    CHECK(motorConfigPublish(config, false) == MOTOR_CONFIG_INVALID);
+    config = defaults();
+    config.s.minDuty = config.s.limit + 1;
+    CHECK(motorConfigPublish(config, false) == MOTOR_CONFIG_INVALID);
+    config = defaults();
+    config.rampIntervalMs = MOTOR_CONFIG_INTERVAL_MAX_MS + 1;
+    CHECK(motorConfigPublish(config, false) == MOTOR_CONFIG_INVALID);
+    config = defaults();
+    config.system.linkDecayMs = 0;
+    CHECK(motorConfigPublish(config, false) == MOTOR_CONFIG_INVALID);
+    CHECK(motorConfigVersion() == before);
+}
+
+TEST_CASE("公開的設定可由 snapshot 取得並存入 NVS", "[motor_config]") {
+    MotorConfig config = defaults();
+    config.t.step = 7;
+    uint32_t before = motorConfigVersion();
+    REQUIRE(motorConfigPublish(config, true) == MOTOR_CONFIG_APPLIED);
+    CHECK(motorConfigVersion() == before + 1);
+    CHECK(current().t.step == 7);
+    CHECK(fakeHalStoreHas("motor_cfg"));
+
+    // 重新開機: 先換成別的設定，再由 NVS 載入
+    REQUIRE(motorConfigPublish(defaults(), false) == MOTOR_CONFIG_APPLIED);
+    motorConfigLoad();
+    CHECK(current().t.step == 7);
+    REQUIRE(motorConfigPublish(defaults(), false) == MOTOR_CONFIG_APPLIED);
+}
+
+TEST_CASE("NVS 寫入失敗時仍公開設定並回報未儲存", "[motor_config]") {
+    MotorConfig config = defaults();
+    config.t.step = 6;
+    fakeHalStoreFailWrites(true);
+    CHECK(motorConfigPublish(config, true) == MOTOR_CONFIG_NOT_SAVED);
+    CHECK(current().t.step == 6);
+    CHECK_FALSE(fakeHalStoreHas("motor_cfg"));
+    CHECK(motorConfigPublish(config, false) == MOTOR_CONFIG_APPLIED);
+    fakeHalStoreFailWrites(false);
+    REQUIRE(motorConfigPublish(defaults(), false) == MOTOR_CONFIG_APPLIED);
+}
+
+TEST_CASE("沒有儲存的設定時載入 default profile", "[motor_config]") {
+    MotorConfig config = defaults();
+    config.s.step = 3;
+    REQUIRE(motorConfigPublish(config, false) == MOTOR_CONFIG_APPLIED);
+    motorConfigLoad();
+    CHECK(strcmp(current().profile, "default") == 0);
+    CHECK(current().s.step == defaults().s.step);
+}
+
+TEST_CASE("motorConfigFormatJson 的輸出可以原樣送回", "[motor_config]") {
+    MotorConfig config = defaults();
+    config.t.kick = 111;
+    config.s.stop = STOP_BRAKE;
+    REQUIRE(motorConfigPublish(config, false) == MOTOR_CONFIG_APPLIED);
+
+    char json[768];
+    size_t len = motorConfigFormatJson(json, sizeof(json));
+    REQUIRE(len < sizeof(json) - 1);
+    MotorConfig parsed = defaults();
+    REQUIRE(motorConfigParseJson(parsed, json, len));
+    CHECK(parsed.t.kick == 111);
+    CHECK(parsed.s.stop == STOP_BRAKE);
+    CHECK(memcmp(&parsed, &config, sizeof(config)) == 0);
+    REQUIRE(motorConfigPublish(defaults(), false) == MOTOR_CONFIG_APPLIED);
+}
+
+TEST_CASE("連線監督的設定由 Ramping 任務換上", "[motor_config]") {
+    motorInit();
+    MotorConfig config = defaults();
+    REQUIRE(field(config, "link_grace_ms", "100"));
+    REQUIRE(motorConfigPublish(config, false) == MOTOR_CONFIG_APPLIED);
+    motorRampTask();
+
+    unsigned long t0 = halMillis();
+    linkSupervisorOnCommand(t0, true);
+    CHECK(linkSupervisorScale(t0 + 100) == LINK_SCALE_ONE);
+    CHECK(linkSupervisorScale(t0 + 200) < LINK_SCALE_ONE);
+
+    // 連線設定不隨 profile 改變，直接改回預設值
+    REQUIRE(field(config, "link_grace_ms", "300"));
+    REQUIRE(motorConfigPublish(config, false) == MOTOR_CONFIG_APPLIED);
+    motorRampTask();
+    CHECK(linkSupervisorScale(t0 + 200) == LINK_SCALE_ONE);
+}
+
+TEST_CASE("轉向權限表格由 Ramping 任務換上", "[motor_config]") {
+    motorInit();
+    CHECK(steeringScheduleLookup(250).target == 150);
+    MotorConfig config = defaults();
+    REQUIRE(field(config, "steering", "0:256:256,255:64:128"));
+    REQUIRE(motorConfigPublish(config, false) == MOTOR_CONFIG_APPLIED);
+    motorRampTask();
+    CHECK(steeringScheduleLookup(255).target == 64);
+
+    REQUIRE(field(config, "steering", "0:256:384,80:256:256,150:200:224,200:150:192"));
+    REQUIRE(motorConfigPublish(config, false) == MOTOR_CONFIG_APPLIED);
+    motorRampTask();
+    CHECK(steeringScheduleLookup(250).target == 150);
+}
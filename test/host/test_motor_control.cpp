@@ -0,0 +1,101 @@
+// --- 馬達控制核心 (緊急停止、最低有效 duty 校正) ---
+#include <catch2/catch.hpp>
+#include "fake_hal.h"
+#include "motor_config.h"
+#include "motor_control.h"
+
+// 以 Ramping 任務的週期推進 n 個 tick
+static void runTicks(int n) {
+    for (int i = 0; i < n; i++) {
+        fakeHalAdvanceMs(10);
+        motorRampTask();
+    }
+}
+
+static bool outputsStopped() {
+    for (int i = 0; i < motorChannelCount(); i++) {
+        const MotorChannelDesc &desc = motorChannelDesc(i);
+        // 停止時兩腳輸出相同 (滑行 LOW/LOW 或煞車 HIGH/HIGH)
+        if (fakeHalPwmDuty(desc.ledcFwd) != fakeHalPwmDuty(desc.ledcRev)) return false;
+    }
+    return true;
+}
+
+TEST_CASE("緊急停止只寫入輸出，Ramping 狀態由 Ramping 任務清除", "[motor_control]") {
+    motorInit();
+    motorSetTarget(255, 0);
+    runTicks(30);
+    REQUIRE(motorChannelState(0).current != 0);
+    REQUIRE_FALSE(outputsStopped());
+
+    motorEmergencyStop("test", halMicros());
+    CHECK(outputsStopped());
+    CHECK(motorChannelState(0).target == 0);
+    CHECK(motorChannelState(0).current != 0);   // 不在 Ramping 任務之外修改
+
+    runTicks(1);
+    CHECK(motorChannelState(0).current == 0);
+    CHECK(motorChannelState(0).output == 0);
+    CHECK(outputsStopped());
+
+    // 鎖定中忽略目標
+    motorSetTarget(255, 0);
+    runTicks(5);
+    CHECK(outputsStopped());
+    motorRearm();
+}
+
+TEST_CASE("在下一個 tick 之前解除鎖定時仍清除停止前的狀態", "[motor_control]") {
+    motorInit();
+    motorSetTarget(255, 0);
+    runTicks(30);
+    REQUIRE(motorChannelState(0).current != 0);
+
+    motorEmergencyStop("test", halMicros());
+    motorRearm();
+    CHECK_FALSE(motorEstopLatched());
+    runTicks(1);
+    CHECK(motorChannelState(0).current == 0);
+    CHECK(outputsStopped());
+}
+
+static bool targetsZero() {
+    for (int i = 0; i < motorChannelCount(); i++) {
+        if (motorChannelState(i).target != 0) return false;
+    }
+    return true;
+}
+
+TEST_CASE("校正的開始、標記與取消都把目標歸零", "[motor_control]") {
+    motorInit();
+    motorSetTarget(200, 100);
+    REQUIRE_FALSE(targetsZero());
+    motorCalibrateStart(MOTOR_T);
+    CHECK(targetsZero());
+
+    // 校正期間收到的命令不會在結束後沿用
+    motorSetTarget(200, 100);
+    motorCalibrateCancel();
+    CHECK_FALSE(motorCalibrating());
+    CHECK(targetsZero());
+
+    motorCalibrateStart(MOTOR_T);
+    runTicks(100);
+    motorSetTarget(200, 100);
+    MotorConfigResult result = MOTOR_CONFIG_INVALID;
+    REQUIRE(motorCalibrateMark(&result));
+    CHECK(result == MOTOR_CONFIG_APPLIED);
+    CHECK(targetsZero());
+    CHECK_FALSE(motorCalibrateMark(&result));
+}
+
+TEST_CASE("校正標記回報 NVS 寫入失敗", "[motor_control]") {
+    motorInit();
+    motorCalibrateStart(MOTOR_S);
+    runTicks(100);
+    fakeHalStoreFailWrites(true);
+    MotorConfigResult result = MOTOR_CONFIG_APPLIED;
+    REQUIRE(motorCalibrateMark(&result));
+    CHECK(result == MOTOR_CONFIG_NOT_SAVED);
+    fakeHalStoreFailWrites(false);
+}
@@ -0,0 +1,376 @@
+#include <catch2/catch.hpp>
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "motor_plant.h"
+#include "motor_control.h"
+#include "ramp_sim.h"
+
+// trace 與 golden 的目錄由 CMake 傳入 (RAMP_SIM_DATA_DIR)
+static std::string dataPath(const char *relative) {
+    return std::string(RAMP_SIM_DATA_DIR "/") + relative;
+}
+
+TEST_CASE("馬達模型: 定電壓下到達反電動勢決定的轉速，堵轉電流受電阻限制", "[ramp_sim]") {
+    MotorPlantState state;
+    motorPlantReset(state);
+    for (int i = 0; i < 20000; i++) motorPlantStep(state, PLANT_DRIVE_130, 1.0, 0.0, 7.4, 50e-6);
+    // 無載轉速略低於 V / Ke (摩擦)，電流只剩摩擦所需
+    double noLoad = 7.4 / PLANT_DRIVE_130.keVsPerRad;
+    CHECK(state.omegaRadS < noLoad);
+    CHECK(state.omegaRadS > noLoad * 0.9);
+    CHECK(state.currentA < 0.3);
+
+    // 轉向: 打到端點後停住，電流為 V / R
+    motorPlantReset(state);
+    for (int i = 0; i < 40000; i++) motorPlantStep(state, PLANT_STEERING_SERVO, 1.0, 0.0, 7.4, 50e-6);
+    CHECK(state.angleRad == PLANT_STEERING_SERVO.travelRad);
+    CHECK(state.omegaRadS == 0);
+    CHECK(state.currentA == Approx(7.4 / PLANT_STEERING_SERVO.resistanceOhm).epsilon(0.01));
+}
+
+TEST_CASE("馬達模型: 快衰減滑行時電流不反向，煞車時停得比滑行快", "[ramp_sim]") {
+    MotorPlantState coast, brake;
+    motorPlantReset(coast);
+    for (int i = 0; i < 20000; i++) motorPlantStep(coast, PLANT_DRIVE_130, 1.0, 0.0, 7.4, 50e-6);
+    brake = coast;
+    for (int i = 0; i < 4000; i++) {
+        motorPlantStep(coast, PLANT_DRIVE_130, 0.0, 0.0, 7.4, 50e-6);
+        motorPlantStep(brake, PLANT_DRIVE_130, 1.0, 1.0, 7.4, 50e-6);
+        REQUIRE(coast.currentA >= 0);
+    }
+    CHECK(brake.omegaRadS < coast.omegaRadS / 2);
+}
+
+TEST_CASE("馬達模型: 電源內阻造成壓降", "[ramp_sim]") {
+    CHECK(supplyVoltage(SUPPLY_2S_LIION, 0) == SUPPLY_2S_LIION.openCircuitV);
+    CHECK(supplyVoltage(SUPPLY_2S_LIION, 3.0) == Approx(SUPPLY_2S_LIION.openCircuitV - 0.6));
+}
+
+// 與 golden 比較: 任何一段都不能比 golden 慢 (容許一個取樣間隔)，overshoot 與峰值電流不能變大；
+// 之後整段波形也必須一致，刻意修改 Ramping 時以 ramp_sim --golden 重新產生
+static void checkAgainstGolden(const char *name) {
+    std::vector<JoystickSample> trace;
+    std::string error;
+    REQUIRE(rampSimLoadTrace(dataPath((std::string("traces/") + name + ".csv").c_str()).c_str(), trace, error));
+    RampSimSeries golden;
+    INFO(error);
+    REQUIRE(rampSimReadSeries(dataPath((std::string("golden/") + name + ".csv").c_str()).c_str(), golden, error));
+
+    RampSimSeries actual;
+    REQUIRE(rampSimRun(trace, NULL, actual));
+    REQUIRE(actual.channels == golden.channels);
+    REQUIRE(actual.samples.size() == golden.samples.size());
+
+    RampSimMetrics expected, measured;
+    rampSimMetrics(trace, golden, expected);
+    rampSimMetrics(trace, actual, measured);
+    REQUIRE(measured.segments.size() == expected.segments.size());
+    for (size_t i = 0; i < expected.segments.size(); i++) {
+        const RampSimSegment &want = expected.segments[i];
+        const RampSimSegment &got = measured.segments[i];
+        INFO(name << " " << golden.names[want.channel] << " @" << want.startMs << " ms: " << want.from
+                  << " -> " << want.to);
+        CHECK(got.timeToSpeedMs <= want.timeToSpeedMs + RAMP_SIM_SAMPLE_MS);
+        CHECK(got.overshootPct <= want.overshootPct + 2.0);
+    }
+    for (int c = 0; c < golden.channels; c++) {
+        INFO(name << " " << golden.names[c]);
+        CHECK(measured.peakCurrentMa[c] <= expected.peakCurrentMa[c] * 1.05 + 20);
+    }
+
+    for (size_t i = 0; i < golden.samples.size(); i++) {
+        const RampSimSample &want = golden.samples[i];
+        const RampSimSample &got = actual.samples[i];
+        for (int c = 0; c < golden.channels; c++) {
+            double scale = golden.names[c].compare(0, 4, "rpm_") == 0 ? 200.0 : 2.0;
+            if (abs(got.output[c] - want.output[c]) > 1 || fabs(got.value[c] - want.value[c]) > scale ||
+                fabs(got.currentMa[c] - want.currentMa[c]) > 50) {
+                FAIL(name << " " << golden.names[c] << " 在 " << want.ms << " ms 與 golden 不同: out "
+                          << got.output[c] << "/" << want.output[c] << ", " << got.value[c] << "/"
+                          << want.value[c] << ", " << got.currentMa[c] << "/" << want.currentMa[c] << " mA");
+            }
+        }
+    }
+}
+
+TEST_CASE("golden trace: 起步與停止", "[ramp_sim]") {
+    checkAgainstGolden("launch_stop");
+}
+
+TEST_CASE("golden trace: 定速左右轉向", "[ramp_sim]") {
+    checkAgainstGolden("slalom");
+}
+
+TEST_CASE("golden trace: 全油門左右轉向", "[ramp_sim]") {
+    checkAgainstGolden("slalom_fast");
+}
+
+TEST_CASE("golden trace: 手指拖曳與反向", "[ramp_sim]") {
+    checkAgainstGolden("finger_drag");
+}
+
+TEST_CASE("同一行程中重複執行的結果相同 (motorInit 清除 Ramping 狀態)", "[ramp_sim]") {
+    std::vector<JoystickSample> trace;
+    std::string error;
+    REQUIRE(rampSimLoadTrace(dataPath("traces/finger_drag.csv").c_str(), trace, error));
+    RampSimSeries first, second;
+    REQUIRE(rampSimRun(trace, NULL, first));
+    REQUIRE(rampSimRun(trace, NULL, second));
+    REQUIRE(first.samples.size() == second.samples.size());
+    for (size_t i = 0; i < first.samples.size(); i++) {
+        for (int c = 0; c < first.channels; c++) {
+            INFO(first.samples[i].ms << " ms " << first.names[c]);
+            REQUIRE(first.samples[i].output[c] == second.samples[i].output[c]);
+            REQUIRE(first.samples[i].value[c] == second.samples[i].value[c]);
+        }
+    }
+}
+
+TEST_CASE("Ramping 步長變小時 time-to-speed 變長 (比較方式本身有效)", "[ramp_sim]") {
+    std::vector<JoystickSample> trace;
+    std::string error;
+    REQUIRE(rampSimLoadTrace(dataPath("traces/launch_stop.csv").c_str(), trace, error));
+    RampSimSeries normal, slow;
+    REQUIRE(rampSimRun(trace, NULL, normal));
+    REQUIRE(rampSimRun(trace, "{\"step_t\":2}", slow));
+    RampSimMetrics a, b;
+    rampSimMetrics(trace, normal, a);
+    rampSimMetrics(trace, slow, b);
+    // 第一段為靜止起步到全油門
+    REQUIRE(!a.segments.empty());
+    REQUIRE(!b.segments.empty());
+    REQUIRE(a.segments[0].startMs == b.segments[0].startMs);
+    CHECK(b.segments[0].timeToSpeedMs > a.segments[0].timeToSpeedMs + RAMP_SIM_SAMPLE_MS);
+
+    // 無效的設定回傳 false
+    CHECK_FALSE(rampSimRun(trace, "{\"step_t\":", slow));
+}
+
+TEST_CASE("轉向排程: 全油門時限制轉向輸出，仍可打到端點", "[ramp_sim]") {
+    std::vector<JoystickSample> trace;
+    std::string error;
+    REQUIRE(rampSimLoadTrace(dataPath("traces/slalom_fast.csv").c_str(), trace, error));
+    RampSimSeries scheduled, flat;
+    REQUIRE(rampSimRun(trace, NULL, scheduled));
+    REQUIRE(rampSimRun(trace, "{\"steering\":\"0:256:256\"}", flat));
+    REQUIRE(scheduled.names[1] == "pos_S");
+
+    // 轉舵期間 (1000..3000 ms) 的 S 輸出、到達 90% 行程的時間與電源電壓
+    int peakScheduled = 0, peakFlat = 0;
+    double travelScheduled = 0, travelFlat = 0;
+    for (size_t i = 0; i < scheduled.samples.size(); i++) {
+        const RampSimSample &a = scheduled.samples[i];
+        const RampSimSample &b = flat.samples[i];
+        if (a.ms < 1000 || a.ms >= 3000) continue;
+        peakScheduled = std::max(peakScheduled, abs(a.output[1]));
+        peakFlat = std::max(peakFlat, abs(b.output[1]));
+        travelScheduled = std::max(travelScheduled, fabs(a.value[1]));
+        travelFlat = std::max(travelFlat, fabs(b.value[1]));
+    }
+    RampSimMetrics a, b;
+    rampSimMetrics(trace, scheduled, a);
+    rampSimMetrics(trace, flat, b);
+    INFO("scheduled S " << peakScheduled << " duty, " << a.peakCurrentMa[1] << " mA, " << a.minSupplyV
+         << " V; flat S " << peakFlat << " duty, " << b.peakCurrentMa[1] << " mA, " << b.minSupplyV << " V");
+
+    // T 輸出 200 (預設上限) 時表格縮放為 150/256: 60 + (250 - 60) × 150 / 256 = 171
+    CHECK(peakScheduled == 171);
+    CHECK(peakFlat == 250);
+    CHECK(travelScheduled == Approx(100));
+    CHECK(travelFlat == Approx(100));
+    CHECK(a.peakCurrentMa[1] < b.peakCurrentMa[1]);
+    CHECK(a.minSupplyV > b.minSupplyV);
+}
+
+// 放開油門後到停止的時間 (轉速低於 100 rpm) 與滑行的馬達軸圈數
+static void stoppingAfter(const RampSimSeries &series, unsigned long releaseMs, unsigned long &timeMs,
+                          double &revolutions) {
+    timeMs = 0;
+    revolutions = 0;
+    for (size_t i = 0; i < series.samples.size(); i++) {
+        const RampSimSample &sample = series.samples[i];
+        if (sample.ms < releaseMs) continue;
+        if (fabs(sample.value[0]) < 100) {
+            timeMs = sample.ms - releaseMs;
+            return;
+        }
+        revolutions += fabs(sample.value[0]) / 60 * RAMP_SIM_SAMPLE_MS / 1000;
+    }
+    timeMs = series.samples.back().ms - releaseMs;
+}
+
+TEST_CASE("停止方式: 經過 Ramping 放開油門時，煞車的停止時間與距離都比滑行短", "[ramp_sim]") {
+    std::vector<JoystickSample> trace;
+    std::string error;
+    REQUIRE(rampSimLoadTrace(dataPath("traces/launch_stop.csv").c_str(), trace, error));
+    RampSimSeries brake, coast;
+    REQUIRE(rampSimRun(trace, "{\"stop_t\":1}", brake));
+    REQUIRE(rampSimRun(trace, "{\"stop_t\":0}", coast));
+    REQUIRE(brake.names[0] == "rpm_T");
+
+    // launch_stop: 1500 ms 放開全油門
+    unsigned long brakeMs, coastMs;
+    double brakeRev, coastRev;
+    stoppingAfter(brake, 1500, brakeMs, brakeRev);
+    stoppingAfter(coast, 1500, coastMs, coastRev);
+    INFO("brake " << brakeMs << " ms / " << brakeRev << " rev, coast " << coastMs << " ms / " << coastRev << " rev");
+    CHECK(brakeMs * 2 < coastMs);
+    CHECK(brakeRev * 2 < coastRev);
+    // 放開前兩者相同 (停止方式只在輸出為 0 時作用)
+    CHECK(brake.samples[140].value[0] == Approx(coast.samples[140].value[0]));
+}
+
+// --- 速度迴路: 編碼器裝在 T 馬達軸上 (每轉 12 個脈衝) ---
+// 慢衰減下模型的無載轉速約與 duty 成正比 (limit 200 時約 12600 rpm = 2520 脈衝/秒)，
+// 速度迴路把 minDuty..limit 對應到 0..speed_full，積分修正兩者的差異
+const int ENCODER_PPR = 12;
+static const char *const SPEED_LOOP_CONFIG = "{\"drive_t\":1,\"speed_full\":2520}";
+
+// 設定值 duty 對應的轉速 (rpm)，minDuty 50、limit 200
+static double setpointRpm(int duty) {
+    return (duty - 50) * 2520.0 / 150 * 60 / ENCODER_PPR;
+}
+
+// ms 時刻的取樣
+static const RampSimSample &sampleAt(const RampSimSeries &series, unsigned long ms) {
+    return series.samples[ms / RAMP_SIM_SAMPLE_MS];
+}
+
+static void runSpeedLoop(const std::vector<JoystickSample> &trace, int ppr, unsigned long stallFromMs,
+                         unsigned long stallToMs, RampSimSeries &series) {
+    RampSimOptions options = {};
+    options.configJson = SPEED_LOOP_CONFIG;
+    options.encoderPulsesPerRev = ppr;
+    options.stallFromMs = stallFromMs;
+    options.stallToMs = stallToMs;
+    REQUIRE(rampSimRun(trace, options, series));
+}
+
+TEST_CASE("速度迴路: 步階響應收斂到設定的轉速，開迴路則不會", "[ramp_sim]") {
+    std::vector<JoystickSample> trace = { { 0, 0, 0 }, { 200, 128, 0 }, { 4000, 128, 0 } };
+    RampSimSeries open, closed;
+    runSpeedLoop(trace, 0, 0, 0, open);
+    runSpeedLoop(trace, ENCODER_PPR, 0, 0, closed);
+
+    // 開迴路的輸出即為 Ramping 後的 duty (速度迴路的設定值)
+    int duty = sampleAt(open, 4000).output[0];
+    REQUIRE(duty == 118);
+    double target = setpointRpm(duty);
+    INFO("target " << target << " rpm, open " << sampleAt(open, 4000).value[0] << ", closed "
+         << sampleAt(closed, 4000).value[0]);
+    CHECK(sampleAt(open, 4000).value[0] > target * 1.2);
+    CHECK(sampleAt(closed, 2500).value[0] == Approx(target).epsilon(0.03));
+    CHECK(sampleAt(closed, 4000).value[0] == Approx(target).epsilon(0.03));
+    // 修正量在 trimLimit (60) 之內
+    CHECK(sampleAt(closed, 4000).output[0] >= duty - 60);
+    CHECK(motorWheelSpeed() == Approx(target * ENCODER_PPR / 60).epsilon(0.03));
+}
+
+TEST_CASE("速度迴路: 卡住 1 秒後放開不會超速 (積分不在堵轉時累積)", "[ramp_sim]") {
+    std::vector<JoystickSample> trace = { { 0, 0, 0 }, { 200, 128, 0 }, { 5000, 128, 0 } };
+    RampSimSeries series;
+    runSpeedLoop(trace, ENCODER_PPR, 3000, 4000, series);
+    double steady = sampleAt(series, 3000).value[0];
+    REQUIRE(steady == Approx(setpointRpm(118)).epsilon(0.03));
+
+    // 卡住期間輪子不動，輸出為前饋加比例項，沒有一路加到上限
+    int stalledOutput = sampleAt(series, 3990).output[0];
+    CHECK(sampleAt(series, 3990).value[0] == 0);
+    CHECK(stalledOutput > 118);
+    CHECK(stalledOutput < 200);
+
+    // 放開後: 不超過穩態轉速 5%，300 ms 內回到 3% 以內
+    double peak = 0;
+    for (unsigned long ms = 4000; ms <= 5000; ms += RAMP_SIM_SAMPLE_MS) peak = std::max(peak, sampleAt(series, ms).value[0]);
+    INFO("steady " << steady << " rpm, peak after release " << peak << " rpm");
+    CHECK(peak < steady * 1.05);
+    CHECK(sampleAt(series, 4300).value[0] == Approx(steady).epsilon(0.03));
+}
+
+TEST_CASE("速度迴路: 反向時輸出跟隨命令方向，收斂到相同的轉速大小", "[ramp_sim]") {
+    std::vector<JoystickSample> trace = { { 0, 0, 0 }, { 200, 128, 0 }, { 3000, -128, 0 }, { 6000, -128, 0 } };
+    RampSimSeries series;
+    runSpeedLoop(trace, ENCODER_PPR, 0, 0, series);
+    double forward = sampleAt(series, 3000).value[0];
+    double reverse = sampleAt(series, 6000).value[0];
+    INFO("forward " << forward << " rpm, reverse " << reverse << " rpm");
+    CHECK(forward == Approx(setpointRpm(118)).epsilon(0.03));
+    CHECK(reverse == Approx(-setpointRpm(118)).epsilon(0.03));
+    // Ramping 在約 3240 ms 越過 0 (118 / 5 個 tick)，之後輸出不再是正值
+    // (單相編碼器量不到方向，輪子仍在正轉時速度迴路也依命令的方向輸出)
+    for (unsigned long ms = 3250; ms <= 6000; ms += RAMP_SIM_SAMPLE_MS) {
+        INFO(ms << " ms");
+        REQUIRE(sampleAt(series, ms).output[0] <= 0);
+    }
+}
+
+TEST_CASE("端點偵測: 全油門時轉向排程縮小的 S 輸出打到端點仍會進入 holding", "[ramp_sim]") {
+    // 全油門並把轉向打到底保持 2 秒
+    std::vector<JoystickSample> trace = { { 0, 0, 0 }, { 200, 255, 0 }, { 1000, 255, 255 }, { 3000, 255, 255 } };
+    RampSimSeries scheduled, idle;
+    REQUIRE(rampSimRun(trace, NULL, scheduled));
+    trace = { { 0, 0, 0 }, { 1000, 0, 255 }, { 3000, 0, 255 } };
+    REQUIRE(rampSimRun(trace, NULL, idle));
+
+    // T 輸出 200 時 S 只到 171 (< limit 250 的接近上限 219)，偵測改以排程後的上限判斷
+    const RampSimSample &saturated = sampleAt(scheduled, 1300);
+    const RampSimSample &held = sampleAt(scheduled, 2900);
+    INFO("S " << saturated.output[1] << " duty / " << saturated.currentMa[1] << " mA → "
+         << held.output[1] << " duty / " << held.currentMa[1] << " mA");
+    CHECK(saturated.output[1] == 171);
+    CHECK(held.output[1] == 90);
+    CHECK(held.currentMa[1] < saturated.currentMa[1] * 0.7);
+    // holding duty 仍把轉向壓在端點附近
+    CHECK(held.value[1] > 90);
+
+    // 低速時 (沒有排程縮放) 一樣進入 holding
+    CHECK(sampleAt(idle, 1300).output[1] == 250);
+    CHECK(sampleAt(idle, 2900).output[1] == 90);
+}
+
+// --- 航向保持: 陀螺儀回饋車輛的偏航，直行時有左右輪阻力差造成的偏航干擾 ---
+static void runHeadingHold(int throttle, double disturbanceDps, bool gyro, RampSimSeries &series) {
+    // 開機校正需要靜止 1 秒
+    std::vector<JoystickSample> trace = { { 0, 0, 0 }, { 1500, throttle, 0 }, { 8000, throttle, 0 } };
+    RampSimOptions options = {};
+    options.gyro = gyro;
+    options.yawDisturbanceDps = disturbanceDps;
+    REQUIRE(rampSimRun(trace, options, series));
+}
+
+TEST_CASE("航向保持: 對抗偏航干擾維持航向，小的修正量也推得動轉向", "[ramp_sim]") {
+    const double disturbances[] = { 10, -15 };
+    const int throttles[] = { 200, 80, -150 };
+    for (double disturbance : disturbances) {
+        for (int throttle : throttles) {
+            RampSimSeries open, held;
+            runHeadingHold(throttle, disturbance, false, open);
+            runHeadingHold(throttle, disturbance, true, held);
+            CHECK(motorHeadingHold().engagements == 1);
+
+            // 鎖定後 (3500 ms 起) 的航向誤差與轉向輸出
+            double worst = 0, sum = 0;
+            int samples = 0, weakest = 255;
+            for (const RampSimSample &sample : held.samples) {
+                if (sample.ms < 3500) continue;
+                worst = std::max(worst, fabs(sample.headingDeg));
+                sum += sample.headingDeg;
+                samples++;
+                if (sample.output[1] != 0) weakest = std::min(weakest, abs(sample.output[1]));
+            }
+            INFO("T " << throttle << ", 干擾 " << disturbance << " °/s: 開迴路 " << open.samples.back().headingDeg
+                 << "°，航向保持最大 " << worst << "°，平均 " << sum / samples << "°，最小轉向 duty " << weakest);
+            CHECK(fabs(open.samples.back().headingDeg) > 30);
+            CHECK(worst < 4);
+            CHECK(fabs(sum / samples) < 2);
+            // 修正量與搖桿命令一樣由 minDuty (60) 起跳
+            CHECK(weakest >= 60);
+        }
+    }
+
+    // 沒有干擾時不介入
+    RampSimSeries straight;
+    runHeadingHold(200, 0, true, straight);
+    for (const RampSimSample &sample : straight.samples) REQUIRE(sample.output[1] == 0);
+}
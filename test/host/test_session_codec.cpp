@@ -0,0 +1,105 @@
+// --- 駕駛紀錄的編碼格式 ---
+#include <stdlib.h>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "session_codec.h"
+
+TEST_CASE("session 標頭往返並拒絕錯誤的標頭", "[session_codec]") {
+    uint8_t header[SESSION_HEADER_LEN];
+    REQUIRE(sessionWriteHeader(header, 3) == SESSION_HEADER_LEN);
+    int channels = 0;
+    REQUIRE(sessionReadHeader(header, sizeof(header), channels));
+    CHECK(channels == 3);
+
+    CHECK_FALSE(sessionReadHeader(header, SESSION_HEADER_LEN - 1, channels));
+    header[3] = SESSION_MAX_CHANNELS + 1;
+    CHECK_FALSE(sessionReadHeader(header, sizeof(header), channels));
+    header[3] = 2;
+    header[2] = SESSION_FORMAT_VERSION + 1;
+    CHECK_FALSE(sessionReadHeader(header, sizeof(header), channels));
+    // 擦除後的 flash
+    uint8_t erased[SESSION_HEADER_LEN] = { 0xFF, 0xFF, 0xFF, 0xFF };
+    CHECK_FALSE(sessionReadHeader(erased, sizeof(erased), channels));
+}
+
+TEST_CASE("sessionChanged 只在目標改變時為 true", "[session_codec]") {
+    SessionEncoder encoder;
+    sessionEncoderInit(encoder, 2, 0);
+    int zero[2] = { 0, 0 };
+    int moved[2] = { 0, 40 };
+    CHECK_FALSE(sessionChanged(encoder, zero));
+    CHECK(sessionChanged(encoder, moved));
+}
+
+TEST_CASE("隨機紀錄編碼後可精確解回", "[session_codec]") {
+    srand(7);
+    const int channels = 3;
+    SessionEncoder encoder;
+    sessionEncoderInit(encoder, channels, 5000);
+    std::vector<uint8_t> stream;
+    std::vector<std::vector<int> > expected;
+    std::vector<unsigned long> stamps;
+    unsigned long now = 5000;
+    for (int r = 0; r < 2000; r++) {
+        now += (unsigned long)(rand() % 600);
+        std::vector<int> targets(channels);
+        for (int c = 0; c < channels; c++) targets[c] = rand() % 511 - 255;
+        uint8_t buf[SESSION_RECORD_MAX];
+        size_t n = sessionEncode(encoder, now, targets.data(), buf);
+        REQUIRE(n <= SESSION_RECORD_MAX);
+        REQUIRE(buf[0] != SESSION_END);
+        stream.insert(stream.end(), buf, buf + n);
+        expected.push_back(targets);
+        stamps.push_back(now - 5000);
+    }
+    stream.push_back(SESSION_END);
+
+    SessionDecoder decoder;
+    sessionDecoderInit(decoder, channels);
+    size_t pos = 0;
+    for (size_t r = 0; r < expected.size(); r++) {
+        size_t used = sessionDecode(decoder, stream.data() + pos, stream.size() - pos);
+        REQUIRE(used > 0);
+        pos += used;
+        for (int c = 0; c < channels; c++) REQUIRE(decoder.targets[c] == expected[r][c]);
+        // 避開 0xFF 時最多少記 1ms，且不會累積
+        REQUIRE(stamps[r] - decoder.stampMs <= 1);
+    }
+    CHECK(sessionDecode(decoder, stream.data() + pos, stream.size() - pos) == 0);
+}
+
+TEST_CASE("第一個位元組會是 0xFF 的 dt 少記 1ms 並由下一筆吸收", "[session_codec]") {
+    SessionEncoder encoder;
+    sessionEncoderInit(encoder, 1, 0);
+    int target = 10;
+    uint8_t buf[SESSION_RECORD_MAX];
+    size_t n = sessionEncode(encoder, 255, &target, buf);
+    CHECK(buf[0] != SESSION_END);
+
+    SessionDecoder decoder;
+    sessionDecoderInit(decoder, 1);
+    REQUIRE(sessionDecode(decoder, buf, n) == n);
+    CHECK(decoder.stampMs == 254);
+
+    target = 20;
+    n = sessionEncode(encoder, 300, &target, buf);
+    REQUIRE(sessionDecode(decoder, buf, n) == n);
+    CHECK(decoder.stampMs == 300);
+}
+
+TEST_CASE("sessionDecode 資料不足時不改變 decoder", "[session_codec]") {
+    SessionEncoder encoder;
+    sessionEncoderInit(encoder, 2, 0);
+    int targets[2] = { 200, -200 };
+    uint8_t buf[SESSION_RECORD_MAX];
+    size_t n = sessionEncode(encoder, 1000, targets, buf);
+
+    SessionDecoder decoder;
+    sessionDecoderInit(decoder, 2);
+    for (size_t len = 0; len < n; len++) {
+        CHECK(sessionDecode(decoder, buf, len) == 0);
+        CHECK(decoder.targets[0] == 0);
+        CHECK(decoder.stampMs == 0);
+    }
+    CHECK(sessionDecode(decoder, buf, n) == n);
+}
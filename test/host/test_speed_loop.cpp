@@ -0,0 +1,82 @@
+// --- T 馬達閉迴路速度控制 (定點 PID) ---
+#include <catch2/catch.hpp>
+#include "speed_loop.h"
+
+// 預設增益，滿速 1500 脈衝/秒: minDuty 50、limit 200 時每 10 脈衝/秒對應 1 duty
+static const SpeedLoopConfig CONFIG = { 20, 128, 16, 0, 60, 1500 };
+const int MIN_DUTY = 50;
+const int LIMIT = 200;
+
+// command 對應的輪速 (脈衝/秒) 加上 offset duty 的誤差
+static uint32_t speedFor(int duty) {
+    return (uint32_t)((duty - MIN_DUTY) * CONFIG.fullSpeed / (LIMIT - MIN_DUTY));
+}
+
+TEST_CASE("速度迴路: 命令為 0 時輸出 0 並重設", "[speed_loop]") {
+    SpeedLoopState state;
+    speedLoopReset(state);
+    for (int i = 0; i < 10; i++) speedLoopStep(state, CONFIG, 120, speedFor(110), MIN_DUTY, LIMIT);
+    REQUIRE(state.integral != 0);
+    CHECK(speedLoopStep(state, CONFIG, 0, speedFor(110), MIN_DUTY, LIMIT) == 0);
+    CHECK(state.integral == 0);
+    CHECK(state.direction == 0);
+}
+
+TEST_CASE("速度迴路: 量測值等於設定值時輸出即為前饋", "[speed_loop]") {
+    SpeedLoopState state;
+    speedLoopReset(state);
+    for (int i = 0; i < 50; i++) CHECK(speedLoopStep(state, CONFIG, 120, speedFor(120), MIN_DUTY, LIMIT) == 120);
+    CHECK(speedLoopStep(state, CONFIG, -120, speedFor(120), MIN_DUTY, LIMIT) == -120);
+}
+
+TEST_CASE("速度迴路: 穩態的小誤差由積分修正，修正量不超過 trimLimit", "[speed_loop]") {
+    SpeedLoopState state;
+    speedLoopReset(state);
+    // 輪速一直低 20 duty (例如上坡): 比例項 +10，積分逐步加上去
+    int first = speedLoopStep(state, CONFIG, 120, speedFor(100), MIN_DUTY, LIMIT);
+    CHECK(first == 120 + 128 * 20 / SPEED_GAIN_ONE + 16 * 20 / SPEED_GAIN_ONE);
+    int output = first;
+    for (int i = 0; i < 500; i++) output = speedLoopStep(state, CONFIG, 120, speedFor(100), MIN_DUTY, LIMIT);
+    CHECK(output > first);
+    CHECK(output == 120 + 128 * 20 / SPEED_GAIN_ONE + CONFIG.trimLimit);
+}
+
+TEST_CASE("速度迴路: 卡住時 (大誤差) 不累加積分，放開後不會超速", "[speed_loop]") {
+    SpeedLoopState state;
+    speedLoopReset(state);
+    // 輪子不動: 誤差 = 120，只有前饋與比例項
+    int output = 0;
+    for (int i = 0; i < 100; i++) output = speedLoopStep(state, CONFIG, 120, 0, MIN_DUTY, LIMIT);
+    CHECK(state.integral == 0);
+    CHECK(output == 120 + 128 * 120 / SPEED_GAIN_ONE);
+
+    // 放開後輪速回到設定值，輸出立即回到前饋
+    CHECK(speedLoopStep(state, CONFIG, 120, speedFor(120), MIN_DUTY, LIMIT) == 120);
+}
+
+TEST_CASE("速度迴路: 輸出飽和時不累加會讓飽和更嚴重的誤差", "[speed_loop]") {
+    SpeedLoopState state;
+    speedLoopReset(state);
+    // 設定值接近上限，輪速低 20 duty: 輸出被限制在 limit
+    int output = 0;
+    for (int i = 0; i < 100; i++) output = speedLoopStep(state, CONFIG, 190, speedFor(170), MIN_DUTY, LIMIT);
+    CHECK(output == LIMIT);
+    int32_t saturated = state.integral;
+    for (int i = 0; i < 100; i++) speedLoopStep(state, CONFIG, 190, speedFor(170), MIN_DUTY, LIMIT);
+    CHECK(state.integral == saturated);
+    CHECK(state.integral * CONFIG.ki / SPEED_GAIN_ONE <= LIMIT - 190);
+}
+
+TEST_CASE("速度迴路: 方向反轉時重設積分，輸出跟隨命令的方向", "[speed_loop]") {
+    SpeedLoopState state;
+    speedLoopReset(state);
+    for (int i = 0; i < 50; i++) speedLoopStep(state, CONFIG, 120, speedFor(100), MIN_DUTY, LIMIT);
+    REQUIRE(state.integral > 0);
+
+    // 單相編碼器只量大小: 反轉瞬間輪子仍以原方向轉動，量到的是同一個速度
+    int output = speedLoopStep(state, CONFIG, -120, speedFor(100), MIN_DUTY, LIMIT);
+    CHECK(state.direction == -1);
+    CHECK(output < 0);
+    CHECK(state.integral == 20);
+    CHECK(output == -(120 + 128 * 20 / SPEED_GAIN_ONE + 16 * 20 / SPEED_GAIN_ONE));
+}
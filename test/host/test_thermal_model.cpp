@@ -0,0 +1,214 @@
+// --- 馬達與驅動器的集總熱模型 (預測式降額) ---
+#include <catch2/catch.hpp>
+#include <math.h>
+#include "thermal_model.h"
+
+// 以固定電流與 tick 長度推進 durationMs
+static void run(ThermalNode &node, const ThermalParams &params, int currentMa,
+                unsigned long durationMs, unsigned long tickMs = 10) {
+    int32_t powerMw = thermalPowerMw(currentMa, params.resistanceMohm);
+    for (unsigned long t = 0; t < durationMs; t += tickMs) {
+        thermalNodeUpdate(node, params, powerMw, tickMs);
+    }
+}
+
+static double riseC(const ThermalNode &node) {
+    return node.riseQ16 / 65536.0;
+}
+
+TEST_CASE("發熱功率為 I²R", "[thermal]") {
+    CHECK(thermalPowerMw(0, 2000) == 0);
+    CHECK(thermalPowerMw(1000, 2000) == 2000);
+    CHECK(thermalPowerMw(-1000, 2000) == 2000);
+    CHECK(thermalPowerMw(3000, 360) == 3240);
+    // 異常的電流讀值也不溢位
+    CHECK(thermalPowerMw(100000, 2000) == 20000000);
+}
+
+TEST_CASE("已知電流下的升溫與冷卻符合一階模型", "[thermal]") {
+    const ThermalParams &p = THERMAL_MOTOR_DEFAULT;
+    ThermalNode node;
+    thermalNodeReset(node);
+    REQUIRE(thermalNodeTempC(node) == THERMAL_AMBIENT_C);
+
+    // 1000 mA → 2 W → 穩態溫升 40°C (低於降額起點)
+    const double steady = 40.0;
+    run(node, p, 1000, p.tauMs);
+    CHECK(node.steadyQ16 == (40 << 16));
+    CHECK(riseC(node) == Approx(steady * (1 - exp(-1.0))).margin(0.5));
+    run(node, p, 1000, 4 * p.tauMs);
+    CHECK(riseC(node) == Approx(steady * (1 - exp(-5.0))).margin(0.5));
+    CHECK(node.derate == THERMAL_SCALE_ONE);
+
+    // 斷電後以相同的時間常數冷卻
+    double start = riseC(node);
+    run(node, p, 0, p.tauMs);
+    CHECK(riseC(node) == Approx(start * exp(-1.0)).margin(0.5));
+    run(node, p, 0, 10 * p.tauMs);
+    CHECK(thermalNodeTempC(node) == THERMAL_AMBIENT_C);
+    CHECK(node.riseQ16 >= 0);
+}
+
+TEST_CASE("tick 長度不影響結果，任務延遲時單次積分有上限", "[thermal]") {
+    const ThermalParams &p = THERMAL_MOTOR_DEFAULT;
+    ThermalNode fine, coarse, stalled;
+    thermalNodeReset(fine);
+    thermalNodeReset(coarse);
+    thermalNodeReset(stalled);
+    run(fine, p, 1000, 30000, 5);
+    run(coarse, p, 1000, 30000, 50);
+    CHECK(riseC(fine) == Approx(riseC(coarse)).margin(0.5));
+
+    // 一次 10 秒的 tick 只積分 100 ms
+    ThermalNode once;
+    thermalNodeReset(once);
+    thermalNodeUpdate(once, p, thermalPowerMw(1000, p.resistanceMohm), 10000);
+    run(stalled, p, 1000, 100, 100);
+    CHECK(once.riseQ16 == stalled.riseQ16);
+}
+
+TEST_CASE("降額: 預測提早開始，在 derateStart..cutoff 之間線性降到 0", "[thermal]") {
+    const ThermalParams &p = THERMAL_MOTOR_DEFAULT;
+    ThermalNode node;
+    thermalNodeReset(node);
+
+    // 2000 mA → 8 W → 穩態溫升 160°C，遠高於關斷溫度
+    const int32_t powerMw = thermalPowerMw(2000, p.resistanceMohm);
+    int onsetTemp = 0;
+    int previous = THERMAL_SCALE_ONE;
+    int cutoffTemp = 0;
+    for (int i = 0; i < 60000 && cutoffTemp == 0; i++) {
+        int derate = thermalNodeUpdate(node, p, powerMw, 10);
+        if (onsetTemp == 0 && derate < THERMAL_SCALE_ONE) onsetTemp = thermalNodeTempC(node);
+        // 持續升溫時只會收緊
+        REQUIRE(derate <= previous);
+        previous = derate;
+        if (derate == 0) cutoffTemp = thermalNodeTempC(node);
+    }
+    // 目前溫度還沒到 derateStart 就因預測值開始降額，預測值也讓上限在 cutoff 前降到 0
+    REQUIRE(onsetTemp > 0);
+    CHECK(onsetTemp < p.derateStartC);
+    CHECK(onsetTemp > THERMAL_AMBIENT_C + 40);
+    REQUIRE(cutoffTemp > 0);
+    CHECK(cutoffTemp < p.cutoffC);
+    CHECK(cutoffTemp > p.derateStartC);
+
+    // 溫度穩定時 (沒有預測項) 降額與溫度成線性
+    ThermalNode flat;
+    thermalNodeReset(flat);
+    const int32_t mid = (p.derateStartC + p.cutoffC) / 2 - THERMAL_AMBIENT_C;
+    flat.riseQ16 = mid << 16;
+    // 穩態溫升 = 目前溫升: P = rise / Rth
+    thermalNodeUpdate(flat, p, mid * 1000 / p.rthCPerW, 10);
+    CHECK(flat.derate == Approx(THERMAL_SCALE_ONE / 2).margin(2));
+}
+
+TEST_CASE("放寬上限有遲滯: 溫度回落 THERMAL_RELEASE_HYSTERESIS_C 後才放寬", "[thermal]") {
+    const ThermalParams &p = THERMAL_MOTOR_DEFAULT;
+    ThermalNode node;
+    thermalNodeReset(node);
+
+    // 以剛好維持溫度的功率停在降額區中段 (預測值等於目前溫度)
+    const int32_t mid = (p.derateStartC + p.cutoffC) / 2 - THERMAL_AMBIENT_C;
+    node.riseQ16 = mid << 16;
+    thermalNodeUpdate(node, p, mid * 1000 / p.rthCPerW, 10);
+    const int held = node.derate;
+    REQUIRE(held < THERMAL_SCALE_ONE);
+    const int heldTemp = thermalNodeTempC(node);
+
+    // 斷電: 溫度開始下降，但在回落遲滯範圍之前上限不動
+    const int32_t releaseQ16 = node.riseQ16 - (THERMAL_RELEASE_HYSTERESIS_C << 16);
+    int firstRelease = 0;
+    int previous = held;
+    for (int i = 0; i < 600000; i++) {
+        int derate = thermalNodeUpdate(node, p, 0, 10);
+        // 冷卻時只會放寬
+        REQUIRE(derate >= previous);
+        previous = derate;
+        if (derate > held && firstRelease == 0) {
+            firstRelease = thermalNodeTempC(node);
+            CHECK(node.riseQ16 <= releaseQ16 + (1 << 16));
+        }
+        if (derate == THERMAL_SCALE_ONE) break;
+    }
+    CHECK(firstRelease > 0);
+    CHECK(firstRelease <= heldTemp - THERMAL_RELEASE_HYSTERESIS_C + 1);
+    // 完全解除需要低於 derateStart - 遲滯
+    CHECK(node.derate == THERMAL_SCALE_ONE);
+    CHECK(thermalNodeTempC(node) <= p.derateStartC - THERMAL_RELEASE_HYSTERESIS_C);
+
+    // 遲滯範圍內的小幅溫度變化不會讓上限來回跳動
+    ThermalNode edge;
+    thermalNodeReset(edge);
+    edge.riseQ16 = (p.derateStartC + 1 - THERMAL_AMBIENT_C) << 16;
+    thermalNodeUpdate(edge, p, (p.derateStartC + 1 - THERMAL_AMBIENT_C) * 1000 / p.rthCPerW, 10);
+    const int limited = edge.derate;
+    REQUIRE(limited < THERMAL_SCALE_ONE);
+    for (int i = 0; i < 200; i++) {
+        // 在剛好穩態與稍微冷卻之間交替
+        int32_t hold = (int32_t)((int64_t)edge.riseQ16 * 1000 / p.rthCPerW >> 16);
+        thermalNodeUpdate(edge, p, (i & 1) ? hold : 0, 10);
+        REQUIRE(edge.derate <= limited);
+    }
+}
+
+TEST_CASE("長時間運轉不溢位", "[thermal]") {
+    ThermalParams params[] = { THERMAL_MOTOR_DEFAULT, THERMAL_DRIVER_DEFAULT };
+    for (const ThermalParams &p : params) {
+        ThermalNode node;
+        thermalNodeReset(node);
+
+        // 10 小時堵轉電流 (每 tick 100 ms)：溫升收斂到穩態且不超過
+        const int32_t powerMw = thermalPowerMw(3000, p.resistanceMohm);
+        const int32_t steadyQ16 = (int32_t)((int64_t)powerMw * p.rthCPerW * 65536 / 1000);
+        int32_t previous = 0;
+        for (long t = 0; t < 10L * 3600 * 1000; t += 100) {
+            thermalNodeUpdate(node, p, powerMw, 100);
+            REQUIRE(node.riseQ16 >= previous);
+            REQUIRE(node.riseQ16 <= steadyQ16);
+            previous = node.riseQ16;
+        }
+        CHECK(riseC(node) == Approx(steadyQ16 / 65536.0).margin(1));
+        CHECK(node.derate == 0);
+
+        // 異常的電流讀值: 穩態溫升有上限，Q16 不回繞成負值
+        for (int i = 0; i < 100000; i++) {
+            thermalNodeUpdate(node, p, thermalPowerMw(100000, p.resistanceMohm), 1000000UL);
+            REQUIRE(node.riseQ16 >= previous);
+            previous = node.riseQ16;
+        }
+        CHECK(node.steadyQ16 == (THERMAL_RISE_MAX_C << 16));
+        CHECK(thermalNodeTempC(node) <= THERMAL_AMBIENT_C + THERMAL_RISE_MAX_C);
+        CHECK(thermalNodeTempC(node) > p.cutoffC);
+
+        // 再冷卻 10 小時回到環境溫度並解除降額
+        for (long t = 0; t < 10L * 3600 * 1000; t += 100) {
+            thermalNodeUpdate(node, p, 0, 100);
+            REQUIRE(node.riseQ16 >= 0);
+        }
+        CHECK(thermalNodeTempC(node) == THERMAL_AMBIENT_C);
+        CHECK(node.derate == THERMAL_SCALE_ONE);
+    }
+}
+
+TEST_CASE("韌體端: 馬達取自身與驅動器中較嚴格的降額，重設後回到環境溫度", "[thermal]") {
+    thermalModelReset();
+    thermalModelTick(0, 0, 10);
+    CHECK(thermalDerate(THERMAL_MOTOR_T) == THERMAL_SCALE_ONE);
+    CHECK(thermalDerate(THERMAL_MOTOR_S) == THERMAL_SCALE_ONE);
+
+    // 只有 S 馬達堵轉: S 降額，T 只受驅動器影響
+    for (int i = 0; i < 60000; i++) thermalModelTick(0, 2500, 10);
+    const ThermalNode &s = thermalModelNode(THERMAL_MOTOR_S);
+    CHECK(s.derate < THERMAL_SCALE_ONE);
+    CHECK(thermalDerate(THERMAL_MOTOR_S) == s.derate);
+    CHECK(thermalModelNode(THERMAL_MOTOR_T).riseQ16 == 0);
+    int driver = thermalModelNode(THERMAL_DRIVER).derate;
+    CHECK(thermalDerate(THERMAL_MOTOR_T) == driver);
+
+    thermalModelReset();
+    for (int i = 0; i < THERMAL_NODE_COUNT; i++) {
+        CHECK(thermalNodeTempC(thermalModelNode((ThermalNodeId)i)) == THERMAL_AMBIENT_C);
+        CHECK(thermalModelNode((ThermalNodeId)i).derate == THERMAL_SCALE_ONE);
+    }
+}
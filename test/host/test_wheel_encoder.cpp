@@ -0,0 +1,74 @@
+// --- 輪速編碼器 (GPIO 中斷計數) ---
+#include <catch2/catch.hpp>
+#include "wheel_encoder.h"
+
+// 每 periodUs 一個脈衝，送出 count 個；回傳最後一個脈衝的時間
+static unsigned long pulses(unsigned long startUs, unsigned long periodUs, int count) {
+    unsigned long t = startUs;
+    for (int i = 0; i < count; i++) {
+        t += periodUs;
+        wheelEncoderEdge(t);
+    }
+    return t;
+}
+
+TEST_CASE("編碼器: pin < 0 時停用", "[wheel_encoder]") {
+    wheelEncoderInit(0, ENCODER_GLITCH_US_DEFAULT);
+    CHECK(wheelEncoderPresent());
+    wheelEncoderInit(-1, ENCODER_GLITCH_US_DEFAULT);
+    CHECK_FALSE(wheelEncoderPresent());
+}
+
+TEST_CASE("編碼器: 固定間隔的脈衝換算成脈衝/秒", "[wheel_encoder]") {
+    wheelEncoderInit(0, ENCODER_GLITCH_US_DEFAULT);
+    CHECK(wheelEncoderSpeed(0) == 0);     // 第一次取樣只記錄起點
+
+    unsigned long t = pulses(0, 1000, 20);
+    CHECK(wheelEncoderSpeed(t + 100) == 0);   // 起點之前沒有脈衝，還無法計算
+    t = pulses(t, 1000, 20);
+    CHECK(wheelEncoderSpeed(t + 100) == 1000);
+    t = pulses(t, 2500, 8);
+    CHECK(wheelEncoderSpeed(t + 100) == 400);
+    CHECK(wheelEncoderGlitchCount() == 0);
+}
+
+TEST_CASE("編碼器: 過濾間隔太短的毛刺，不影響速度", "[wheel_encoder]") {
+    wheelEncoderInit(0, ENCODER_GLITCH_US_DEFAULT);
+    wheelEncoderSpeed(0);
+    unsigned long t = pulses(0, 1000, 20);
+    wheelEncoderSpeed(t);
+    for (int i = 0; i < 20; i++) {
+        t += 1000;
+        wheelEncoderEdge(t);
+        wheelEncoderEdge(t + 30);   // 接點彈跳
+        wheelEncoderEdge(t + 60);
+    }
+    CHECK(wheelEncoderSpeed(t + 100) == 1000);
+    CHECK(wheelEncoderGlitchCount() == 40);
+
+    // 過濾的間隔由前一個有效脈衝起算，間隔剛好等於門檻的脈衝有效
+    wheelEncoderEdge(t + ENCODER_GLITCH_US_DEFAULT);
+    CHECK(wheelEncoderGlitchCount() == 40);
+}
+
+TEST_CASE("編碼器: 沒有脈衝時依經過時間下修，超過堵轉時間歸零", "[wheel_encoder]") {
+    wheelEncoderInit(0, ENCODER_GLITCH_US_DEFAULT);
+    wheelEncoderSpeed(0);
+    unsigned long t = pulses(0, 1000, 20);
+    wheelEncoderSpeed(t);
+    t = pulses(t, 1000, 20);
+    REQUIRE(wheelEncoderSpeed(t) == 1000);
+
+    // 20 ms 沒有脈衝: 速度不可能高於 1 / 20 ms
+    CHECK(wheelEncoderSpeed(t + 20000) == 50);
+    // 之後再等也不會因為時間變長而回升
+    CHECK(wheelEncoderSpeed(t + 40000) == 25);
+    CHECK(wheelEncoderSpeed(t + ENCODER_STALL_US) == 0);
+
+    // 重新轉動後恢復
+    unsigned long restart = t + ENCODER_STALL_US + 1000;
+    wheelEncoderEdge(restart);
+    wheelEncoderSpeed(restart);
+    t = pulses(restart, 500, 40);
+    CHECK(wheelEncoderSpeed(t) == 2000);
+}